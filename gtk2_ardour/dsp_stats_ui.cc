@@ -24,6 +24,7 @@
 #include "ardour/session.h"
 #include "ardour/audioengine.h"
 #include "ardour/audio_backend.h"
+#include "ardour/graph.h"
 
 #include "widgets/tooltips.h"
 
@@ -102,6 +103,7 @@ DspStatisticsGUI::DspStatisticsGUI ()
 
 	pack_start (*frame, false, false);
 	pack_start (table, true, true, 20);
+	pack_start (graph_stats_label, false, false);
 	pack_start (*hbox2, false, false);
 
 	reset_button.signal_clicked().connect (sigc::mem_fun (*this, &DspStatisticsGUI::reset_button_clicked));
@@ -287,6 +289,41 @@ DspStatisticsGUI::update ()
 		labels[AudioEngine::NTT + Session::OverallProcess]->set_text (_("No session loaded"));
 		ArdourWidgets::set_tooltip (labels[AudioEngine::NTT + Session::OverallProcess], "");
 	}
+
+	update_graph_stats ();
+}
+
+void
+DspStatisticsGUI::update_graph_stats ()
+{
+	std::vector<GraphThreadStats> stats;
+
+	if (_session) {
+		_session->process_graph_thread_stats (stats);
+	}
+
+	uint64_t total_busy = 0;
+	for (auto const& s : stats) {
+		total_busy += s.busy_usec;
+	}
+
+	if (stats.empty () || total_busy == 0) {
+		graph_stats_label.set_text ("");
+		return;
+	}
+
+	std::string txt = _("Process threads:");
+	char buf[128];
+
+	for (size_t n = 0; n < stats.size (); ++n) {
+		GraphThreadStats const& s (stats[n]);
+		double const nr = std::max<uint64_t> (1, s.n_run);
+		snprintf (buf, sizeof (buf), "\n#%zu: %5.1f%% DSP, %" PRIu64 " nodes, %3.0f%% local, %3.0f%% stolen",
+		          n, 100.0 * s.busy_usec / total_busy, s.n_run, 100.0 * s.n_local / nr, 100.0 * s.n_stolen / nr);
+		txt += buf;
+	}
+
+	graph_stats_label.set_text (txt);
 }
 
 bool
@@ -39,6 +39,7 @@ protected:
 
 private:
 	void update ();
+	void update_graph_stats ();
 
 	sigc::connection update_connection;
 
@@ -47,6 +48,7 @@ private:
 	Gtk::Label** labels;
 	Gtk::Button reset_button;
 	Gtk::Label info_text;
+	Gtk::Label graph_stats_label;
 
 	void reset_button_clicked();
 
@@ -92,6 +92,8 @@
 #include "canvas/note.h"
 #include "canvas/text.h"
 
+#include "waveview/wave_view.h"
+
 #include "widgets/ardour_spacer.h"
 #include "widgets/eventboxext.h"
 #include "widgets/tooltips.h"
@@ -3969,6 +3971,11 @@ Editor::playhead_cursor_sample () const
 void
 Editor::visual_changer (const VisualChange& vc)
 {
+	/* waveviews that remain visible will renew their pending draw
+	 * requests, those that are no longer visible are dropped.
+	 */
+	ArdourWaveView::WaveView::start_draw_generation ();
+
 	/**
 	 * Changed first so the correct horizontal canvas position is calculated in
 	 * Editor::set_horizontal_position
@@ -5663,6 +5670,8 @@ Editor::ui_parameter_changed (string parameter)
 		update_ruler_visibility ();
 	} else if (parameter == "use-cross-cursor") {
 		maybe_enable_cross_cursor ();
+	} else if (parameter == "cache-static-canvas-layers") {
+		update_canvas_layer_caching ();
 	}
 }
 
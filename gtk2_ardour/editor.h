@@ -2306,6 +2306,7 @@ private:
 	sigc::connection xcursor_connection;
 	void motion_track (ArdourCanvas::Duple const &);
 	void maybe_enable_cross_cursor ();
+	void update_canvas_layer_caching ();
 
 	friend class RegionMoveDrag;
 	friend class TrimDrag;
@@ -295,6 +295,7 @@ Editor::initialize_canvas ()
 	maybe_enable_cross_cursor ();
 
 	initialize_rulers ();
+	update_canvas_layer_caching ();
 
 	UIConfiguration::instance().ColorsChanged.connect (sigc::mem_fun (*this, &Editor::color_handler));
 	UIConfiguration::instance().DPIReset.connect (sigc::mem_fun (*this, &Editor::dpi_reset));
@@ -361,6 +362,18 @@ Editor::maybe_enable_cross_cursor ()
 	}
 }
 
+void
+Editor::update_canvas_layer_caching ()
+{
+	/* rulers and grid lines rarely change, but are re-rendered whenever
+	 * the playhead or a meter on top of them moves.
+	 */
+	bool const yn = UIConfiguration::instance().get_cache_static_canvas_layers ();
+
+	_time_markers_group->set_render_cached (yn);
+	time_line_group->set_render_cached (yn);
+}
+
 void
 Editor::motion_track (ArdourCanvas::Duple const & pos)
 {
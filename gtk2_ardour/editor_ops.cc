@@ -4531,7 +4531,11 @@ Editor::cut_copy_points (Editing::CutCopyOp op, timepos_t const & earliest_time)
 			i->first->freeze ();
 		}
 
-		/* Remove each selected point from its AutomationList */
+		/* Collect the selected points of each AutomationList, and remove
+		 * them all at once. Erasing one changes the position of the others.
+		 */
+		std::map<std::shared_ptr<AutomationList>, Evoral::ControlList::EventList> to_erase;
+
 		for (auto & selected_point : selection->points) {
 			AutomationLine& line (selected_point->line ());
 			std::shared_ptr<AutomationList> al = line.the_list();
@@ -4546,10 +4550,14 @@ Editor::cut_copy_points (Editing::CutCopyOp op, timepos_t const & earliest_time)
 			}
 
 			if(erase) {
-				al->erase (selected_point->model ());
+				to_erase[al].push_back (*selected_point->model ());
 			}
 		}
 
+		for (auto const& e : to_erase) {
+			e.first->erase (e.second);
+		}
+
 		/* Thaw the lists and add undo records for them */
 		for (Lists::iterator i = lists.begin(); i != lists.end(); ++i) {
 			std::shared_ptr<AutomationList> al = i->first;
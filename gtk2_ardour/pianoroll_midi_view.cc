@@ -745,11 +745,17 @@ PianorollMidiView::cut_copy_points (Editing::CutCopyOp op, timepos_t const & ear
 			i->first->freeze ();
 		}
 
-		/* Remove each selected point from its AutomationList */
+		/* Remove the selected points from their AutomationList, all at
+		 * once since erasing one changes the position of the others.
+		 */
+		std::map<std::shared_ptr<AutomationList>, Evoral::ControlList::EventList> to_erase;
+
 		for (auto & selected_point : selection.points) {
-			AutomationLine& line (selected_point->line ());
-			std::shared_ptr<AutomationList> al = line.the_list();
-			al->erase (selected_point->model ());
+			to_erase[selected_point->line ().the_list ()].push_back (*selected_point->model ());
+		}
+
+		for (auto const& e : to_erase) {
+			e.first->erase (e.second);
 		}
 
 		/* Thaw the lists and add undo records for them */
@@ -2534,6 +2534,26 @@ RCOptionEditor::RCOptionEditor ()
 		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_periodic_safety_backups)
 		     ));
 
+	bo = new BoolOption (
+		     "save-binary-state",
+		     _("Save session files in binary format"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_save_binary_state),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_save_binary_state)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			string_compose (_("When enabled, session files and backups are written in a compact binary encoding, which is considerably faster to save and load. Older versions of %1 cannot read these files. Templates and archives are always saved as XML."), PROGRAM_NAME));
+	add_option (_("General"), bo);
+
+	bo = new BoolOption (
+		     "save-incremental-state",
+		     _("Only save changes in safety backups"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_save_incremental_state),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_save_incremental_state)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, periodic safety backups and saves during recording append only the parts of the session that changed to a journal, instead of rewriting the whole session file. The journal is applied when recovering from a crash."));
+	add_option (_("General"), bo);
+
 	add_option (_("General"), new DirectoryOption (
 			    X_("default-session-parent-dir"),
 			    _("Default folder for new sessions:"),
@@ -2584,6 +2604,16 @@ RCOptionEditor::RCOptionEditor ()
 
 	add_option (_("General"), new OptionEditorHeading (_("Export")));
 
+	bo = new BoolOption (
+		     "export-offline",
+		     _("Render exports without the audio backend"),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::get_export_offline),
+		     sigc::mem_fun (*_rc_config, &RCConfiguration::set_export_offline)
+		     );
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+			_("When enabled, non-realtime exports are processed by a dedicated thread as fast as possible, instead of by the (freewheeling) audio backend. This has no effect with JACK."));
+	add_option (_("General"), bo);
+
 	add_option (_("General"),
 	     new BoolOption (
 		     "save-export-analysis-image",
@@ -2964,6 +2994,16 @@ RCOptionEditor::RCOptionEditor ()
 	wfsh->add (Rectified, _("rectified"));
 
 	add_option (_("Appearance/Waveform"), wfsh);
+
+	BoolOption* upl = new BoolOption (
+		"use-peak-levels",
+		_("Use multi-resolution peak-files"),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::get_use_peak_levels),
+		sigc::mem_fun (*_rc_config, &RCConfiguration::set_use_peak_levels)
+		);
+	Gtkmm2ext::UI::instance()->set_tip (upl->tip_widget(), _("Store additional decimated copies of peak-files, to speed up drawing waveforms of long regions when zoomed out.\nThis uses about a third more disk-space for peak-files."));
+	add_option (_("Appearance/Waveform"), upl);
+
 	add_option (_("Appearance/Waveform"), new OptionEditorBlank ());
 
 	/* The names of these controls must be the same as those given in MixerStrip
@@ -3286,6 +3326,17 @@ These settings will only take effect after %1 is restarted.\n\
 	add_option (_("Appearance"), _cairo_image_surface);
 #endif
 
+	bo = new BoolOption (
+		"cache-static-canvas-layers",
+		_("Cache rulers and grid lines of the editor canvas"),
+		sigc::mem_fun (UIConfiguration::instance(), &UIConfiguration::get_cache_static_canvas_layers),
+		sigc::mem_fun (UIConfiguration::instance(), &UIConfiguration::set_cache_static_canvas_layers)
+		);
+
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+				_("Keep rendered rulers and grid lines in memory, so that they are not redrawn whenever the playhead or markers move over them. This uses additional memory."));
+	add_option (_("Appearance"), bo);
+
 #ifdef CAIRO_SUPPORTS_FORCE_BUGGY_GRADIENTS_ENVIRONMENT_VARIABLE
 	BoolOption* bgo = new BoolOption (
 		"buggy-gradients",
@@ -4208,6 +4259,16 @@ These settings will only take effect after %1 is restarted.\n\
 				sigc::mem_fun (*this, &RCOptionEditor::plugin_scan_refresh)));
 
 	add_option (_("Plugins"), new PluginScanTimeOutSliderOption (_rc_config));
+
+	SpinOption<uint32_t>* psj = new SpinOption<uint32_t> (
+			"plugin-scan-jobs",
+			_("Concurrent plugin scans"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_plugin_scan_jobs),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_plugin_scan_jobs),
+			0, 64, 1, 4);
+	add_option (_("Plugins"), psj);
+	Gtkmm2ext::UI::instance()->set_tip (psj->tip_widget(),
+			_("Number of external scanner processes to run at the same time when discovering new VST plugins. 0 uses one per CPU core, 1 scans one plugin at a time."));
 #endif
 
 	add_option (_("Plugins"), new OptionEditorHeading (_("General")));
@@ -4275,6 +4336,16 @@ These settings will only take effect after %1 is restarted.\n\
 	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
 					    _("<b>When enabled</b> sidechain ports are created for plugins at instantiation time if a plugin has sidechain inputs. Note that the ports themselves will have to be manually connected, so while the plugin pins are connected they are initially fed with silence.\n<b>When disabled</b> sidechain input pins will remain unconnected."));
 
+	bo = new BoolOption (
+		"lua-dsp-use-tlsf",
+			_("Use TLSF memory allocator for Lua DSP scripts"),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::get_lua_dsp_use_tlsf),
+			sigc::mem_fun (*_rc_config, &RCConfiguration::set_lua_dsp_use_tlsf)
+			);
+	add_option (_("Plugins"), bo);
+	Gtkmm2ext::UI::instance()->set_tip (bo->tip_widget(),
+					    _("<b>When enabled</b> Lua DSP processors use a two-level segregated fit (TLSF) allocator for their realtime memory pool, which has constant time allocation. <b>When disabled</b> the default pool allocator is used.\nThis only affects Lua DSP processors that are added or loaded afterwards."));
+
 	add_option (_("Plugins/GUI"), new OptionEditorHeading (_("Plugin GUI")));
 	add_option (_("Plugins/GUI"),
 	     new BoolOption (
@@ -5113,6 +5184,20 @@ These settings will only take effect after %1 is restarted.\n\
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
 		add_option (_("Performance"), procs);
+
+		ComboOption<GraphSchedulingMode>* gsm = new ComboOption<GraphSchedulingMode> (
+				"graph-scheduling-mode",
+				_("Process graph scheduling"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_scheduling_mode),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_scheduling_mode)
+				);
+
+		gsm->add (GraphSharedQueue, _("Shared queue"));
+		gsm->add (GraphWorkStealing, _("Work stealing"));
+
+		set_tooltip (gsm->tip_widget(), _("With a shared queue, all DSP threads take work from a single queue. With work stealing, each thread keeps the routes that it unlocks, and idle threads take work from busy ones. This can reduce contention with many routes and processors."));
+
+		add_option (_("Performance"), gsm);
 	}
 
 #if !(defined PLATFORM_WINDOWS || defined __APPLE__)
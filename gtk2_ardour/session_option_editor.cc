@@ -209,6 +209,18 @@ SessionOptionEditor::SessionOptionEditor (Session* s)
 
 	add_option (_("Media"), hf);
 
+	add_option (_("Media"), new OptionEditorHeading (_("Disk I/O")));
+
+	BoolOption* ado = new BoolOption (
+			"async-disk-read",
+			_("Asynchronous disk read-ahead"),
+			sigc::mem_fun (*_session_config, &SessionConfiguration::get_async_disk_read),
+			sigc::mem_fun (*_session_config, &SessionConfiguration::set_async_disk_read)
+			);
+	Gtkmm2ext::UI::instance()->set_tip (ado->tip_widget(),
+			_("When enabled, playback of uncompressed audio files queues reads ahead of time, which keeps many disk requests in flight. This can help sessions with many tracks on fast storage."));
+	add_option (_("Media"), ado);
+
 	add_option (S_("Files|Locations"), new OptionEditorHeading (_("File Locations")));
 
 	SearchPathOption* spo = new SearchPathOption ("audio-search-path", _("Search for audio files in:"),
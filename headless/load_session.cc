@@ -32,9 +32,13 @@
 #include "pbd/debug.h"
 #include "pbd/error.h"
 #include "pbd/failed_constructor.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/xml++.h"
 
 #include "ardour/ardour.h"
 #include "ardour/audioengine.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/revision.h"
 #include "ardour/session.h"
 
@@ -87,6 +91,46 @@ load_session (string dir, string state)
 	return session;
 }
 
+/** Time saving the session state, as periodic backups do,
+ *  and parsing it back, using XML and the binary format.
+ */
+static void
+benchmark_state (Session* s, int iterations)
+{
+	bool const save_binary_state = Config->get_save_binary_state ();
+	std::string const path = Glib::build_filename (s->path (), s->snap_name () + pending_suffix);
+
+	for (int binary = 0; binary < 2; ++binary) {
+		Config->set_save_binary_state (binary);
+
+		int64_t save_time = 0;
+		int64_t read_time = 0;
+		GStatBuf sb;
+		sb.st_size = 0;
+
+		for (int i = 0; i < iterations; ++i) {
+			int64_t const t0 = g_get_monotonic_time ();
+			s->save_state ("", true);
+			int64_t const t1 = g_get_monotonic_time ();
+			XMLTree tree (path);
+			int64_t const t2 = g_get_monotonic_time ();
+
+			save_time += t1 - t0;
+			read_time += t2 - t1;
+			g_stat (path.c_str (), &sb);
+		}
+
+		s->remove_pending_capture_state ();
+
+		printf ("%-6s: save %8.2f ms, parse %8.2f ms, size %10ld bytes
+",
+		        binary ? "binary" : "XML",
+		        save_time / 1e3 / iterations, read_time / 1e3 / iterations, (long)sb.st_size);
+	}
+
+	Config->set_save_binary_state (save_binary_state);
+}
+
 static void
 access_action (const std::string& action_group, const std::string& action_item)
 {
@@ -145,6 +189,7 @@ print_help ()
 	     << "  -D, --debug <options>       Set debug flags. Use \"-D list\" to see available options\n"
 	     << "  -O, --no-hw-optimizations   Disable h/w specific optimizations\n"
 	     << "  -P, --no-connect-ports      Do not connect any ports at startup\n"
+	     << "  -S, --state-benchmark <n>   Time loading, saving and parsing the session state <n> times, then quit\n"
 #ifdef WINDOWS_VST_SUPPORT
 	     << "  -V, --novst                 Do not use VST support\n"
 #endif
@@ -154,7 +199,7 @@ print_help ()
 int
 main (int argc, char* argv[])
 {
-	const char* optstring = "vhBdD:c:OU:P";
+	const char* optstring = "vhBdD:c:OU:PS:";
 
 	/* clang-format off */
 	const struct option longopts[] = {
@@ -166,11 +211,13 @@ main (int argc, char* argv[])
 		{ "name",                required_argument, 0, 'c' },
 		{ "no-hw-optimizations", no_argument,       0, 'O' },
 		{ "no-connect-ports",    no_argument,       0, 'P' },
+		{ "state-benchmark",     required_argument, 0, 'S' },
 		{ 0, 0, 0, 0 }
 	};
 	/* clang-format on */
 
 	bool try_hw_optimization = true;
+	int  state_benchmark     = 0;
 
 	backend_client_name = PBD::downcase (std::string (PROGRAM_NAME));
 
@@ -216,6 +263,10 @@ main (int argc, char* argv[])
 				ARDOUR::Port::set_connecting_blocked (true);
 				break;
 
+			case 'S':
+				state_benchmark = atoi (optarg);
+				break;
+
 			default:
 				print_help ();
 				exit (EXIT_FAILURE);
@@ -234,6 +285,7 @@ main (int argc, char* argv[])
 	}
 
 	Session* s = 0;
+	int64_t const load_start = g_get_monotonic_time ();
 
 	try {
 		s = load_session (argv[optind], argv[optind + 1]);
@@ -251,6 +303,12 @@ main (int argc, char* argv[])
 		exit (EXIT_FAILURE);
 	}
 
+	if (state_benchmark > 0) {
+		std::string const statefile = Glib::build_filename (argv[optind], std::string (argv[optind + 1]) + statefile_suffix);
+		printf ("load  : %8.2f ms (%s)\n", (g_get_monotonic_time () - load_start) / 1e3,
+		        XMLTree::is_binary_file (statefile) ? "binary" : "XML");
+	}
+
 	/* allow signal propagation, callback/thread-pool setup, etc
 	 * similar to to GUI "first idle"
 	 */
@@ -261,6 +319,15 @@ main (int argc, char* argv[])
 		exit (EXIT_FAILURE);
 	}
 
+	if (state_benchmark > 0) {
+		benchmark_state (s, state_benchmark);
+		AudioEngine::instance ()->remove_session ();
+		delete s;
+		AudioEngine::instance ()->stop ();
+		ARDOUR::cleanup ();
+		return 0;
+	}
+
 	PBD::ScopedConnectionList con;
 	BasicUI::AccessAction.connect_same_thread (con, std::bind (&access_action, _1, _2));
 	AudioEngine::instance ()->Halted.connect_same_thread (con, std::bind (&engine_halted, _1));
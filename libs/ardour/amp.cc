@@ -33,6 +33,7 @@
 #include "ardour/gain_control.h"
 #include "ardour/midi_buffer.h"
 #include "ardour/rc_configuration.h"
+#include "ardour/runtime_functions.h"
 #include "ardour/session.h"
 
 #include "pbd/i18n.h"
@@ -106,13 +107,18 @@ Amp::run (BufferSet& bufs, samplepos_t start_sample, samplepos_t /*end_sample*/,
 		const gain_t a = 156.825f / (gain_t)_session.nominal_sample_rate(); // 25 Hz LPF; see Amp::apply_gain for details
 		gain_t lpf = _current_gain;
 
+		/* Low-pass filter the automation data once, in place
+		 * (the buffer is re-filled by setup_gain_automation() for
+		 * every cycle), then apply it to all channels.
+		 */
+		for (pframes_t nx = 0; nx < nframes; ++nx) {
+			gain_t const g = lpf;
+			lpf += a * (gab[nx] - lpf);
+			gab[nx] = g;
+		}
+
 		for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-			Sample* const sp = i->data();
-			lpf = _current_gain;
-			for (pframes_t nx = 0; nx < nframes; ++nx) {
-				sp[nx] *= lpf;
-				lpf += a * (gab[nx] - lpf);
-			}
+			apply_gain_vector_to_buffer (i->data(), gab, nframes);
 		}
 
 		if (fabsf (lpf) < GAIN_COEFF_SMALL) {
@@ -204,13 +210,7 @@ Amp::apply_gain (BufferSet& bufs, samplecnt_t sample_rate, samplecnt_t nframes,
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF
 
 	for (BufferSet::audio_iterator i = bufs.audio_begin(); i != bufs.audio_end(); ++i) {
-		Sample* const buffer = i->data();
-		double lpf = initial;
-
-		for (pframes_t nx = 0; nx < nframes; ++nx) {
-			buffer[nx] *= lpf;
-			lpf += a * (target - lpf);
-		}
+		gain_t const lpf = apply_gain_ramp (i->data(), nframes, initial, target, a);
 		if (i == bufs.audio_begin()) {
 			rv = lpf;
 		}
@@ -276,11 +276,7 @@ Amp::apply_gain (AudioBuffer& buf, samplecnt_t sample_rate, samplecnt_t nframes,
 	Sample* const buffer = buf.data (offset);
 	const gain_t a = 156.825f / (gain_t)sample_rate; // 25 Hz LPF, see [other] Amp::apply_gain() above for details
 
-	gain_t lpf = initial;
-	for (pframes_t nx = 0; nx < nframes; ++nx) {
-		buffer[nx] *= lpf;
-		lpf += a * (target - lpf);
-	}
+	gain_t const lpf = apply_gain_ramp (buffer, nframes, initial, target, a);
 
 	if (fabsf (lpf - target) < GAIN_COEFF_DELTA) return target;
 	return lpf;
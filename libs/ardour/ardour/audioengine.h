@@ -126,6 +126,10 @@ class LIBARDOUR_API AudioEngine : public PortManager, public SessionHandlePtr
 	/* END BACKEND PROXY API */
 
 	bool freewheeling() const { return _freewheeling; }
+	/** true if export is rendered by our own thread instead of the backend,
+	 * see RCConfiguration::get_export_offline()
+	 */
+	bool offline_rendering() const { return _offline_render.load () != 0; }
 	bool running() const { return _running; }
 
 	std::string backend_id (bool for_input);
@@ -307,6 +311,16 @@ class LIBARDOUR_API AudioEngine : public PortManager, public SessionHandlePtr
 	std::atomic<int>          _pending_playback_latency_callback;
 	std::atomic<int>          _pending_capture_latency_callback;
 
+	/* offline export: 0: off, 1: requested, 2: render thread started,
+	 * 3: backend process thread is parked and rendering, 4: stopping
+	 */
+	std::atomic<int>          _offline_render;
+	PBD::Thread*              _offline_render_thread;
+	pthread_t                 _offline_render_thread_id;
+
+	void offline_render_thread ();
+	void stop_offline_render ();
+
 	void start_hw_event_processing();
 	void stop_hw_event_processing();
 	void do_reset_backend();
@@ -22,11 +22,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 
 #include <time.h>
 
 #include "pbd/mutex.h"
+#include "pbd/rcu.h"
 #include "pbd/stateful.h"
 #include "pbd/xml++.h"
 
@@ -150,11 +152,35 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 	Sample*    peak_leftovers;
 	samplepos_t peak_leftover_sample;
 
-	mutable bool _first_run;
-	mutable double _last_scale;
-	mutable off_t _last_map_off;
-	mutable size_t  _last_raw_map_length;
-	mutable std::unique_ptr<PeakData[]> peak_cache;
+	/* memory-mapped peak-file, see read_peaks_with_fpp () */
+	struct PeakMap;
+	struct PeakLevel;
+
+	/* decimated levels of the peak-file, each 4x coarser than the previous */
+	static const int n_peak_levels = 6;
+
+	std::shared_ptr<PeakLevel const> peak_map (int level, off_t min_size) const;
+	void drop_peak_map (PBD::Mutex::Lock const&);
+
+	std::string peak_level_path (int level) const;
+	bool peak_levels_valid () const;
+	int  stamp_peak_levels () const;
+	int  build_peak_levels ();
+	void open_peak_levels ();
+	void close_peak_levels ();
+	void update_peak_levels (off_t first_peak, off_t n_peaks);
+
+	mutable SerializedRCUManager<PeakMap> _peak_map;
+	mutable PBD::Mutex                    _peak_map_lock;
+
+	/* set when all levels are complete, readers use level 0 until then */
+	mutable std::atomic<bool> _peak_levels_ready;
+
+	int   _peak_level_fd[n_peak_levels + 1];
+	off_t _peak_level_max[n_peak_levels + 1];
+
+	/* scratch space for update_peak_levels (), allocated by open_peak_levels () */
+	std::unique_ptr<PeakData[]> _peak_level_buf;
 };
 
 }
@@ -24,6 +24,8 @@
 
 #include <optional>
 
+#include "pbd/timing.h"
+
 #include "evoral/Curve.h"
 
 #include "ardour/disk_io.h"
@@ -83,6 +85,11 @@ public:
 	 */
 	LIBARDOUR_API int do_refill ();
 
+	/** Duration of butler refills (do_refill), in microseconds */
+	LIBARDOUR_API bool get_refill_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const;
+	LIBARDOUR_API void clear_refill_stats ();
+	LIBARDOUR_API PBD::microseconds_t last_refill_time () const { return _last_refill_time.load (); }
+
 	/** For contexts outside the normal butler refill loop (allocates temporary working buffers) */
 	int do_refill_with_alloc (bool partial_fill, bool reverse);
 
@@ -177,7 +184,6 @@ protected:
 
 	private:
 		float _a;
-		float _l;
 		float _g;
 	};
 
@@ -256,6 +262,10 @@ private:
 
 	bool _midi_catchup;
 	bool _need_midi_catchup;
+
+	PBD::TimingStats                 _refill_stats;
+	std::atomic<int>                 _refill_stats_reset;
+	std::atomic<PBD::microseconds_t> _last_refill_time;
 };
 
 } // namespace ARDOUR
@@ -46,6 +46,7 @@ namespace AudioGrapher {
 	template <typename T> class CmdPipeWriter;
 	template <typename T> class SilenceTrimmer;
 	template <typename T> class TmpFile;
+	template <typename T> class TmpMem;
 	template <typename T> class Threader;
 	template <typename T> class AllocatingProcessContext;
 }
@@ -77,20 +78,24 @@ class LIBARDOUR_API ExportGraphBuilder
 		}
 		/* MIDI Export */
 		ExportSMFWriter midi;
+		/* the timespan that this is exported for, a channel is
+		 * read once per cycle for all timespans that use it.
+		 */
+		std::shared_ptr<ExportTimespan> timespan;
 		void process (MidiBuffer const& buf, sampleoffset_t off, samplecnt_t cnt, bool last_cycle) {
 			midi.process (buf, off, cnt, last_cycle);
 		}
 	};
 
 	typedef std::shared_ptr<AnyExport> AnyExportPtr;
-	typedef std::map<ExportChannelPtr, AnyExportPtr> ChannelMap;
+	typedef std::map<ExportChannelPtr, std::list<AnyExportPtr> > ChannelMap;
 
   public:
 
 	ExportGraphBuilder (Session const & session);
 	~ExportGraphBuilder ();
 
-	samplecnt_t process (samplecnt_t samples, bool last_cycle);
+	samplecnt_t process (samplepos_t position, samplecnt_t samples, bool last_cycle);
 	bool post_process (); // returns true when finished
 	bool need_postprocessing () const { return !intermediates.empty(); }
 	bool realtime() const { return _realtime; }
@@ -102,8 +107,14 @@ class LIBARDOUR_API ExportGraphBuilder
 	void add_config (FileSpec const & config, bool rt);
 	void get_analysis_results (AnalysisResults& results);
 
-	std::vector<std::string> exported_files () const {
-		return _exported_files;
+	std::vector<std::string> exported_files (std::shared_ptr<ExportTimespan> span) const {
+		std::vector<std::string> rv;
+		for (auto const& f : _exported_files) {
+			if (f.first == span) {
+				rv.push_back (f.second);
+			}
+		}
+		return rv;
 	}
 
   private:
@@ -113,10 +124,10 @@ class LIBARDOUR_API ExportGraphBuilder
 	}
 
 	void add_export_fn (std::string const& fn) {
-		_exported_files.push_back (fn);
+		_exported_files.push_back (std::make_pair (timespan, fn));
 	}
 
-	std::vector<std::string> _exported_files;
+	std::vector<std::pair<std::shared_ptr<ExportTimespan>, std::string> > _exported_files;
 
 	void add_split_config (FileSpec const & config);
 
@@ -212,11 +223,14 @@ class LIBARDOUR_API ExportGraphBuilder
 		typedef std::shared_ptr<AudioGrapher::PeakReader> PeakReaderPtr;
 		typedef std::shared_ptr<AudioGrapher::LoudnessReader> LoudnessReaderPtr;
 		typedef std::shared_ptr<AudioGrapher::TmpFile<Sample> > TmpFilePtr;
+		typedef std::shared_ptr<AudioGrapher::TmpMem<Sample> > TmpMemPtr;
 		typedef std::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 		typedef std::shared_ptr<AudioGrapher::AllocatingProcessContext<Sample> > BufferPtr;
 
 		void prepare_post_processing ();
 		void start_post_processing ();
+		void memory_written ();
+		samplecnt_t samples_written () const;
 
 		ExportGraphBuilder & parent;
 
@@ -227,6 +241,7 @@ class LIBARDOUR_API ExportGraphBuilder
 		BufferPtr       buffer;
 		PeakReaderPtr   peak_reader;
 		TmpFilePtr      tmp_file;
+		TmpMemPtr       tmp_mem; // used instead of tmp_file, if it fits
 		ThreaderPtr     threader;
 
 		LoudnessReaderPtr    loudness_reader;
@@ -247,15 +262,17 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	                                        private:
 		typedef std::shared_ptr<AudioGrapher::SampleRateConverter> SRConverterPtr;
+		typedef std::shared_ptr<AudioGrapher::Threader<Sample> > ThreaderPtr;
 
 		template<typename T>
-		void add_child_to_list (FileSpec const & new_config, boost::ptr_list<T> & list);
+		void add_child_to_list (FileSpec const & new_config, boost::ptr_list<T> & list, AudioGrapher::Source<Sample> & source);
 
 		ExportGraphBuilder &  parent;
 		FileSpec              config;
 		boost::ptr_list<SFC>  children;
 		boost::ptr_list<Intermediate> intermediate_children;
 		SRConverterPtr        converter;
+		ThreaderPtr           threader; // encode SFC children in parallel
 		samplecnt_t           max_samples_out;
 	};
 
@@ -292,6 +309,7 @@ class LIBARDOUR_API ExportGraphBuilder
 
 		ExportGraphBuilder &      parent;
 		FileSpec                  config;
+		std::shared_ptr<ExportTimespan> timespan;
 		boost::ptr_list<SilenceHandler> children;
 		InterleaverPtr            interleaver;
 		ChunkerPtr                chunker;
@@ -312,6 +330,9 @@ class LIBARDOUR_API ExportGraphBuilder
 
 	std::list<Intermediate *> intermediates;
 
+	/* memory that Intermediates may still use for the current render */
+	size_t _tmp_mem_available;
+
 	AnalysisMap analysis_map;
 
 	bool        _realtime;
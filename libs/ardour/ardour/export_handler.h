@@ -158,11 +158,19 @@ class LIBARDOUR_API ExportHandler : public ExportElementFactory, public sigc::tr
 	int  process_timespan (samplecnt_t samples);
 	int  post_process ();
 	void finish_timespan ();
+	void finish_timespan_files (std::vector<std::string> const&);
+	bool can_share_render (ExportTimespanPtr) const;
 
 	typedef std::pair<ConfigMap::iterator, ConfigMap::iterator> TimespanBounds;
 	ExportTimespanPtr     current_timespan;
 	TimespanBounds        timespan_bounds;
 
+	/* Timespans that are rendered in a single pass, the first
+	 * one is current_timespan.
+	 */
+	std::vector<ExportTimespanPtr> render_timespans;
+	samplepos_t           render_end;
+
 	PBD::ScopedConnection process_connection;
 	samplepos_t           process_position;
 
@@ -84,7 +84,12 @@ class LIBARDOUR_API ExportStatus {
 
 	AnalysisResults         result_map;
 
+	/** @return exported duration over elapsed wallclock time since init() */
+	double realtime_factor (samplecnt_t sample_rate) const;
+
   private:
+	int64_t                _start_time;
+
 	volatile bool          _aborted;
 	volatile bool          _errors;
 	volatile bool          _running;
@@ -32,6 +32,7 @@
 
 #include "pbd/mpmc_queue.h"
 #include "pbd/semutils.h"
+#include "pbd/work_stealing_deque.h"
 
 #include "ardour/audio_backend.h"
 #include "ardour/libardour_visibility.h"
@@ -60,18 +61,43 @@ struct GraphChain {
 	~GraphChain ();
 	void dump () const;
 	bool plot (std::string const&) const;
+	void update_priorities (uint32_t n_levels) const;
 
 	node_list_t _nodes_rt;
 	/** Nodes that are not fed by any other nodes */
 	node_list_t _init_trigger_list;
 	/** The number of nodes that do not feed any other node */
 	int _n_terminal_nodes;
+	/** Cycle counter, to periodically call update_priorities () */
+	mutable uint32_t _prio_update_cnt;
+};
+
+/** Per process-thread scheduler statistics */
+struct LIBARDOUR_API GraphThreadStats {
+	GraphThreadStats ()
+		: n_run (0)
+		, n_shared (0)
+		, n_local (0)
+		, n_stolen (0)
+		, n_miss (0)
+		, n_sleep (0)
+		, busy_usec (0)
+	{}
+
+	uint64_t n_run;          ///< nodes processed by this thread
+	uint64_t n_shared;       ///< nodes taken from the shared trigger-queue
+	uint64_t n_local;        ///< nodes taken from the thread's own deque
+	uint64_t n_stolen;       ///< nodes stolen from other threads' deques
+	uint64_t n_miss;         ///< attempts to find work that came up empty
+	uint64_t n_sleep;        ///< number of times the thread went idle
+	uint64_t busy_usec;      ///< total time spent processing nodes
 };
 
 class LIBARDOUR_API Graph : public SessionHandleRef
 {
 public:
 	Graph (Session& session);
+	~Graph ();
 
 	/* public API for use by session-process */
 	int process_routes (std::shared_ptr<GraphChain> chain, pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool& need_butler);
@@ -93,6 +119,10 @@ public:
 	/* RTTasks */
 	void process_tasklist (RTTaskList const&);
 
+	/* statistics */
+	void thread_stats (std::vector<GraphThreadStats>&) const;
+	void reset_thread_stats ();
+
 protected:
 	virtual void session_going_away ();
 
@@ -104,9 +134,42 @@ private:
 	void prep ();
 
 	void helper_thread ();
-
-	PBD::MPMCQueue<ProcessNode*> _trigger_queue;      ///< nodes that can be processed
-	std::atomic<uint32_t>        _trigger_queue_size; ///< number of entries in trigger-queue
+	bool pop_node (ProcessNode*&);
+	bool pop_shared (ProcessNode*&, uint32_t min_priority);
+	void push_shared (ProcessNode*);
+
+	/** Nodes are scheduled in order of their critical path,
+	 * quantized to this many priority levels.
+	 */
+	static const uint32_t n_priority_levels = 4;
+
+	PBD::MPMCQueue<ProcessNode*> _trigger_queue[n_priority_levels]; ///< nodes that can be processed, by priority
+	std::atomic<uint32_t>        _trigger_queue_size; ///< number of entries in trigger-queue and all per-thread deques
+
+	/** Per process-thread state, indexed by thread-id (0: main thread) */
+	struct alignas (64) ThreadState {
+		/** nodes triggered by this thread, when using GraphWorkStealing */
+		PBD::WorkStealingDeque<ProcessNode*> deque;
+
+		std::atomic<uint64_t> n_run;
+		std::atomic<uint64_t> n_shared;
+		std::atomic<uint64_t> n_local;
+		std::atomic<uint64_t> n_stolen;
+		std::atomic<uint64_t> n_miss;
+		std::atomic<uint64_t> n_sleep;
+		std::atomic<uint64_t> busy_usec;
+
+		void reset_stats ();
+	};
+
+	ThreadState* _thread_state;
+	uint32_t     _max_threads;
+
+	/** Scheduling mode for the current cycle, updated in prep() */
+	bool _work_stealing;
+
+	/** Set to reset thread statistics at the start of the next cycle */
+	std::atomic<int> _stats_reset;
 
 	/** Start worker threads */
 	PBD::Semaphore _execution_sem;
@@ -43,9 +43,18 @@ typedef std::list<node_ptr_t>        node_list_t;
 class LIBARDOUR_API ProcessNode
 {
 public:
+	ProcessNode () : _priority (0) {}
 	virtual ~ProcessNode() {}
 	virtual void prep (GraphChain const*) = 0;
 	virtual void run (GraphChain const*) = 0;
+
+	/** scheduling priority, 0 is lowest */
+	uint32_t priority () const { return _priority; }
+
+protected:
+	friend struct GraphChain;
+
+	uint32_t _priority;
 };
 
 class LIBARDOUR_API GraphActivision
@@ -85,7 +94,14 @@ public:
 
 	virtual bool direct_feeds_according_to_reality (std::shared_ptr<GraphNode>, bool* via_send_only = 0) = 0;
 
+	/** rolling average of the time spent in process() [usec] */
+	float dsp_cost () const { return _dsp_cost; }
+	/** dsp_cost () of this node plus the most expensive downstream path [usec] */
+	float critical_path () const { return _critical_path; }
+
 protected:
+	friend struct GraphChain;
+
 	void trigger ();
 	virtual void process () = 0;
 
@@ -95,6 +111,9 @@ private:
 	void finish (GraphChain const*);
 
 	std::atomic<int> _refcount;
+
+	float _dsp_cost;
+	float _critical_path;
 };
 
 } // namespace ARDOUR
@@ -37,16 +37,26 @@ public:
 	IOTaskList (uint32_t);
 	~IOTaskList ();
 
-	/** process tasks in list in parallel, wait for them to complete */
+	/** process tasks in list in parallel, wait for them to complete.
+	 * Tasks are started in order of decreasing priority,
+	 * tasks with equal priority in the order they were added.
+	 */
 	void process ();
-	void push_back (std::function<void ()> fn);
+	void push_back (std::function<void ()> fn, float priority = 0.f);
 
 private:
 	static void* _worker_thread (void*);
 
 	void io_thread ();
 
-	std::vector<std::function<void ()>> _tasks;
+	struct Task {
+		Task (std::function<void ()> f, float p) : fn (f), priority (p) {}
+		std::function<void ()> fn;
+		float                  priority;
+	};
+
+	std::vector<Task> _tasks;
+	std::atomic<size_t> _next_task;
 
 	uint32_t               _n_threads;
 	std::atomic<uint32_t>  _n_workers;
@@ -54,7 +64,6 @@ private:
 	std::atomic <bool>     _terminate;
 	PBD::Semaphore         _exec_sem;
 	PBD::Semaphore         _idle_sem;
-	PBD::Mutex   _tasks_mutex;
 };
 
 } // namespace ARDOUR
@@ -19,23 +19,18 @@
 /* print runtime and garbage-collection timing statistics */
 //#define WITH_LUAPROC_STATS
 
-/* memory allocation system, default: ReallocPool */
-//#define USE_TLSF // use TLSF instead of ReallocPool
-//#define USE_MALLOC // or plain OS provided realloc (no mlock) -- if USE_TLSF isn't defined
+/* memory allocation system, default: ReallocPool or TLSF (see Config->get_lua_dsp_use_tlsf) */
+//#define USE_MALLOC // use plain OS provided realloc (no mlock)
 
 #pragma once
 
+#include <atomic>
 #include <set>
 #include <vector>
 #include <string>
 
-#ifdef USE_TLSF
-#  include "pbd/tlsf.h"
-#else
-#  include "pbd/reallocpool.h"
-#endif
-
 #include "pbd/stateful.h"
+#include "pbd/timing.h"
 
 #include "ardour/types.h"
 #include "ardour/plugin.h"
@@ -49,6 +44,11 @@ namespace luabridge {
 	class LuaRef;
 }
 
+namespace PBD {
+	class ReallocPool;
+	class TLSF;
+}
+
 namespace ARDOUR {
 
 class LIBARDOUR_API LuaProc : public ARDOUR::Plugin {
@@ -128,6 +128,19 @@ public:
 	DSP::DspShm* instance_shm () { return &lshm; }
 	LuaTableRef* instance_ref () { return &lref; }
 
+	/** time spent in the garbage collector after each run */
+	bool get_gc_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const;
+
+	/** memory used by the Lua state of this processor.
+	 * @param used bytes currently in use
+	 * @param peak max. bytes in use since the last clear_stats()
+	 * @param n_alloc allocations since the last clear_stats()
+	 * @param n_alloc_run allocations during connect_and_run since the last clear_stats()
+	 */
+	bool get_mem_stats (int64_t& used, int64_t& peak, int64_t& n_alloc, int64_t& n_alloc_run) const;
+	void clear_stats ();
+	bool uses_tlsf () const { return _mempool.tlsf != 0; }
+
 	struct FactoryPreset {
 		std::string               name;
 		std::map<uint32_t, float> param;
@@ -149,11 +162,32 @@ protected:
 	const std::string& origin() const { return _origin; }
 
 private:
-#ifdef USE_TLSF
-	PBD::TLSF _mempool;
-#else
-	PBD::ReallocPool _mempool;
-#endif
+	/* Per instance memory arena of the Lua state, this also
+	 * keeps track of allocations for the stats.
+	 */
+	struct MemPool {
+		MemPool (bool use_tlsf);
+		~MemPool ();
+
+		void set_name (std::string const&);
+		void reset_stats ();
+
+		static void* lalloc (void* pool, void* ptr, size_t oldsize, size_t newsize);
+
+		PBD::ReallocPool* rap;
+		PBD::TLSF*        tlsf;
+
+		/* written by the thread using the Lua state, read by get_mem_stats () */
+		std::atomic<size_t> used;
+		std::atomic<size_t> peak;
+		std::atomic<size_t> n_alloc;
+		std::atomic<size_t> n_alloc_run;
+
+		bool in_run;
+		int  gc_cycles; // remaining GC cycles to complete
+	};
+
+	MemPool _mempool;
 	LuaState lua;
 	luabridge::LuaRef * _lua_dsp;
 	luabridge::LuaRef * _lua_latency;
@@ -209,6 +243,8 @@ private:
 	bool _has_midi_input;
 	bool _has_midi_output;
 
+	PBD::TimingStats _gc_stats;
+	std::atomic<int> _stat_reset;
 
 #ifdef WITH_LUAPROC_STATS
 	int64_t _stats_avg[2];
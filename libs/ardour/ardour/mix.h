@@ -34,6 +34,10 @@ extern "C" {
 
 LIBARDOUR_API void x86_sse_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
 
+LIBARDOUR_API float x86_sse_apply_gain_ramp              (float* buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_sse_apply_gain_vector_to_buffer  (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+
 extern "C" {
 /* AVX functions */
 	LIBARDOUR_API float x86_sse_avx_compute_peak          (float const* buf, uint32_t nsamples, float current);
@@ -49,9 +53,14 @@ extern "C" {
 LIBARDOUR_API void x86_sse_avx_find_peaks               (float const* buf, uint32_t nsamples, float* min, float* max);
 #endif
 
+LIBARDOUR_API float x86_avx_apply_gain_ramp              (float* buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_avx_apply_gain_vector_to_buffer  (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_avx_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+
 /* FMA functions */
 #ifdef FPU_AVX_FMA_SUPPORT
 LIBARDOUR_API void  x86_fma_mix_buffers_with_gain       (float* dst, float const* src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_fma_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
 #endif
 
 /* AVX512F functions */
@@ -62,6 +71,9 @@ LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain   (float* dst, float const
 LIBARDOUR_API void  x86_avx512f_mix_buffers_no_gain     (float* dst, float const* src, uint32_t nframes);
 LIBARDOUR_API void  x86_avx512f_copy_vector             (float* dst, float const* src, uint32_t nframes);
 LIBARDOUR_API void  x86_avx512f_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
+LIBARDOUR_API float x86_avx512f_apply_gain_ramp         (float* buf, uint32_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  x86_avx512f_apply_gain_vector_to_buffer  (float* buf, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_avx512f_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
 #endif
 
 /* debug wrappers for SSE functions */
@@ -81,6 +93,8 @@ LIBARDOUR_API void  veclib_apply_gain_to_buffer      (ARDOUR::Sample* buf, ARDOU
 LIBARDOUR_API void  veclib_mix_buffers_with_gain     (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  veclib_mix_buffers_no_gain       (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  veclib_find_peaks                (ARDOUR::Sample const* buf, ARDOUR::pframes_t nsamples, float* min, float* max);
+LIBARDOUR_API void  veclib_apply_gain_vector_to_buffer  (ARDOUR::Sample* buf, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  veclib_mix_buffers_with_gain_vector (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
 
 #endif
 
@@ -93,6 +107,9 @@ extern "C" {
 	LIBARDOUR_API void  arm_neon_find_peaks            (float const* src, uint32_t nframes, float* minf, float* maxf);
 	LIBARDOUR_API void  arm_neon_mix_buffers_no_gain   (float* dst, float const* src, uint32_t nframes);
 	LIBARDOUR_API void  arm_neon_mix_buffers_with_gain (float* dst, float const* src, uint32_t nframes, float gain);
+	LIBARDOUR_API float arm_neon_apply_gain_ramp              (float* buf, uint32_t nframes, float initial, float target, float coeff);
+	LIBARDOUR_API void  arm_neon_apply_gain_vector_to_buffer  (float* buf, float const* gain, uint32_t nframes);
+	LIBARDOUR_API void  arm_neon_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
 }
 #endif
 
@@ -104,4 +121,7 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample* buf, ARDO
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector               (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API float default_apply_gain_ramp           (ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float initial, float target, float coeff);
+LIBARDOUR_API void  default_apply_gain_vector_to_buffer  (ARDOUR::Sample* buf, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_mix_buffers_with_gain_vector (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::gain_t const* gain, ARDOUR::pframes_t nframes);
 
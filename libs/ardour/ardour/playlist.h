@@ -39,6 +39,7 @@
 
 #include <glib.h>
 
+#include "pbd/mutex.h"
 #include "pbd/rwlock.h"
 #include "pbd/sequence_property.h"
 #include "pbd/stateful.h"
@@ -58,6 +59,7 @@ namespace ARDOUR {
 class Session;
 class Playlist;
 class Crossfade;
+class RegionIndex;
 class Track;
 
 namespace Properties {
@@ -325,6 +327,7 @@ protected:
 		    , playlist (pl)
 		    , block_notify (do_block_notify)
 		{
+			playlist->_region_write_locked = true;
 			if (block_notify) {
 				playlist->delay_notifications ();
 			}
@@ -332,6 +335,8 @@ protected:
 
 		~RegionWriteLock ()
 		{
+			playlist->invalidate_region_index ();
+			playlist->_region_write_locked = false;
 			PBD::RWLock::WriterLock::release ();
 			thawlist.release ();
 			if (block_notify) {
@@ -475,6 +480,17 @@ private:
 	void coalesce_and_check_crossfades (std::list<Temporal::TimeRange>);
 	std::shared_ptr<RegionList> find_regions_at (timepos_t const &);
 
+	std::shared_ptr<RegionIndex const> region_index () const;
+	void invalidate_region_index ();
+
+	/* Interval index of `regions', built on demand by readers,
+	 * invalidated when the write-lock is released.
+	 */
+	mutable PBD::Mutex                         _region_index_lock;
+	mutable std::shared_ptr<RegionIndex const> _region_index;
+	mutable bool                               _region_index_valid;
+	std::atomic<bool>                          _region_write_locked;
+
 	mutable std::optional<std::pair<timepos_t, timepos_t> > _cached_extent;
 	timepos_t _end_space;  //this is used when we are pasting a range with extra space at the end
 	bool _playlist_shift_active;
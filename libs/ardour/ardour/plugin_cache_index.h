@@ -0,0 +1,100 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+
+class XMLNode;
+
+namespace PBD {
+	class Searchpath;
+}
+
+namespace ARDOUR {
+
+/** A single file that holds the content of all plugin cache files
+ * (.v2i, .v3i) and the directory listings of the plugin search paths.
+ *
+ * Loading it replaces reading and parsing one cache file per plugin.
+ * Entries are validated lazily, when they are looked up: a cache entry
+ * is used only if neither the plugin module nor its cache file changed
+ * (mtime, size and inode) since it was added, and a directory is only
+ * listed again if its mtime changed.
+ *
+ * The file is written using the binary XMLTree encoding and is discarded
+ * when it was written by a different build.
+ */
+class LIBARDOUR_API PluginCacheIndex
+{
+public:
+	PluginCacheIndex ();
+	~PluginCacheIndex ();
+
+	/** Replace the current content with that of the index file */
+	void load ();
+
+	/** Write the index file if anything changed since load().
+	 * Entries that were not used since then are dropped.
+	 */
+	void save ();
+
+	/** @return the cached content of @a cache_file for @a module_path,
+	 * or 0 if there is no up-to-date entry
+	 */
+	XMLNode const* lookup (std::string const& module_path, std::string const& cache_file);
+
+	/** Add a copy of @a root, which was read from @a cache_file */
+	void add (std::string const& module_path, std::string const& cache_file, XMLNode const& root);
+
+	/** Recursively find files and directories in @a paths whose name
+	 * matches @a filter, like PBD::find_paths_matching_filter() returning
+	 * full paths. The listing of directories that did not change is reused.
+	 *
+	 * @param type identifies @a filter, directories are listed once per type
+	 * @param files_only ignore directories that match @a filter
+	 */
+	void find_paths (std::vector<std::string>& result, PBD::Searchpath const& paths, std::string const& type,
+	                 bool (*filter)(const std::string&, void*), bool files_only);
+
+private:
+	typedef std::map<std::string, XMLNode*>                          Plugins;
+	typedef std::map<std::pair<std::string, std::string>, XMLNode*> Dirs;
+
+	void clear ();
+	void walk (std::vector<std::string>&, std::string const& dir, std::string const& type,
+	           bool (*filter)(const std::string&, void*), bool files_only, std::set<std::string>& scanned);
+
+	static XMLNode* list_dir (std::string const& dir, std::string const& type,
+	                          bool (*filter)(const std::string&, void*), bool files_only, int64_t mtime);
+
+	static bool set_stat (XMLNode&, std::string const& prefix, std::string const& path);
+	static bool unchanged (XMLNode const&, std::string const& prefix, std::string const& path);
+
+	std::string              _path;
+	Plugins                  _plugins;
+	Dirs                     _dirs;
+	std::set<XMLNode const*> _used;
+	bool                     _dirty;
+};
+
+} // namespace ARDOUR
@@ -27,14 +27,17 @@
 #include "libardour-config.h"
 #endif
 
+#include <functional>
 #include <list>
 #include <map>
 #include <string>
 #include <set>
+#include <vector>
 
 #include "ardour/libardour_visibility.h"
 #include "ardour/types.h"
 #include "ardour/plugin.h"
+#include "ardour/plugin_cache_index.h"
 #include "ardour/plugin_scan_result.h"
 
 #ifdef AUDIOUNIT_SUPPORT
@@ -293,6 +296,8 @@ private:
 	std::string windows_vst_path;
 	std::string lxvst_path;
 
+	PluginCacheIndex _cache_index;
+
 	bool _cancel_scan_one;
 	bool _cancel_scan_all;
 	bool _cancel_scan_timeout_one;
@@ -358,6 +363,35 @@ private:
 	bool run_vst3_scanner_app (std::string bundle_path, PSLEPtr) const;
 #endif
 
+#if (defined LXVST_SUPPORT || defined VST3_SUPPORT)
+	/** A bundle to be scanned by an external scanner app */
+	struct ScanJob {
+		enum State {
+			Pending,  ///< not started (the scan was cancelled)
+			Failed,   ///< the scanner app could not be launched
+			Aborted,  ///< skipped or timed out
+			Done      ///< the scanner app finished
+		};
+
+		ScanJob (std::string const& p, std::string const& m, PSLEPtr l) : path (p), module_path (m), psle (l), state (Pending) {}
+
+		std::string path;
+		std::string module_path;
+		PSLEPtr     psle;
+		State       state;
+	};
+
+	uint32_t scanner_jobs () const;
+	void run_scanner_apps (std::string const& scanner_bin, std::string const& type, std::vector<ScanJob>&, std::function<void (ScanJob const&)> start);
+#endif
+
+#ifdef LXVST_SUPPORT
+	void lxvst_scan_parallel (std::vector<std::string> const&, std::set<std::string>& skip);
+#endif
+#ifdef VST3_SUPPORT
+	void vst3_scan_parallel (std::vector<std::string> const&, std::set<std::string>& skip);
+#endif
+
 	int ladspa_discover (std::string path);
 
 	std::string get_ladspa_category (uint32_t id);
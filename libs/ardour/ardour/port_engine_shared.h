@@ -89,6 +89,16 @@ class LIBARDOUR_API BackendPort : public ProtoPort
 		return _connections;
 	}
 
+	typedef std::vector<BackendPort*> ConnectionList;
+
+	/** Flat copy of the connections for use in the process thread.
+	 * It is replaced whenever connections change, so readers always
+	 * see a consistent list without taking a lock.
+	 */
+	std::shared_ptr<ConnectionList const> connection_list () const {
+		return _connection_list.reader ();
+	}
+
 	int  connect (BackendPortHandle port, BackendPortHandle self);
 	int  disconnect (BackendPortHandle port, BackendPortHandle self);
 	void disconnect_all (BackendPortHandle self);
@@ -116,8 +126,11 @@ private:
 	LatencyRange           _playback_latency_range;
 	std::set<BackendPortPtr> _connections;
 
+	SerializedRCUManager<ConnectionList> _connection_list;
+
 	void store_connection (BackendPortHandle);
 	void remove_connection (BackendPortHandle);
+	void update_connection_list ();
 
 }; // class BackendPort
 
@@ -0,0 +1,83 @@
+/*
+ * Copyright (C) 2026 Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_read_ahead_h_
+#define _ardour_read_ahead_h_
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include <stdint.h>
+
+#include "pbd/mutex.h"
+#include "pbd/semutils.h"
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR
+{
+
+/** Asynchronous read-ahead of file data.
+ *
+ * Disk reads of the butler are blocking and each one waits for the
+ * device. When enabled, sources queue the byte-range that they will
+ * most likely read next, and worker threads ask the kernel to fetch it
+ * into the page-cache (posix_fadvise), or read it if the system does
+ * not support that. This keeps many requests in flight, and the next
+ * blocking read is served from memory.
+ */
+class LIBARDOUR_API ReadAhead
+{
+public:
+	ReadAhead (uint32_t n_threads);
+	~ReadAhead ();
+
+	void set_enabled (bool);
+	bool enabled () const { return _enabled.load (); }
+
+	/** Queue read-ahead of \p len bytes at \p offset of file \p fd.
+	 * The file-descriptor is duplicated, and may be closed after this
+	 * call returns. Does not block on I/O.
+	 *
+	 * @return false if read-ahead is disabled or the queue is full.
+	 */
+	bool queue (int fd, int64_t offset, int64_t len);
+
+private:
+	struct Request {
+		int     fd;
+		int64_t offset;
+		int64_t len;
+	};
+
+	static void* _worker_thread (void*);
+	void io_thread ();
+	void start_threads ();
+
+	uint32_t               _n_threads;
+	std::vector<pthread_t> _workers;
+	std::atomic<bool>      _enabled;
+	std::atomic<bool>      _terminate;
+	std::deque<Request>    _requests;
+	PBD::Mutex             _requests_lock;
+	PBD::Semaphore         _request_sem;
+};
+
+} // namespace ARDOUR
+#endif
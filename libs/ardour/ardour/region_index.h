@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2026 Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "temporal/timeline.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+/** Immutable interval index of the regions of a playlist.
+ *
+ * Regions are stored sorted by position, as an implicit binary search tree
+ * which is augmented with the maximum end of each sub-tree (see
+ * H. Li, "cgranges", https://github.com/lh3/cgranges).
+ * Overlap queries are O(log N + K), and results are in position order,
+ * i.e. the same order as the playlist's RegionList.
+ *
+ * The index is a snapshot of region bounds at the time it was built. Queries
+ * return candidates; callers re-check the region's current bounds, so a
+ * stale index never produces false positives.
+ */
+class LIBARDOUR_API RegionIndex
+{
+public:
+	/** Build an index. Returns an empty pointer if the regions
+	 * cannot be ordered independent of the tempo-map (mixed time-domains).
+	 */
+	static std::shared_ptr<RegionIndex const> create (RegionList const&);
+
+	size_t size () const { return _entries.size (); }
+
+	/** Append regions whose [position, end) overlaps [start, end) */
+	void overlapping (timepos_t const& start, timepos_t const& end, RegionList&) const;
+
+	/** Append regions with position in [start, end) */
+	void starting_within (timepos_t const& start, timepos_t const& end, RegionList&) const;
+
+	/** Regions which may extend beyond their end (region-fx tail) */
+	RegionList const& tail_regions () const { return _tail_regions; }
+
+private:
+	RegionIndex () : _max_level (0) {}
+
+	struct Entry {
+		Entry (std::shared_ptr<Region> const&);
+
+		timepos_t               start;
+		timepos_t               end;
+		timepos_t               max_end;
+		std::shared_ptr<Region> region;
+	};
+
+	void build ();
+
+	std::vector<Entry> _entries;
+	RegionList         _tail_regions;
+	int                _max_level;
+};
+
+} // namespace ARDOUR
@@ -31,11 +31,25 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_no_gain_t)   (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)           (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 
+	typedef float (*apply_gain_ramp_t)              (ARDOUR::Sample *, pframes_t, float, float, float);
+	typedef void  (*apply_gain_vector_to_buffer_t)  (ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t);
+	typedef void  (*mix_buffers_with_gain_vector_t) (ARDOUR::Sample *, const ARDOUR::Sample *, const ARDOUR::gain_t *, pframes_t);
+
 	LIBARDOUR_API extern compute_peak_t          compute_peak;
 	LIBARDOUR_API extern find_peaks_t            find_peaks;
 	LIBARDOUR_API extern apply_gain_to_buffer_t  apply_gain_to_buffer;
 	LIBARDOUR_API extern mix_buffers_with_gain_t mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t   mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t           copy_vector;
+
+	/** Apply a 1-pole low-pass gain ramp from `initial' towards `target':
+	 *  buf[i] *= g; g += coeff * (target - g);
+	 *  @return the gain after the last sample
+	 */
+	LIBARDOUR_API extern apply_gain_ramp_t              apply_gain_ramp;
+	/** buf[i] *= gain[i] */
+	LIBARDOUR_API extern apply_gain_vector_to_buffer_t  apply_gain_vector_to_buffer;
+	/** dst[i] += src[i] * gain[i] */
+	LIBARDOUR_API extern mix_buffers_with_gain_vector_t mix_buffers_with_gain_vector;
 }
 
@@ -89,6 +89,7 @@
 #include "ardour/rc_configuration.h"
 #include "ardour/session_configuration.h"
 #include "ardour/session_event.h"
+#include "ardour/state_journal.h"
 #include "ardour/plugin.h"
 #include "ardour/presentation_info.h"
 #include "ardour/route.h"
@@ -149,10 +150,12 @@ class ExportHandler;
 class ExportStatus;
 class Graph;
 struct GraphChain;
+struct GraphThreadStats;
 class IO;
 class IOPlug;
 class IOProcessor;
 class IOTaskList;
+class ReadAhead;
 class ImportStatus;
 class MidiClockTicker;
 class MidiControlUI;
@@ -339,6 +342,7 @@ public:
 
 	std::shared_ptr<RTTaskList> rt_tasklist () { return _rt_tasklist; }
 	std::shared_ptr<IOTaskList> io_tasklist () { return _io_tasklist; }
+	std::shared_ptr<ReadAhead>  read_ahead () const { return _read_ahead; }
 
 	RouteList get_routelist (bool mixer_order = false, PresentationInfo::Flag fl = PresentationInfo::MixerRoutes) const;
 
@@ -365,6 +369,8 @@ public:
 	bool     empty () const;
 
 	bool plot_process_graph (std::string const& file_name) const;
+	void process_graph_thread_stats (std::vector<GraphThreadStats>&) const;
+	void reset_process_graph_thread_stats ();
 
 	std::shared_ptr<BundleList const> bundles () {
 		return _bundles.reader ();
@@ -1643,6 +1649,7 @@ private:
 	std::string _current_snapshot_name;
 
 	XMLTree*         state_tree;
+	StateJournal     _state_journal;
 	StateOfTheState _state_of_the_state;
 
 	friend class     StateProtector;
@@ -2384,6 +2391,7 @@ private:
 
 	std::shared_ptr<RTTaskList> _rt_tasklist;
 	std::shared_ptr<IOTaskList> _io_tasklist;
+	std::shared_ptr<ReadAhead>  _read_ahead;
 
 	/* Scene Changing */
 	SceneChanger* _scene_changer;
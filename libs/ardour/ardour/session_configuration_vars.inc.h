@@ -65,6 +65,7 @@ CONFIG_VARIABLE (std::string, timecode_generator_offset, "timecode-generator-off
 CONFIG_VARIABLE (bool, midi_copy_is_fork, "midi-copy-is-fork", true)
 CONFIG_VARIABLE (bool, tracks_follow_session_time, "tracks-follow-session-time", false)
 CONFIG_VARIABLE (bool, realtime_export, "realtime-export", false)
+CONFIG_VARIABLE (bool, async_disk_read, "async-disk-read", false)
 CONFIG_VARIABLE (bool, use_surround_master, "use-surround-master", false)
 
 /* Video-settings are saved with the session and belong to the session.
@@ -91,6 +91,13 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
 
+	/* read-ahead of uncompressed files */
+	int             _fd;
+	mutable int     _block_width;
+	mutable int64_t _data_offset;
+
+	void queue_read_ahead (samplepos_t start, samplecnt_t cnt) const;
+
 	void init_sndfile ();
 	int open();
 	int setup_broadcast_info (samplepos_t when, struct tm&, time_t);
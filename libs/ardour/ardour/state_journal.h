@@ -0,0 +1,117 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+
+class XMLNode;
+
+namespace ARDOUR {
+
+/** An append-only journal of changes to a session state tree.
+ *
+ * Pending (crash-recovery) saves happen frequently, but usually only a few
+ * routes or playlists change between them. After a full state file has been
+ * written, later saves append only those subtrees that differ from what was
+ * last written. Subtrees are the children of top-level containers whose
+ * children all carry a unique "id" (Routes, Playlists, Sources, ...), and
+ * all other top-level nodes as a whole.
+ *
+ * replay() applies a journal to the state that it is based on.
+ */
+class LIBARDOUR_API StateJournal
+{
+public:
+	StateJournal ();
+
+	/** Forget the base state, the next save must be a full one */
+	void invalidate ();
+
+	/** Forget the base state and remove the journal at @a path.
+	 * This must happen before a new full state file replaces the
+	 * one that the journal is based on.
+	 * @return false if the journal could not be removed
+	 */
+	bool discard (std::string const& path);
+
+	/** Use @a root, which has just been written in full, as base state.
+	 * Any existing journal at @a path is removed.
+	 * @param base_size size of the full state file in bytes, each record
+	 * is stamped with it.
+	 */
+	void reset (XMLNode const& root, std::string const& path, size_t base_size);
+
+	/** Append the difference between @a root and the previously
+	 * journaled state to the journal at @a path.
+	 * @return false if a full save is needed instead
+	 */
+	bool append (XMLNode const& root, std::string const& path);
+
+	/** Apply all complete records of the journal at @a path to @a root.
+	 * Records that are not based on a state file of @a base_size bytes
+	 * belong to an older state and are ignored.
+	 * @return number of records applied, or -1 on error
+	 */
+	static int replay (XMLNode& root, std::string const& path, size_t base_size);
+
+private:
+	struct Entry {
+		Entry () : hash (0) {}
+		Entry (std::string const& n, uint64_t h) : name (n), hash (h) {}
+		std::string name;
+		uint64_t    hash;
+	};
+
+	typedef std::map<std::string, Entry> Entries;
+
+	struct Unit {
+		Unit (std::string const& p, std::string const& k, XMLNode const* n, uint64_t h) : parent (p), key (k), node (n), hash (h) {}
+		std::string    parent;
+		std::string    key;
+		XMLNode const* node;
+		uint64_t       hash;
+	};
+
+	typedef std::vector<Unit> Units;
+
+	static void collect (XMLNode const& root, Units&, std::set<std::string>& containers);
+	static uint64_t hash (XMLNode const&, uint64_t h);
+	static uint64_t root_hash (XMLNode const&);
+	static std::string unit_id (std::string const& parent, std::string const& key);
+	static void apply (XMLNode& root, XMLNode const& delta);
+	static XMLNode* top_level (XMLNode& root, std::string const& key);
+
+	void set_base (Units const&, std::set<std::string> const&, XMLNode const& root);
+
+	bool                     _valid;
+	std::string              _path;
+	Entries                  _entries;
+	std::vector<std::string> _order;
+	std::set<std::string>    _containers;
+	uint64_t                 _root_hash;
+	size_t                   _base_size;
+	size_t                   _journal_size;
+	uint32_t                 _records;
+};
+
+} // namespace ARDOUR
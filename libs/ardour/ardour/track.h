@@ -25,6 +25,7 @@
 #include <memory>
 
 #include "pbd/enum_convert.h"
+#include "pbd/microseconds.h"
 
 #include "ardour/interthread_info.h"
 #include "ardour/recordable.h"
@@ -150,6 +151,9 @@ public:
 	float playback_buffer_load () const;
 	float capture_buffer_load () const;
 	int do_refill ();
+	bool get_refill_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const;
+	void clear_refill_stats ();
+	PBD::microseconds_t last_refill_time () const;
 	int do_flush (RunContext, bool force = false);
 	void set_pending_overwrite (OverwriteReason);
 	int seek (samplepos_t, bool complete_refill = false);
@@ -592,6 +592,11 @@ enum DenormalModel {
 	DenormalFTZDAZ
 };
 
+enum GraphSchedulingMode {
+	GraphSharedQueue,
+	GraphWorkStealing
+};
+
 enum LayerModel {
 	LaterHigher,
 	Manual
@@ -61,6 +61,7 @@ DEFINE_ENUM_CONVERT(ARDOUR::SyncSource)
 DEFINE_ENUM_CONVERT(ARDOUR::ShuttleUnits)
 DEFINE_ENUM_CONVERT(ARDOUR::ClockDeltaMode)
 DEFINE_ENUM_CONVERT(ARDOUR::DenormalModel)
+DEFINE_ENUM_CONVERT(ARDOUR::GraphSchedulingMode)
 DEFINE_ENUM_CONVERT(ARDOUR::FadeShape)
 DEFINE_ENUM_CONVERT(ARDOUR::SnapTarget)
 DEFINE_ENUM_CONVERT(ARDOUR::RegionSelectionAfterSplit)
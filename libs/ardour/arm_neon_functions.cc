@@ -515,4 +515,110 @@ arm_neon_copy_vector(
 	}
 }
 
+/**
+ * @brief 1-pole low-pass gain ramp
+ *
+ * Uses the closed form g[i] = target + (initial - target) * (1 - coeff)^i
+ * to process 4 samples in parallel.
+ *
+ * @param[in,out] dst Pointer to the buffer
+ * @param[in] nframes Number of frames in the buffer
+ * @param[in] initial Gain of the first sample
+ * @param[in] target Target gain
+ * @param[in] coeff Low-pass filter coefficient
+ * @return float Gain after the last sample
+ */
+C_FUNC float
+arm_neon_apply_gain_ramp(float* dst, uint32_t nframes, float initial, float target, float coeff)
+{
+	const float k = 1.f - coeff;
+
+	if (nframes >= 4) {
+		const float d  = initial - target;
+		const float dv[4] = { d, d * k, d * k * k, d * k * k * k };
+
+		float32x4_t vt = vdupq_n_f32(target);
+		float32x4_t vk = vdupq_n_f32(k * k * k * k);
+		float32x4_t vd = vld1q_f32(dv);
+
+		while (nframes >= 4) {
+			float32x4_t x0 = vld1q_f32(dst);
+			x0 = vmulq_f32(x0, vaddq_f32(vt, vd));
+			vst1q_f32(dst, x0);
+			vd = vmulq_f32(vd, vk);
+
+			dst += 4;
+			nframes -= 4;
+		}
+
+		initial = target + vgetq_lane_f32(vd, 0);
+	}
+
+	// Do the remaining samples
+	while (nframes > 0) {
+		*dst++ *= initial;
+		initial += coeff * (target - initial);
+		--nframes;
+	}
+
+	return initial;
+}
+
+/**
+ * @brief Apply a per-sample gain to a buffer
+ *
+ * @param[in,out] dst Pointer to the buffer
+ * @param[in] gain Pointer to the gain coefficients
+ * @param[in] nframes Number of frames in the buffer
+ */
+C_FUNC void
+arm_neon_apply_gain_vector_to_buffer(float* dst, const float* gain, uint32_t nframes)
+{
+	while (nframes >= 4) {
+		float32x4_t x0 = vld1q_f32(dst);
+		float32x4_t g0 = vld1q_f32(gain);
+		vst1q_f32(dst, vmulq_f32(x0, g0));
+
+		dst += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+
+	// Do the remaining samples
+	while (nframes > 0) {
+		*dst++ *= *gain++;
+		--nframes;
+	}
+}
+
+/**
+ * @brief Mix a source buffer into the destination buffer with a per-sample gain
+ *
+ * @param[in,out] dst Pointer to the destination buffer
+ * @param[in] src Pointer to the source buffer
+ * @param[in] gain Pointer to the gain coefficients
+ * @param[in] nframes Number of frames in the buffer
+ */
+C_FUNC void
+arm_neon_mix_buffers_with_gain_vector(float* dst, const float* src, const float* gain, uint32_t nframes)
+{
+	while (nframes >= 4) {
+		float32x4_t d0 = vld1q_f32(dst);
+		float32x4_t x0 = vld1q_f32(src);
+		float32x4_t g0 = vld1q_f32(gain);
+		vst1q_f32(dst, vmlaq_f32(d0, x0, g0));
+
+		dst += 4;
+		src += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+
+	// Do the remaining samples
+	while (nframes > 0) {
+		*dst++ += *src++ * *gain++;
+		--nframes;
+	}
+}
+
 #endif
@@ -103,6 +103,7 @@ AudioEngine::AudioEngine ()
 	, _hw_devicelist_update_thread(0)
 	, _start_cnt (0)
 	, _init_countdown (0)
+	, _offline_render_thread (0)
 #ifdef SILENCE_AFTER_SECONDS
 	, _silence_countdown (0)
 	, _silence_hit_cnt (0)
@@ -115,6 +116,7 @@ AudioEngine::AudioEngine ()
 	_hw_reset_request_count.store (0);
 	_pending_playback_latency_callback.store (0);
 	_pending_capture_latency_callback.store (0);
+	_offline_render.store (0);
 	_hw_devicelist_update_count.store (0);
 	_stop_hw_reset_processing.store (0);
 	_stop_hw_devicelist_processing.store (0);
@@ -233,6 +235,20 @@ __attribute__((annotate("realtime")))
 int
 AudioEngine::process_callback (pframes_t nframes)
 {
+	if (_offline_render.load () > 1) {
+		/* the backend is freewheeling, and offline_render_thread()
+		 * processes the session. Park the backend's process thread
+		 * until the export is complete, so that it does not touch
+		 * any port buffers (e.g. clear system inputs) meanwhile.
+		 */
+		int canderef (2);
+		_offline_render.compare_exchange_strong (canderef, 3);
+		while (_offline_render.load () > 1) {
+			Glib::usleep (1000);
+		}
+		return 0;
+	}
+
 	TimerRAII tr (dsp_stats[ProcessCallback]);
 	PBD::Mutex::Lock tm (_process_lock, PBD::Mutex::TryLock);
 	Port::set_varispeed_ratio (1.0);
@@ -1113,6 +1129,8 @@ AudioEngine::stop (bool for_latency)
 		return 0;
 	}
 
+	stop_offline_render ();
+
 	PBD::Mutex::Lock pl (_process_lock, PBD::Mutex::NotLock);
 
 	if (running()) {
@@ -1183,9 +1201,79 @@ AudioEngine::freewheel (bool start_stop)
 
 	/* _freewheeling will be set when first Freewheel signal occurs */
 
+	if (!start_stop) {
+		stop_offline_render ();
+	} else if (Config->get_export_offline () && !is_jack () && !Freewheel.empty ()) {
+		/* the thread is started by freewheel_callback(), once the
+		 * backend no longer processes the ports.
+		 */
+		_offline_render.store (1);
+	}
+
 	return _backend->freewheel (start_stop);
 }
 
+void
+AudioEngine::stop_offline_render ()
+{
+	if (_offline_render_thread) {
+		_offline_render.store (4);
+		_offline_render_thread->join ();
+		delete _offline_render_thread;
+		_offline_render_thread = 0;
+	}
+	_offline_render.store (0);
+}
+
+/** Freewheel, while the backend's process thread is parked. This runs the same cycles as
+ * the backend would, but does not wait for the backend or its (JACK)
+ * server in between.
+ */
+void
+AudioEngine::offline_render_thread ()
+{
+	pthread_t const process_thread = AsyncMIDIPort::get_process_thread ();
+
+	thread_init_callback (NULL);
+
+	_offline_render_thread_id = pthread_self ();
+
+	/* wait for the backend's process thread to be parked,
+	 * see process_callback()
+	 */
+	while (_offline_render.load () == 2) {
+		Glib::usleep (100);
+	}
+
+	pframes_t const nframes = _backend->buffer_size ();
+
+	while (_offline_render.load () == 3) {
+		if (Freewheel.empty ()) {
+			/* export is complete, wait for freewheel (false) */
+			Glib::usleep (1000);
+			continue;
+		}
+
+		PBD::Mutex::Lock tm (_process_lock);
+
+		Temporal::TempoMap::SharedPtr current_map = Temporal::TempoMap::read ();
+		if (current_map != Temporal::TempoMap::use()) {
+			Temporal::TempoMap::set (current_map);
+		}
+
+		InternalSend::CycleStart (nframes);
+		PortManager::cycle_start (nframes, _session);
+
+		Freewheel (nframes); /* EMIT SIGNAL */
+
+		PortManager::cycle_end (nframes, _session);
+
+		_processed_samples += nframes;
+	}
+
+	AsyncMIDIPort::set_process_thread (process_thread);
+}
+
 float
 AudioEngine::get_dsp_load() const
 {
@@ -1339,6 +1427,9 @@ AudioEngine::in_process_thread ()
 	if (!_backend) {
 		return false;
 	}
+	if (_offline_render.load () == 3 && pthread_equal (_offline_render_thread_id, pthread_self ())) {
+		return true;
+	}
 	return _backend->in_process_thread ();
 }
 
@@ -1456,6 +1547,9 @@ AudioEngine::freewheel_callback (bool onoff)
 	_freewheeling = onoff;
 	if (!_freewheeling) {
 		PortManager::reinit ();
+	} else if (_offline_render.load () == 1) {
+		_offline_render.store (2);
+		_offline_render_thread = PBD::Thread::create (std::bind (&AudioEngine::offline_render_thread, this), "ExportRender");
 	}
 }
 
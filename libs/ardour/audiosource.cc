@@ -51,7 +51,9 @@
 
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
+#include <glibmm/timer.h>
 
+#include "pbd/failed_constructor.h"
 #include "pbd/file_utils.h"
 #include "pbd/playback_buffer.h"
 #include "pbd/scoped_file_descriptor.h"
@@ -87,11 +89,13 @@ AudioSource::AudioSource (Session& s, const string& name)
 	, peak_leftover_size (0)
 	, peak_leftovers (0)
 	, peak_leftover_sample (0)
-	, _first_run (true)
-	, _last_scale (0.0)
-	, _last_map_off (0)
-	, _last_raw_map_length (0)
+	, _peak_map (new PeakMap)
+	, _peak_levels_ready (false)
 {
+	for (int l = 0; l <= n_peak_levels; ++l) {
+		_peak_level_fd[l]  = -1;
+		_peak_level_max[l] = 0;
+	}
 }
 
 AudioSource::AudioSource (Session& s, const XMLNode& node)
@@ -103,11 +107,14 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, peak_leftover_size (0)
 	, peak_leftovers (0)
 	, peak_leftover_sample (0)
-	, _first_run (true)
-	, _last_scale (0.0)
-	, _last_map_off (0)
-	, _last_raw_map_length (0)
+	, _peak_map (new PeakMap)
+	, _peak_levels_ready (false)
 {
+	for (int l = 0; l <= n_peak_levels; ++l) {
+		_peak_level_fd[l]  = -1;
+		_peak_level_max[l] = 0;
+	}
+
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
 	}
@@ -129,6 +136,8 @@ AudioSource::~AudioSource ()
 		_peakfile_fd = -1;
 	}
 
+	close_peak_levels ();
+
 	delete [] peak_leftovers;
 }
 
@@ -252,7 +261,15 @@ AudioSource::touch_peakfile ()
 	tbuf.actime = statbuf.st_atime;
 	tbuf.modtime = time ((time_t*) 0);
 
+	/* decimated levels identify the peak-file by its mtime, keep them valid */
+	bool const ready = _peak_levels_ready.exchange (false);
+	bool const levels_valid = peak_levels_valid ();
+
 	g_utime (_peakpath.c_str(), &tbuf);
+
+	if (levels_valid && stamp_peak_levels () == 0) {
+		_peak_levels_ready = ready;
+	}
 }
 
 int
@@ -269,6 +286,14 @@ AudioSource::rename_peakfile (string newpath)
 		}
 	}
 
+	/* decimated levels are rebuilt if missing */
+	for (int l = 1; l <= n_peak_levels; ++l) {
+		string const level_path = string_compose ("%1.%2", oldpath, l);
+		if (Glib::file_test (level_path, Glib::FILE_TEST_EXISTS)) {
+			g_rename (level_path.c_str(), string_compose ("%1.%2", newpath, l).c_str());
+		}
+	}
+
 	_peakpath = newpath;
 
 	return 0;
@@ -280,6 +305,13 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 	PBD::Mutex::Lock lm (_initialize_peaks_lock);
 	GStatBuf statbuf;
 
+	_peak_levels_ready = false;
+
+	{
+		PBD::Mutex::Lock lp (_peak_map_lock);
+		drop_peak_map (lp);
+	}
+
 	_peakpath = construct_peak_filepath (audio_path, in_session);
 
 	if (!empty() && !Glib::file_test (_peakpath.c_str(), Glib::FILE_TEST_EXISTS)) {
@@ -347,6 +379,13 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 
 	if (!empty() && !_peaks_built && _build_missing_peakfiles && _build_peakfiles) {
 		build_peaks_from_scratch ();
+	} else if (_peaks_built && Config->get_use_peak_levels ()) {
+		/* levels of a new peak-file are written along with it,
+		 * existing ones may be missing or outdated.
+		 */
+		if (peak_levels_valid () || build_peak_levels () == 0) {
+			_peak_levels_ready = true;
+		}
 	}
 
 	return 0;
@@ -380,7 +419,535 @@ AudioSource::write (Sample const * src, samplecnt_t cnt)
 int
 AudioSource::read_peaks (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const
 {
-	return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, _FPP);
+	samplecnt_t fpp = _FPP;
+
+	if (Config->get_use_peak_levels ()) {
+		/* use the coarsest level that still has at least one peak per visual peak */
+		for (int l = 0; l < n_peak_levels && (fpp << 2) <= samples_per_visual_peak; ++l) {
+			fpp <<= 2;
+		}
+	}
+
+	return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, fpp);
+}
+
+/** Peak data of a source, shared by concurrent readers.
+ *
+ * On POSIX systems the peak-file is mapped once, with room to grow
+ * (pages beyond the end of the file are never accessed). Data that is
+ * appended to the file is visible in the shared mapping. On Windows a
+ * mapped file cannot be resized, so the data is copied instead.
+ */
+struct AudioSource::PeakLevel
+{
+	class File {
+	public:
+		File (std::string const& path, off_t size);
+		~File ();
+
+		char const* data () const { return _addr; }
+		off_t capacity () const { return _capacity; }
+
+	private:
+		char* _addr;
+		off_t _capacity;
+	};
+
+	PeakLevel () : offset (0), size (0) {}
+
+	std::shared_ptr<File const> file;
+	off_t                       offset; // of peak data in the file
+	off_t                       size;   // of peak data
+
+	char const* data () const { return file->data () + offset; }
+};
+
+/** Level 0 is the peak-file, levels 1..n_peak_levels are decimated by
+ * a factor of 4 each.
+ */
+struct AudioSource::PeakMap
+{
+	PeakLevel level[n_peak_levels + 1];
+};
+
+AudioSource::PeakLevel::File::File (std::string const& path, off_t size)
+	: _addr (0)
+	, _capacity (size)
+{
+#ifdef PLATFORM_WINDOWS
+	int fd = g_open (path.c_str (), O_RDONLY | O_BINARY, 0444);
+#else
+	int fd = g_open (path.c_str (), O_RDONLY, 0444);
+#endif
+
+	if (fd < 0) {
+		throw failed_constructor ();
+	}
+
+#ifdef PLATFORM_WINDOWS
+	_addr = new char[size];
+	off_t n = 0;
+	while (n < size) {
+		int rv = ::read (fd, _addr + n, size - n);
+		if (rv <= 0) {
+			break;
+		}
+		n += rv;
+	}
+	::close (fd);
+	if (n != size) {
+		delete [] _addr;
+		throw failed_constructor ();
+	}
+#else
+	const off_t pagesize = sysconf (_SC_PAGESIZE);
+
+	_capacity = size + std::max<off_t> (size, 1048576);
+	_capacity = (_capacity + pagesize - 1) & ~(pagesize - 1);
+
+	void* addr = mmap (0, _capacity, PROT_READ, MAP_SHARED, fd, 0);
+	::close (fd);
+
+	if (addr == MAP_FAILED) {
+		error << string_compose (_("map failed - could not mmap peakfile %1."), path) << endmsg;
+		throw failed_constructor ();
+	}
+
+	_addr = (char*) addr;
+#endif
+}
+
+AudioSource::PeakLevel::File::~File ()
+{
+#ifdef PLATFORM_WINDOWS
+	delete [] _addr;
+#else
+	munmap (_addr, _capacity);
+#endif
+}
+
+/** Header of the decimated levels of a peak-file. Levels are only valid
+ * for the peak-file that they were built from, which is identified by
+ * its size and modification time.
+ */
+struct PeakLevelHeader
+{
+	char    magic[8];
+	int64_t base_size;
+	int64_t base_mtime;
+};
+
+static const char peak_level_magic[8] = { 'A', 'P', 'K', 'L', 'V', 'L', '0', '1' };
+
+/* a multiple of sizeof (PeakData), the peak data following it remains aligned */
+static const off_t peak_level_header_size = sizeof (PeakLevelHeader);
+
+/* peaks processed at a time when decimating, a multiple of 4 */
+static const off_t peak_level_chunk = 4096;
+
+static void
+make_level_header (PeakLevelHeader& h, GStatBuf const& base)
+{
+	memcpy (h.magic, peak_level_magic, sizeof (h.magic));
+	h.base_size  = base.st_size;
+	h.base_mtime = base.st_mtime;
+}
+
+static bool
+level_header_matches (PeakLevelHeader const& h, GStatBuf const& base)
+{
+	return memcmp (h.magic, peak_level_magic, sizeof (h.magic)) == 0 && h.base_size == (int64_t) base.st_size && h.base_mtime == (int64_t) base.st_mtime;
+}
+
+static int
+open_peak_level (std::string const& path, int flags)
+{
+#ifdef PLATFORM_WINDOWS
+	return g_open (path.c_str(), flags | O_BINARY, 0664);
+#else
+	return g_open (path.c_str(), flags, 0664);
+#endif
+}
+
+static bool
+read_at (int fd, void* buf, size_t len, off_t pos)
+{
+	return lseek (fd, pos, SEEK_SET) == pos && ::read (fd, buf, len) == (ssize_t) len;
+}
+
+static bool
+write_at (int fd, void const* buf, size_t len, off_t pos)
+{
+	return lseek (fd, pos, SEEK_SET) == pos && ::write (fd, buf, len) == (ssize_t) len;
+}
+
+std::string
+AudioSource::peak_level_path (int level) const
+{
+	if (level == 0) {
+		return _peakpath;
+	}
+	return string_compose ("%1.%2", _peakpath, level);
+}
+
+/** @return true if all decimated levels were built from the current peak-file */
+bool
+AudioSource::peak_levels_valid () const
+{
+	GStatBuf base;
+
+	if (g_stat (_peakpath.c_str(), &base) != 0) {
+		return false;
+	}
+
+	for (int l = 1; l <= n_peak_levels; ++l) {
+		PeakLevelHeader h;
+		int fd = open_peak_level (peak_level_path (l), O_RDONLY);
+		if (fd < 0) {
+			return false;
+		}
+		bool ok = read_at (fd, &h, sizeof (h), 0) && level_header_matches (h, base);
+		::close (fd);
+		if (!ok) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/** Mark all decimated levels as built from the current peak-file */
+int
+AudioSource::stamp_peak_levels () const
+{
+	GStatBuf base;
+
+	if (g_stat (_peakpath.c_str(), &base) != 0) {
+		return -1;
+	}
+
+	PeakLevelHeader h;
+	make_level_header (h, base);
+
+	for (int l = 1; l <= n_peak_levels; ++l) {
+		int fd = open_peak_level (peak_level_path (l), O_WRONLY);
+		if (fd < 0) {
+			return -1;
+		}
+		bool ok = write_at (fd, &h, sizeof (h), 0);
+		ok = ::close (fd) == 0 && ok;
+		if (!ok) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/** Return peak data of the given level, covering at least \p min_size
+ * bytes if the file is large enough. Lock-free unless the file needs to
+ * be (re)mapped.
+ *
+ * Decimated levels are never built here, they are not available until
+ * _peak_levels_ready is set.
+ */
+std::shared_ptr<AudioSource::PeakLevel const>
+AudioSource::peak_map (int level, off_t min_size) const
+{
+	std::shared_ptr<PeakMap const> pm = _peak_map.reader ();
+
+	if (pm->level[level].file && pm->level[level].size >= min_size) {
+		return std::shared_ptr<PeakLevel const> (pm, &pm->level[level]);
+	}
+
+	if (level > 0 && !_peak_levels_ready.load ()) {
+		return std::shared_ptr<PeakLevel const> (new PeakLevel);
+	}
+
+	PBD::Mutex::Lock lm (_peak_map_lock);
+
+	pm = _peak_map.reader ();
+
+	if (pm->level[level].file && pm->level[level].size >= min_size) {
+		return std::shared_ptr<PeakLevel const> (pm, &pm->level[level]);
+	}
+
+	std::string const path   = peak_level_path (level);
+	off_t const       offset = level > 0 ? peak_level_header_size : 0;
+	GStatBuf          statbuf;
+
+	if (g_stat (path.c_str(), &statbuf) != 0 || statbuf.st_size <= offset) {
+		return std::shared_ptr<PeakLevel const> (pm, &pm->level[level]);
+	}
+
+	if (pm->level[level].file && statbuf.st_size - offset <= pm->level[level].size) {
+		/* the file did not grow */
+		return std::shared_ptr<PeakLevel const> (pm, &pm->level[level]);
+	}
+
+	std::shared_ptr<PeakMap> npm = _peak_map.write_copy ();
+
+	PeakLevel& pl (npm->level[level]);
+
+	if (!pl.file || pl.file->capacity () < statbuf.st_size) {
+		try {
+			pl.file.reset (new PeakLevel::File (path, statbuf.st_size));
+		} catch (failed_constructor&) {
+			_peak_map.abort ();
+			return std::shared_ptr<PeakLevel const> (pm, &pm->level[level]);
+		}
+	}
+
+	if (level > 0) {
+		/* check the mapped file itself, it may have been replaced */
+		PeakLevelHeader h;
+		GStatBuf        base;
+		memcpy (&h, pl.file->data (), sizeof (h));
+		if (g_stat (_peakpath.c_str(), &base) != 0 || !level_header_matches (h, base)) {
+			DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peakfile level %1 is outdated\n", path));
+			_peak_levels_ready = false;
+			_peak_map.abort ();
+			return std::shared_ptr<PeakLevel const> (new PeakLevel);
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peakfile %1 mapped with size %2 capacity %3\n", path, statbuf.st_size, pl.file->capacity ()));
+
+	pl.offset = offset;
+	pl.size   = statbuf.st_size - offset;
+	_peak_map.update (npm);
+	_peak_map.flush ();
+
+	return std::shared_ptr<PeakLevel const> (npm, &npm->level[level]);
+}
+
+/** Release all mapped peak-files, and wait for concurrent readers to
+ * finish with them. The files must only be truncated while the lock is
+ * held, readers cannot map them again until then.
+ *
+ * Readers must not hold on to the map while waiting for _lock, nor
+ * while calling peak_map (), which may block on _peak_map_lock.
+ */
+void
+AudioSource::drop_peak_map (PBD::Mutex::Lock const&)
+{
+	std::vector<std::weak_ptr<PeakLevel::File const> > old_files;
+
+	{
+		std::shared_ptr<PeakMap const> pm = _peak_map.reader ();
+		for (int l = 0; l <= n_peak_levels; ++l) {
+			if (pm->level[l].file) {
+				old_files.push_back (pm->level[l].file);
+			}
+		}
+		if (old_files.empty ()) {
+			return;
+		}
+	}
+
+	std::shared_ptr<PeakMap> npm = _peak_map.write_copy ();
+	*npm = PeakMap ();
+	_peak_map.update (npm);
+	_peak_map.flush ();
+
+	for (auto const& f : old_files) {
+		while (!f.expired ()) {
+			Glib::usleep (100);
+		}
+	}
+}
+
+/* reduce groups of 4 peaks, \p dst may be the same as \p src */
+static size_t
+decimate_peaks (PeakData const* src, size_t n_src, PeakData* dst)
+{
+	size_t n = 0;
+	for (size_t i = 0; i < n_src; i += 4, ++n) {
+		PeakData p = src[i];
+		for (size_t k = i + 1; k < std::min (i + 4, n_src); ++k) {
+			p.max = max (p.max, src[k].max);
+			p.min = min (p.min, src[k].min);
+		}
+		dst[n] = p;
+	}
+	return n;
+}
+
+/** Build all decimated levels from the complete peak-file. Each level is
+ * written to a temporary file which replaces the previous one, so that
+ * current readers keep a valid mapping.
+ *
+ * This is called by initialize_peakfile (), in the thread that sets up
+ * the peak-file: a peak-building thread for sources whose peaks are set
+ * up asynchronously, otherwise the caller of setup_peakfile () (e.g. the
+ * GUI or import thread, like build_peaks_from_scratch ()). It is not
+ * called from read_peaks ().
+ */
+int
+AudioSource::build_peak_levels ()
+{
+	GStatBuf base;
+
+	if (g_stat (_peakpath.c_str(), &base) != 0) {
+		return -1;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Building peak levels for %1\n", _peakpath));
+
+	PeakLevelHeader h;
+	make_level_header (h, base);
+
+	std::unique_ptr<PeakData[]> buf (new PeakData[peak_level_chunk]);
+
+	for (int l = 1; l <= n_peak_levels; ++l) {
+		std::string const tmp = peak_level_path (l) + X_(".tmp");
+
+		int ifd = open_peak_level (peak_level_path (l - 1), O_RDONLY);
+		int ofd = open_peak_level (tmp, O_CREAT | O_TRUNC | O_WRONLY);
+
+		ssize_t rv = -1;
+
+		if (ifd >= 0 && ofd >= 0 && write_at (ofd, &h, sizeof (h), 0) && lseek (ifd, l > 1 ? peak_level_header_size : 0, SEEK_SET) >= 0) {
+			while ((rv = ::read (ifd, buf.get (), peak_level_chunk * sizeof (PeakData))) > 0) {
+				size_t  n   = decimate_peaks (buf.get (), rv / sizeof (PeakData), buf.get ());
+				ssize_t len = n * sizeof (PeakData);
+				if (::write (ofd, buf.get (), len) != len) {
+					rv = -1;
+					break;
+				}
+			}
+		}
+
+		if (ifd >= 0) {
+			::close (ifd);
+		}
+		if (ofd >= 0) {
+			::close (ofd);
+		}
+
+		if (rv < 0) {
+			error << string_compose (_("AudioSource: cannot write peak level %1 for \"%2\" (%3)"), l, _peakpath, strerror (errno)) << endmsg;
+			::g_unlink (tmp.c_str ());
+			return -1;
+		}
+
+		if (::g_rename (tmp.c_str (), peak_level_path (l).c_str ()) != 0) {
+			::g_unlink (tmp.c_str ());
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/** Start writing decimated levels along with the peak-file */
+void
+AudioSource::open_peak_levels ()
+{
+	if (!Config->get_use_peak_levels ()) {
+		return;
+	}
+
+	_peak_levels_ready = false;
+
+	{
+		/* the files are replaced, not truncated, so current readers
+		 * can keep using their mappings without being waited for.
+		 */
+		PBD::Mutex::Lock lm (_peak_map_lock);
+		std::shared_ptr<PeakMap> npm = _peak_map.write_copy ();
+		for (int l = 1; l <= n_peak_levels; ++l) {
+			npm->level[l] = PeakLevel ();
+		}
+		_peak_map.update (npm);
+		_peak_map.flush ();
+	}
+
+	if (!_peak_level_buf) {
+		_peak_level_buf.reset (new PeakData[peak_level_chunk]);
+	}
+
+	/* not valid for any peak-file until stamped, see done_with_peakfile_writes () */
+	PeakLevelHeader h;
+	memset (&h, 0, sizeof (h));
+
+	for (int l = 1; l <= n_peak_levels; ++l) {
+		std::string const path = peak_level_path (l);
+		::g_unlink (path.c_str ());
+		_peak_level_max[l] = 0;
+		_peak_level_fd[l]  = open_peak_level (path, O_CREAT | O_TRUNC | O_RDWR);
+		if (_peak_level_fd[l] < 0 || !write_at (_peak_level_fd[l], &h, sizeof (h), 0)) {
+			close_peak_levels ();
+			return;
+		}
+	}
+
+	/* when resuming writes, start from the existing peak data */
+	update_peak_levels (0, _peak_byte_max / sizeof (PeakData));
+}
+
+void
+AudioSource::close_peak_levels ()
+{
+	for (int l = 1; l <= n_peak_levels; ++l) {
+		if (-1 != _peak_level_fd[l]) {
+			::close (_peak_level_fd[l]);
+			_peak_level_fd[l] = -1;
+		}
+	}
+}
+
+/** Update the decimated levels after peaks [first_peak, first_peak + n_peaks)
+ * of the peak-file were written. This is called for every write of the
+ * peak-file (by the butler while capturing), and does not allocate.
+ */
+void
+AudioSource::update_peak_levels (off_t first_peak, off_t n_peaks)
+{
+	int   src_fd     = _peakfile_fd;
+	off_t src_offset = 0;
+	off_t src_valid  = _peak_byte_max / sizeof (PeakData);
+
+	for (int l = 1; l <= n_peak_levels && n_peaks > 0; ++l) {
+
+		if (-1 == _peak_level_fd[l]) {
+			return;
+		}
+
+		/* range of affected peaks of this level, and their source peaks */
+		off_t const first   = first_peak / 4;
+		off_t const src_end = std::min<off_t> (((first_peak + n_peaks - 1) / 4 + 1) * 4, src_valid);
+
+		if (src_end <= first * 4) {
+			return;
+		}
+
+		for (off_t s = first * 4; s < src_end; s += peak_level_chunk) {
+			off_t const n_src = std::min<off_t> (peak_level_chunk, src_end - s);
+
+			if (!read_at (src_fd, _peak_level_buf.get (), n_src * sizeof (PeakData), src_offset + s * sizeof (PeakData))) {
+				close_peak_levels ();
+				return;
+			}
+
+			size_t const n = decimate_peaks (_peak_level_buf.get (), n_src, _peak_level_buf.get ());
+
+			if (!write_at (_peak_level_fd[l], _peak_level_buf.get (), n * sizeof (PeakData), peak_level_header_size + (s / 4) * sizeof (PeakData))) {
+				close_peak_levels ();
+				return;
+			}
+		}
+
+		off_t const n = (src_end - first * 4 + 3) / 4;
+
+		_peak_level_max[l] = std::max<off_t> (_peak_level_max[l], first + n);
+
+		src_fd     = _peak_level_fd[l];
+		src_offset = peak_level_header_size;
+		src_valid  = _peak_level_max[l];
+		first_peak = first;
+		n_peaks    = n;
+	}
 }
 
 /** @param peaks Buffer to write peak data.
@@ -391,12 +958,16 @@ int
 AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt,
 				  double samples_per_visual_peak, samplecnt_t samples_per_file_peak) const
 {
-	WriterLock lm (_lock);
+	/* Peak data is read from the memory-mapped peak-file without
+	 * taking any locks. The source's _lock is only needed to read
+	 * audio data, if the peak-file does not cover the request.
+	 */
 
 #if 0 // DEBUG ONLY
 	/* Bypass peak-file cache, compute peaks using raw data from source */
 	DEBUG_TRACE (DEBUG::Peaks, string_compose ("RP: npeaks = %1 start = %2 cnt = %3 spp = %4 pf = %5\n", npeaks, start, cnt, samples_per_visual_peak, _peakpath));
 	{
+		WriterLock lm (_lock);
 		samplecnt_t scm = ceil (samples_per_visual_peak);
 		samplecnt_t peak = 0;
 
@@ -439,25 +1010,39 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 	PeakData::PeakDatum xmax;
 	PeakData::PeakDatum xmin;
 	int32_t to_read;
-#ifdef PLATFORM_WINDOWS
-	SYSTEM_INFO system_info;
-        GetSystemInfo (&system_info);
-	const int bufsize = system_info.dwAllocationGranularity;;
-#else
-	const int bufsize = sysconf(_SC_PAGESIZE);
-#endif
 	samplecnt_t read_npeaks = npeaks;
 	samplecnt_t zero_fill = 0;
 
-	GStatBuf statbuf;
+	/* decimated levels of the peak-file */
+	int level = 0;
+	while (level < n_peak_levels && ((samplecnt_t) _FPP << (2 * level)) < samples_per_file_peak) {
+		++level;
+	}
+	if (((samplecnt_t) _FPP << (2 * level)) != samples_per_file_peak) {
+		level = 0;
+	}
+
+	if (level > 0 && !_peak_levels_ready.load ()) {
+		/* levels are not (yet) available */
+		return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, _FPP);
+	}
 
 	expected_peaks = (cnt / (double) samples_per_file_peak);
-	if (g_stat (_peakpath.c_str(), &statbuf) != 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for size check (%2)"), _peakpath, strerror (errno)) << endmsg;
+
+	std::shared_ptr<PeakLevel const> pm = peak_map (level, 0);
+
+	if (!pm->file && level > 0) {
+		/* level is outdated */
+		pm.reset ();
+		return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, _FPP);
+	}
+
+	if (!pm->file) {
+		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), _peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
 
-	if (!_captured_for.empty()) {
+	if (!_captured_for.empty() && level == 0) {
 
 		/* _captured_for is only set after a capture pass is
 		 * complete. so we know that capturing is finished for this
@@ -469,28 +1054,28 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 
 		const off_t expected_file_size = (_length.samples() / (double) samples_per_file_peak) * sizeof (PeakData);
 
-		if (statbuf.st_size < expected_file_size) {
-			warning << string_compose (_("peak file %1 is truncated from %2 to %3"), _peakpath, expected_file_size, statbuf.st_size) << endmsg;
-			lm.release(); // build_peaks_from_scratch() takes _lock
+		if (pm->size < expected_file_size) {
+			/* release the current map before re-mapping, see drop_peak_map () */
+			pm.reset ();
+			pm = peak_map (level, expected_file_size);
+		}
+
+		if (pm->size < expected_file_size) {
+			warning << string_compose (_("peak file %1 is truncated from %2 to %3"), _peakpath, expected_file_size, pm->size) << endmsg;
+			pm.reset ();
 			const_cast<AudioSource*>(this)->build_peaks_from_scratch ();
-			lm.acquire ();
-			if (g_stat (_peakpath.c_str(), &statbuf) != 0) {
+			pm = peak_map (level, expected_file_size);
+			if (!pm->file) {
 				error << string_compose (_("Cannot open peakfile @ %1 for size check (%2) after rebuild"), _peakpath, strerror (errno)) << endmsg;
+				return -1;
 			}
-			if (statbuf.st_size < expected_file_size) {
+			if (pm->size < expected_file_size) {
 				fatal << "peak file is still truncated after rebuild" << endmsg;
 				abort (); /*NOTREACHED*/
 			}
 		}
 	}
 
-	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
-
-	if (sfd < 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), _peakpath, strerror (errno)) << endmsg;
-		return -1;
-	}
-
 	scale = npeaks/expected_peaks;
 
 
@@ -520,8 +1105,12 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		   both max and min peak values.
 		*/
 
+		pm.reset ();
+
 		std::unique_ptr<Sample[]> raw_staging(new Sample[cnt]);
 
+		WriterLock lm (_lock);
+
 		if (read_unlocked (raw_staging.get(), start, cnt) != cnt) {
 			error << _("cannot read sample data for unscaled peak computation") << endmsg;
 			return -1;
@@ -538,69 +1127,31 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 	if (scale == 1.0) {
 		off_t first_peak_byte = (start / samples_per_file_peak) * sizeof (PeakData);
 		size_t bytes_to_read = sizeof (PeakData) * read_npeaks;
-		/* open, read, close */
 
 		DEBUG_TRACE (DEBUG::Peaks, "DIRECT PEAKS\n");
 
-		off_t  map_off =  first_peak_byte;
-		off_t  read_map_off = map_off & ~(bufsize - 1);
-		off_t  map_delta = map_off - read_map_off;
-		size_t map_length = bytes_to_read + map_delta;
-
-		if (_first_run  || (_last_scale != samples_per_visual_peak) || (_last_map_off != map_off) || (_last_raw_map_length  < bytes_to_read)) {
-			peak_cache.reset (new PeakData[npeaks]);
-			char* addr;
-#ifdef PLATFORM_WINDOWS
-			HANDLE file_handle = (HANDLE) _get_osfhandle(int(sfd));
-			HANDLE map_handle;
-			LPVOID view_handle;
-			bool err_flag;
-
-			map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
-			if (map_handle == NULL) {
-				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
-			if (view_handle == NULL) {
-				error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			addr = (char*) view_handle;
-
-			memcpy ((void*)peak_cache.get(), (void*)(addr + map_delta), bytes_to_read);
+		if (pm->size < first_peak_byte + (off_t) bytes_to_read) {
+			pm.reset ();
+			pm = peak_map (level, first_peak_byte + bytes_to_read);
+		}
 
-			err_flag = UnmapViewOfFile (view_handle);
-			err_flag = CloseHandle(map_handle);
-			if(!err_flag) {
-				error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-#else
-			addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
-			if (addr ==  MAP_FAILED) {
-				error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
+		if (pm->size < first_peak_byte + (off_t) bytes_to_read) {
+			/* peak-file is incomplete (e.g. still recording), or was just dropped */
+			size_t avail = pm->size > first_peak_byte ? (pm->size - first_peak_byte) / sizeof (PeakData) : 0;
+			if (avail > 0) {
+				memcpy ((void*)peaks, (void*)(pm->data () + first_peak_byte), avail * sizeof (PeakData));
 			}
+			memset (&peaks[avail], 0, sizeof (PeakData) * (npeaks - avail));
+			return 0;
+		}
 
-			memcpy ((void*)peak_cache.get(), (void*)(addr + map_delta), bytes_to_read);
-			munmap (addr, map_length);
-#endif
-			if (zero_fill) {
-				assert (read_npeaks < npeaks);
-				memset (&peak_cache[read_npeaks], 0, sizeof (PeakData) * zero_fill);
-			}
+		memcpy ((void*)peaks, (void*)(pm->data () + first_peak_byte), bytes_to_read);
 
-			_first_run = false;
-			_last_scale = samples_per_visual_peak;
-			_last_map_off = map_off;
-			_last_raw_map_length = bytes_to_read;
+		if (zero_fill) {
+			assert (read_npeaks < npeaks);
+			memset (&peaks[read_npeaks], 0, sizeof (PeakData) * zero_fill);
 		}
 
-		memcpy ((void*)peaks, (void*)peak_cache.get(), npeaks * sizeof(PeakData));
-
 		return 0;
 	}
 
@@ -613,7 +1164,7 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		 * - more samples-per-peak (lower resolution) than the peakfile, or to put it another way,
 		 * - less peaks than the peakfile holds for the same range
 		 *
-		 * So, read a block into a staging area, and then downsample from there.
+		 * So, downsample directly from the mapped peak-file.
 		 *
 		 * to avoid confusion, I'll refer to the requested peaks as visual_peaks and the peakfile peaks as stored_peaks
 		 */
@@ -628,131 +1179,87 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		samplecnt_t nvisual_peaks = 0;
 		uint32_t i = 0;
 
-		/* open ... close during out: handling */
+		off_t map_off = (uint32_t) (current_stored_peak) * sizeof(PeakData);
 
-		off_t  map_off      =  (uint32_t) (current_stored_peak) * sizeof(PeakData);
-		off_t  read_map_off = map_off & ~(bufsize - 1);
-		off_t  map_delta    = map_off - read_map_off;
+		if (pm->size < map_off + (off_t) (expected_peaks * sizeof (PeakData))) {
+			pm.reset ();
+			pm = peak_map (level, map_off + expected_peaks * sizeof (PeakData));
+		}
 
-		samplecnt_t max_chunk = (statbuf.st_size - read_map_off - map_delta) / sizeof(PeakData);
+		samplecnt_t max_chunk = map_off < pm->size ? (pm->size - map_off) / sizeof(PeakData) : 0;
 
-		if (map_off > statbuf.st_size) {
+		if (map_off > pm->size) {
 			/* next_visual_peak is after peak-file end */
 			assert (npeaks == 1);
 			/* only process (next_visual_peak_sample - start), do not use peak-file */
 			max_chunk = 0;
-			map_delta = 0;
-			read_map_off = 0;
 		}
 		samplecnt_t chunksize = std::min<samplecnt_t> (expected_peaks, max_chunk);
 
-		size_t raw_map_length = chunksize * sizeof(PeakData);
-		size_t map_length     = raw_map_length + map_delta;
-
-		assert (read_map_off + (off_t)map_length <= statbuf.st_size);
-		assert (read_map_off + map_delta + (off_t)raw_map_length <= statbuf.st_size);
-
-		if (_first_run || (_last_scale != samples_per_visual_peak) || (_last_map_off != map_off) || (_last_raw_map_length < raw_map_length)) {
-
-			/* offset between requested start, and first peak-file peak */
-			samplecnt_t start_offset = next_visual_peak_sample - start;
+		/* offset between requested start, and first peak-file peak */
+		samplecnt_t start_offset = next_visual_peak_sample - start;
 
-			peak_cache.reset (new PeakData[npeaks]);
-			if (chunksize > 0) {
-				std::unique_ptr<PeakData[]> staging (new PeakData[chunksize]);
+		if (chunksize > 0) {
+			PeakData const* staging = reinterpret_cast<PeakData const*> (pm->data () + map_off);
 
-				char* addr;
-#ifdef PLATFORM_WINDOWS
-				HANDLE file_handle = (HANDLE) _get_osfhandle(int(sfd));
-				HANDLE map_handle;
-				LPVOID view_handle;
-				bool err_flag;
-
-				map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
-				if (map_handle == NULL) {
-					error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
-					return -1;
-				}
+			while (nvisual_peaks < read_npeaks) {
 
-				view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
-				if (view_handle == NULL) {
-					error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
-					return -1;
-				}
-
-				addr = (char *) view_handle;
+				xmax = -1.0;
+				xmin = 1.0;
 
-				memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
+				while ((current_stored_peak <= stored_peak_before_next_visual_peak) && (i < chunksize)) {
 
-				err_flag = UnmapViewOfFile (view_handle);
-				err_flag = CloseHandle(map_handle);
-				if(!err_flag) {
-					error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
-					return -1;
-				}
-#else
-				addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
-				if (addr ==  MAP_FAILED) {
-					error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
-					return -1;
+					xmax = max (xmax, staging[i].max);
+					xmin = min (xmin, staging[i].min);
+					++i;
+					++current_stored_peak;
 				}
 
-				memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
-				munmap (addr, map_length);
-#endif
-				while (nvisual_peaks < read_npeaks) {
+				peaks[nvisual_peaks].max = xmax;
+				peaks[nvisual_peaks].min = xmin;
+				++nvisual_peaks;
+				next_visual_peak_sample = min ((double) start + cnt, (next_visual_peak_sample + samples_per_visual_peak));
+				stored_peak_before_next_visual_peak = (uint32_t) next_visual_peak_sample / samples_per_file_peak;
+			}
+		} else {
+			memset (peaks, 0, sizeof (PeakData) * npeaks);
+		}
 
-					xmax = -1.0;
-					xmin = 1.0;
+		/* do not hold on to the map while reading audio data,
+		 * see drop_peak_map ()
+		 */
+		pm.reset ();
 
-					while ((current_stored_peak <= stored_peak_before_next_visual_peak) && (i < chunksize)) {
+		samplecnt_t last_sample_from_peakfile = current_stored_peak * samples_per_file_peak;
 
-						xmax = max (xmax, staging[i].max);
-						xmin = min (xmin, staging[i].min);
-						++i;
-						++current_stored_peak;
-					}
+		if (start_offset > 0 || (last_sample_from_peakfile < start + cnt && nvisual_peaks > 0)) {
 
-					peak_cache[nvisual_peaks].max = xmax;
-					peak_cache[nvisual_peaks].min = xmin;
-					++nvisual_peaks;
-					next_visual_peak_sample = min ((double) start + cnt, (next_visual_peak_sample + samples_per_visual_peak));
-					stored_peak_before_next_visual_peak = (uint32_t) next_visual_peak_sample / samples_per_file_peak;
-				}
-			}
+			WriterLock lm (_lock);
 
 			/* add data between start and sample corresponding to map_off */
 			if (start_offset > 0) {
 				std::unique_ptr<Sample[]> buf (new Sample[start_offset]);
 				samplecnt_t samples_read = read_unlocked (buf.get(), start, start_offset);
-				find_peaks (buf.get(), samples_read, &peak_cache[0].min, &peak_cache[0].max);
+				find_peaks (buf.get(), samples_read, &peaks[0].min, &peaks[0].max);
 			}
 
 			/* fix end, add data not covered by Peak File */
-			samplecnt_t last_sample_from_peakfile = current_stored_peak * samples_per_file_peak;
 			if (last_sample_from_peakfile < start + cnt && nvisual_peaks > 0) {
 				samplecnt_t to_read = start + cnt - last_sample_from_peakfile;
 				std::unique_ptr<Sample[]> buf (new Sample[to_read]);
 				samplecnt_t samples_read = read_unlocked (buf.get(), last_sample_from_peakfile, to_read);
-				find_peaks (buf.get(), samples_read, &peak_cache[nvisual_peaks - 1].min, &peak_cache[nvisual_peaks - 1].max);
+				find_peaks (buf.get(), samples_read, &peaks[nvisual_peaks - 1].min, &peaks[nvisual_peaks - 1].max);
 			}
+		}
 
-			if (zero_fill) {
-				assert (read_npeaks < npeaks);
+		if (zero_fill) {
+			assert (read_npeaks < npeaks);
 #ifndef NDEBUG
-				cerr << "Zero fill '" << _name << "' end of peaks (@ " << read_npeaks << " with " << zero_fill << ")" << endl;
+			cerr << "Zero fill '" << _name << "' end of peaks (@ " << read_npeaks << " with " << zero_fill << ")" << endl;
 #endif
-				memset (&peak_cache[read_npeaks], 0, sizeof (PeakData) * zero_fill);
-			}
-
-			_first_run = false;
-			_last_scale = samples_per_visual_peak;
-			_last_map_off = map_off;
-			_last_raw_map_length = raw_map_length;
+			memset (&peaks[read_npeaks], 0, sizeof (PeakData) * zero_fill);
 		}
 
-		memcpy ((void*)peaks, (void*)peak_cache.get(), npeaks * sizeof(PeakData));
-
 	} else {
 		DEBUG_TRACE (DEBUG::Peaks, "UPSAMPLE\n");
 
@@ -765,6 +1272,9 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		 * data on the fly.
 		*/
 
+		pm.reset ();
+		WriterLock lm (_lock);
+
 		samplecnt_t samples_read = 0;
 		samplepos_t current_sample = start;
 		samplecnt_t i = 0;
@@ -907,6 +1417,8 @@ AudioSource::build_peaks_from_scratch ()
   out:
 	if (ret) {
 		DEBUG_TRACE (DEBUG::Peaks, string_compose("Could not write peak data, attempting to remove peakfile %1\n", _peakpath));
+		PBD::Mutex::Lock lm (_peak_map_lock);
+		drop_peak_map (lm);
 		::g_unlink (_peakpath.c_str());
 	}
 
@@ -921,8 +1433,15 @@ AudioSource::close_peakfile ()
 		close (_peakfile_fd);
 		_peakfile_fd = -1;
 	}
+	close_peak_levels ();
+	_peak_levels_ready = false;
+	PBD::Mutex::Lock lm (_peak_map_lock);
+	drop_peak_map (lm);
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
+		for (int l = 1; l <= n_peak_levels; ++l) {
+			::g_unlink (peak_level_path (l).c_str());
+		}
 	}
 	_peaks_built = false;
 	return 0;
@@ -939,6 +1458,7 @@ AudioSource::prepare_for_peakfile_writes ()
 		error << string_compose(_("AudioSource: cannot open _peakpath (c) \"%1\" (%2)"), _peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
+	open_peak_levels ();
 	return 0;
 }
 
@@ -950,6 +1470,7 @@ AudioSource::done_with_peakfile_writes (bool done)
 			close (_peakfile_fd);
 			_peakfile_fd = -1;
 		}
+		close_peak_levels ();
 		return;
 	}
 
@@ -962,6 +1483,14 @@ AudioSource::done_with_peakfile_writes (bool done)
 		_peakfile_fd = -1;
 	}
 
+	bool const levels = -1 != _peak_level_fd[1];
+
+	close_peak_levels ();
+
+	if (done && levels && stamp_peak_levels () == 0) {
+		_peak_levels_ready = true;
+	}
+
 	if (done) {
 		PBD::Mutex::Lock lm (_peaks_ready_lock);
 		_peaks_built = true;
@@ -1028,6 +1557,10 @@ AudioSource::compute_and_write_peaks (Sample const * buf, samplecnt_t first_samp
 
 			_peak_byte_max = max (_peak_byte_max, (off_t) (byte + sizeof(PeakData)));
 
+			if (fpp == _FPP) {
+				update_peak_levels (byte / sizeof (PeakData), 1);
+			}
+
 			{
 				PBD::Mutex::Lock lm (_peaks_ready_lock);
 				PeakRangeReady (peak_leftover_sample, peak_leftover_cnt); /* EMIT SIGNAL */
@@ -1161,6 +1694,10 @@ AudioSource::compute_and_write_peaks (Sample const * buf, samplecnt_t first_samp
 
 	_peak_byte_max = max (_peak_byte_max, (off_t) (first_peak_byte + bytes_to_write));
 
+	if (fpp == _FPP) {
+		update_peak_levels (first_peak_byte / sizeof (PeakData), peaks_computed);
+	}
+
 	if (samples_done) {
 		PBD::Mutex::Lock lm (_peaks_ready_lock);
 		PeakRangeReady (first_sample, samples_done); /* EMIT SIGNAL */
@@ -1187,6 +1724,8 @@ AudioSource::truncate_peakfile ()
 
 	if (end > _peak_byte_max) {
 		DEBUG_TRACE(DEBUG::Peaks, string_compose ("Truncating Peakfile B %1 to %2\n", _peakpath, _peak_byte_max));
+		PBD::Mutex::Lock lm (_peak_map_lock);
+		drop_peak_map (lm);
 #ifdef COMPILER_MSVC
 		if (_chsize_s (_peakfile_fd, _peak_byte_max))
 #else
@@ -294,6 +294,7 @@ Butler::thread_work ()
 				continue;
 			}
 
+			/* refill the tracks with the least buffered data first */
 			tl->push_back ([tr, &disk_work_outstanding]() {
 				switch (tr->do_refill ()) {
 					case 0:
@@ -310,12 +311,21 @@ Butler::thread_work ()
 #endif
 						break;
 				}
-			});
+			}, 1.f - tr->playback_buffer_load ());
 		}
 
 		tl->process ();
 		tl.reset ();
 
+		if (DEBUG_ENABLED (DEBUG::Butler)) {
+			for (auto const& r : rl_with_auditioner) {
+				std::shared_ptr<Track> tr = std::dynamic_pointer_cast<Track> (r);
+				if (tr) {
+					DEBUG_TRACE (DEBUG::Butler, string_compose ("\trefill %1 took %2 usec, load %3\n", tr->name (), tr->last_refill_time (), tr->playback_buffer_load ()));
+				}
+			}
+		}
+
 		if (i != rl_with_auditioner.begin () && i != rl_with_auditioner.end ()) {
 			/* we didn't get to all the streams */
 			disk_work_outstanding = true;
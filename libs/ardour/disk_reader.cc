@@ -36,6 +36,7 @@
 #include "ardour/pannable.h"
 #include "ardour/playlist.h"
 #include "ardour/playlist_factory.h"
+#include "ardour/runtime_functions.h"
 #include "ardour/session.h"
 #include "ardour/session_playlists.h"
 
@@ -65,6 +66,8 @@ DiskReader::DiskReader (Session& s, Track& t, string const& str, Temporal::TimeD
 	, last_refill_loop_start (0)
 	, _midi_catchup (false)
 	, _need_midi_catchup (false)
+	, _refill_stats_reset (0)
+	, _last_refill_time (0)
 {
 	file_sample[DataType::AUDIO] = 0;
 	file_sample[DataType::MIDI]  = 0;
@@ -1155,8 +1158,30 @@ DiskReader::audio_read (Sample*            sum_buffer,
 int
 DiskReader::do_refill ()
 {
+	if (_refill_stats_reset.exchange (0)) {
+		_refill_stats.reset ();
+	}
+
 	const bool reversed = !_session.transport_will_roll_forwards ();
-	return refill (_sum_buffer, _mixdown_buffer, _gain_buffer, 0, reversed);
+
+	_refill_stats.start ();
+	int rv = refill (_sum_buffer, _mixdown_buffer, _gain_buffer, 0, reversed);
+	_refill_stats.update ();
+
+	_last_refill_time.store (_refill_stats.elapsed ());
+	return rv;
+}
+
+bool
+DiskReader::get_refill_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const
+{
+	return _refill_stats.get_stats (min, max, avg, dev);
+}
+
+void
+DiskReader::clear_refill_stats ()
+{
+	_refill_stats_reset.store (1);
 }
 
 int
@@ -1665,8 +1690,12 @@ DiskReader::dec_no_disk_output ()
 
 DiskReader::DeclickAmp::DeclickAmp (samplecnt_t sample_rate)
 {
-	_a = 800.f / (gain_t)sample_rate; // ~ 1/50Hz to fade by 40dB
-	_l = -log1p (_a);
+	/* ~ 1/50Hz to fade by 40dB, when updating the gain every 4 samples.
+	 * Use the equivalent per-sample coefficient 1 - (1 - a4)^(1/4) so that
+	 * the fade can be computed by the vectorized apply_gain_ramp().
+	 */
+	const float a4 = 800.f / (gain_t)sample_rate;
+	_a = 1.f - powf (1.f - a4, .25f);
 	_g = 0;
 }
 
@@ -1684,30 +1713,7 @@ DiskReader::DeclickAmp::apply_gain (AudioBuffer& buf, samplecnt_t n_samples, con
 		return;
 	}
 
-	const float   a      = _a;
-	Sample* const buffer = buf.data ();
-
-	const int max_nproc = 4;
-	uint32_t  remain    = n_samples;
-	uint32_t  offset    = buffer_offset;
-
-	while (remain > 0) {
-		uint32_t n_proc = remain > max_nproc ? max_nproc : remain;
-		for (uint32_t i = 0; i < n_proc; ++i) {
-			buffer[offset + i] *= g;
-		}
-#if 1
-		g += a * (target - g);
-#else /* accurate exponential fade */
-		if (n_proc == max_nproc) {
-			g += a * (target - g);
-		} else {
-			g = target - (target - g) * expf (_l * n_proc / max_nproc);
-		}
-#endif
-		remain -= n_proc;
-		offset += n_proc;
-	}
+	g = apply_gain_ramp (buf.data (buffer_offset), n_samples, g, target, _a);
 
 	if (fabsf (g - target) < GAIN_COEFF_DELTA) {
 		_g = target;
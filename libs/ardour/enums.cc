@@ -92,6 +92,7 @@ setup_enum_writer ()
 	PFLPosition _PFLPosition;
 	AFLPosition _AFLPosition;
 	DenormalModel _DenormalModel;
+	GraphSchedulingMode _GraphSchedulingMode;
 	ClockDeltaMode _ClockDeltaMode;
 	LayerModel _LayerModel;
 	InsertMergePolicy _InsertMergePolicy;
@@ -398,6 +399,10 @@ setup_enum_writer ()
 	REGISTER_ENUM (DenormalFTZDAZ);
 	REGISTER (_DenormalModel);
 
+	REGISTER_ENUM (GraphSharedQueue);
+	REGISTER_ENUM (GraphWorkStealing);
+	REGISTER (_GraphSchedulingMode);
+
 	/*
 	 * EditorOrdered has been deprecated
 	 * since the removal of independent
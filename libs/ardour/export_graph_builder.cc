@@ -49,6 +49,7 @@
 #include "audiographer/general/sr_converter.h"
 #include "audiographer/general/silence_trimmer.h"
 #include "audiographer/general/threader.h"
+#include "audiographer/general/tmp_mem.h"
 #include "audiographer/sndfile/tmp_file.h"
 #include "audiographer/sndfile/tmp_file_rt.h"
 #include "audiographer/sndfile/tmp_file_sync.h"
@@ -62,6 +63,7 @@
 #include "ardour/export_graph_builder.h"
 #include "ardour/export_timespan.h"
 #include "ardour/filesystem_paths.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session_directory.h"
 #include "ardour/session_metadata.h"
 #include "ardour/sndfile_helpers.h"
@@ -71,13 +73,16 @@ using namespace AudioGrapher;
 using std::string;
 
 /*
- * The Export Graph is evaluated for each Timespan.
+ * The Export Graph is evaluated for each Timespan. Timespans that
+ * overlap are rendered together; each ChannelConfig belongs to one
+ * Timespan and only receives data inside its range.
  *
  *  - The Graph has at least one ChannelConfig
  *  - Each ChannnelConfig has at least one SilenceHandler.
  *  - Each SilenceHandler feeds at least one SRC.
  *  - Each SRC feeds at least one Intermediate or one SFC
- *    Intermediates and SFC children are processed sequentally.
+ *    Intermediates are processed sequentally, several SFC children
+ *    are run in parallel (non-realtime export only).
  *  - Each Intermediate (tmp-file) runs SFC children in parallel.
  *  - Each SFC feeds at least one Encoder.
  *
@@ -112,7 +117,7 @@ using std::string;
  * |    |                                                 |
  * |    \---+------or-------+-------or-------\            |
  * |        v               v                v            |
- * |     Peak Reader -> Loudness Reader -> TMP File       |
+ * |     Peak Reader -> Loudness Reader -> TMP File/Mem   |
  * |                                         |            |
  * |                                         v            |
  * |               Threader (run SFC childs in parallel)  |
@@ -157,6 +162,7 @@ namespace ARDOUR {
 
 ExportGraphBuilder::ExportGraphBuilder (Session const & session)
 	: session (session)
+	, _tmp_mem_available (0)
 	, thread_pool (PBD::hardware_concurrency())
 {
 	process_buffer_samples = session.engine().samples_per_cycle();
@@ -167,7 +173,7 @@ ExportGraphBuilder::~ExportGraphBuilder ()
 }
 
 samplecnt_t
-ExportGraphBuilder::process (samplecnt_t samples, bool last_cycle)
+ExportGraphBuilder::process (samplepos_t position, samplecnt_t samples, bool last_cycle)
 {
 	assert(samples <= process_buffer_samples);
 
@@ -188,15 +194,30 @@ ExportGraphBuilder::process (samplecnt_t samples, bool last_cycle)
 		}
 
 		AudioBuffer const* ab = dynamic_cast<AudioBuffer const*> (buf);
-		MidiBuffer const*  mb;
-		if (ab) {
-			Sample const* process_buffer = ab->data ();
-			ConstProcessContext<Sample> context(&process_buffer[off], samples - off, 1);
-			if (last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
-			it->second->process (context);
-		}
-		if  ((mb = dynamic_cast<MidiBuffer const*> (buf))) {
-			it->second->process (*mb, off, samples - off, last_cycle);
+		MidiBuffer const*  mb = dynamic_cast<MidiBuffer const*> (buf);
+
+		/* Timespans that are rendered together only receive
+		 * the part of the cycle that is inside their range.
+		 */
+		for (auto const& ae : it->second) {
+			samplepos_t const ts_end = ae->timespan->get_end ();
+			samplepos_t const s = std::max (position, ae->timespan->get_start ());
+			samplepos_t const e = std::min (position + samples - off, ts_end);
+			if (s >= e) {
+				continue;
+			}
+			sampleoffset_t const o = off + s - position;
+			bool const ts_last_cycle = last_cycle || e == ts_end;
+
+			if (ab) {
+				Sample const* process_buffer = ab->data ();
+				ConstProcessContext<Sample> context(&process_buffer[o], e - s, 1);
+				if (ts_last_cycle) { context().set_flag (ProcessContext<Sample>::EndOfInput); }
+				ae->process (context);
+			}
+			if (mb) {
+				ae->process (*mb, o, e - s, ts_last_cycle);
+			}
 		}
 	}
 
@@ -238,6 +259,7 @@ ExportGraphBuilder::reset ()
 	_exported_files.clear();
 	_realtime = false;
 	_master_align = 0;
+	_tmp_mem_available = (size_t) Config->get_export_normalize_memory () * 1048576;
 }
 
 void
@@ -777,7 +799,7 @@ ExportGraphBuilder::SFC::operator== (FileSpec const& other_config) const
 	return id;
 }
 
-/* Intermediate (Normalizer, TmpFile) */
+/* Intermediate (Normalizer, TmpFile or TmpMem) */
 
 ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, FileSpec const & new_config, samplecnt_t max_samples)
 	: parent (parent)
@@ -800,23 +822,47 @@ ExportGraphBuilder::Intermediate::Intermediate (ExportGraphBuilder & parent, Fil
 	loudness_reader.reset (new LoudnessReader (config.format->sample_rate(), channels, max_samples));
 	threader.reset (new Threader<Sample> (parent.thread_pool));
 
-	int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
-
-	if (parent._realtime) {
-		tmp_file.reset (new TmpFileRt<float> (tmpfile_path_buf.data (), format, channels, config.format->sample_rate()));
+	/* Peak and loudness are analyzed while rendering. Unless exporting in
+	 * realtime (where the disk-thread of TmpFileRt triggers freewheeling
+	 * for the 2nd pass), the rendered data is kept in memory if it fits,
+	 * so normalizing and encoding does not need to re-read a temp file.
+	 */
+	samplecnt_t const session_rate = parent.session.nominal_sample_rate();
+	samplecnt_t const sb = config.format->silence_beginning_at (parent.timespan->get_start(), session_rate);
+	samplecnt_t const se = config.format->silence_end_at (parent.timespan->get_end(), session_rate);
+	samplecnt_t const duration = parent.timespan->get_length () + sb + se;
+	/* leave some headroom for SRC and rounding */
+	samplecnt_t const tmp_mem_samples = channels * (samplecnt_t) ceil (1.01 * duration * config.format->sample_rate () / (double) session_rate) + 2 * max_samples;
+	size_t const tmp_mem_bytes = tmp_mem_samples * sizeof (Sample);
+
+	if (!parent._realtime && tmp_mem_bytes <= parent._tmp_mem_available) {
+		parent._tmp_mem_available -= tmp_mem_bytes;
+		tmp_mem.reset (new TmpMem<float> (channels, tmp_mem_samples));
+		tmp_mem->Written.connect_same_thread (post_processing_connection,
+		                                      std::bind (&Intermediate::memory_written, this));
 	} else {
-		tmp_file.reset (new TmpFileSync<float> (tmpfile_path_buf.data (), format, channels, config.format->sample_rate()));
-	}
+		int format = ExportFormatBase::F_RAW | ExportFormatBase::SF_Float;
 
-	tmp_file->FileWritten.connect_same_thread (post_processing_connection,
-	                                           std::bind (&Intermediate::prepare_post_processing, this));
-	tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
-	                                           std::bind (&Intermediate::start_post_processing, this));
+		if (parent._realtime) {
+			tmp_file.reset (new TmpFileRt<float> (tmpfile_path_buf.data (), format, channels, config.format->sample_rate()));
+		} else {
+			tmp_file.reset (new TmpFileSync<float> (tmpfile_path_buf.data (), format, channels, config.format->sample_rate()));
+		}
+
+		tmp_file->FileWritten.connect_same_thread (post_processing_connection,
+		                                           std::bind (&Intermediate::prepare_post_processing, this));
+		tmp_file->FileFlushed.connect_same_thread (post_processing_connection,
+		                                           std::bind (&Intermediate::start_post_processing, this));
+	}
 
 	add_child (new_config);
 
 	peak_reader->add_output (loudness_reader);
-	loudness_reader->add_output (tmp_file);
+	if (tmp_mem) {
+		loudness_reader->add_output (tmp_mem);
+	} else {
+		loudness_reader->add_output (tmp_file);
+	}
 }
 
 ExportGraphBuilder::FloatSinkPtr
@@ -826,6 +872,8 @@ ExportGraphBuilder::Intermediate::sink ()
 		return peak_reader;
 	} else if (use_loudness) {
 		return loudness_reader;
+	} else if (tmp_mem) {
+		return tmp_mem;
 	} else {
 		return tmp_file;
 	}
@@ -868,17 +916,31 @@ ExportGraphBuilder::Intermediate::operator== (FileSpec const & other_config) con
 unsigned
 ExportGraphBuilder::Intermediate::get_postprocessing_cycle_count() const
 {
-	return static_cast<unsigned>(std::ceil(static_cast<float>(tmp_file->get_samples_written()) /
+	return static_cast<unsigned>(std::ceil(static_cast<float>(samples_written ()) /
 	                                       max_samples_out));
 }
 
+samplecnt_t
+ExportGraphBuilder::Intermediate::samples_written () const
+{
+	return tmp_mem ? tmp_mem->get_samples_written () : tmp_file->get_samples_written ();
+}
+
 bool
 ExportGraphBuilder::Intermediate::process()
 {
-	samplecnt_t samples_read = tmp_file->read (*buffer);
+	samplecnt_t samples_read = tmp_mem ? tmp_mem->read (*buffer) : tmp_file->read (*buffer);
 	return samples_read != buffer->samples();
 }
 
+void
+ExportGraphBuilder::Intermediate::memory_written ()
+{
+	/* there is no disk-thread to flush, continue immediately */
+	prepare_post_processing ();
+	start_post_processing ();
+}
+
 void
 ExportGraphBuilder::Intermediate::prepare_post_processing()
 {
@@ -891,7 +953,11 @@ ExportGraphBuilder::Intermediate::prepare_post_processing()
 		}
 	}
 
-	tmp_file->add_output (threader);
+	if (tmp_mem) {
+		tmp_mem->add_output (threader);
+	} else {
+		tmp_file->add_output (threader);
+	}
 	parent.intermediates.push_back (this);
 }
 
@@ -899,10 +965,14 @@ void
 ExportGraphBuilder::Intermediate::start_post_processing()
 {
 	for (std::list<SFC>::iterator i = children.begin(); i != children.end(); ++i) {
-		(*i).set_duration (tmp_file->get_samples_written() / config.channel_config->get_n_chans());
+		(*i).set_duration (samples_written () / config.channel_config->get_n_chans());
 	}
 
-	tmp_file->seek (0, SEEK_SET);
+	if (tmp_mem) {
+		tmp_mem->rewind ();
+	} else {
+		tmp_file->seek (0, SEEK_SET);
+	}
 
 	/* called in disk-thread when exporting in realtime,
 	 * to enable freewheeling for post-proc.
@@ -947,10 +1017,30 @@ void
 ExportGraphBuilder::SRC::add_child (FileSpec const & new_config)
 {
 	if (new_config.format->normalize() || parent._realtime) {
-		add_child_to_list (new_config, intermediate_children);
-	} else {
-		add_child_to_list (new_config, children);
+		add_child_to_list (new_config, intermediate_children, *converter);
+		return;
+	}
+
+	if (threader) {
+		add_child_to_list (new_config, children, *threader);
+		return;
+	}
+
+	add_child_to_list (new_config, children, *converter);
+
+	if (children.size () < 2) {
+		return;
+	}
+
+	/* more than one format: encode them in parallel.
+	 * (realtime export only has intermediate children)
+	 */
+	threader.reset (new Threader<Sample> (parent.thread_pool));
+	for (boost::ptr_list<SFC>::iterator it = children.begin(); it != children.end(); ++it) {
+		converter->remove_output (it->sink ());
+		threader->add_output (it->sink ());
 	}
+	converter->add_output (threader);
 }
 
 void
@@ -958,6 +1048,11 @@ ExportGraphBuilder::SRC::remove_children (bool remove_out_files)
 {
 	boost::ptr_list<SFC>::iterator sfc_iter = children.begin();
 
+	if (threader) {
+		converter->remove_output (threader);
+		threader->clear_outputs ();
+	}
+
 	while (sfc_iter != children.end() ) {
 		converter->remove_output (sfc_iter->sink() );
 		sfc_iter->remove_children (remove_out_files);
@@ -976,7 +1071,7 @@ ExportGraphBuilder::SRC::remove_children (bool remove_out_files)
 
 template<typename T>
 void
-ExportGraphBuilder::SRC::add_child_to_list (FileSpec const & new_config, boost::ptr_list<T> & list)
+ExportGraphBuilder::SRC::add_child_to_list (FileSpec const & new_config, boost::ptr_list<T> & list, AudioGrapher::Source<Sample> & source)
 {
 	for (typename boost::ptr_list<T>::iterator it = list.begin(); it != list.end(); ++it) {
 		if (*it == new_config) {
@@ -986,7 +1081,7 @@ ExportGraphBuilder::SRC::add_child_to_list (FileSpec const & new_config, boost::
 	}
 
 	list.push_back (new T (parent, new_config, max_samples_out));
-	converter->add_output (list.back().sink ());
+	source.add_output (list.back().sink ());
 }
 
 bool
@@ -1074,6 +1169,7 @@ ExportGraphBuilder::SilenceHandler::operator== (FileSpec const & other_config) c
 
 ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, FileSpec const & new_config, ChannelMap & channel_map)
 	: parent (parent)
+	, timespan (parent.timespan)
 {
 	typedef ExportChannelConfiguration::ChannelList ChannelList;
 
@@ -1096,22 +1192,28 @@ ExportGraphBuilder::ChannelConfig::ChannelConfig (ExportGraphBuilder & parent, F
 	unsigned chan = 0;
 	unsigned n_audio = 0;
 	for (ChannelList::const_iterator it = channel_list.begin(); it != channel_list.end(); ++it, ++chan) {
-		ChannelMap::iterator map_it = channel_map.find (*it);
-		if (map_it == channel_map.end()) {
-			std::pair<ChannelMap::iterator, bool> result_pair =
-				channel_map.insert (std::make_pair (*it, AnyExportPtr (new AnyExport ())));
-			assert (result_pair.second);
-			map_it = result_pair.first;
+		std::list<AnyExportPtr>& exports (channel_map[*it]);
+		AnyExportPtr ae;
+		for (auto const& e : exports) {
+			if (e->timespan == timespan) {
+				ae = e;
+				break;
+			}
+		}
+		if (!ae) {
+			ae.reset (new AnyExport ());
+			ae->timespan = timespan;
+			exports.push_back (ae);
 		}
 		if ((*it)->midi ()) {
 			config.filename->set_channel_config(config.channel_config);
 			std::string writer_filename = config.filename->get_path (ExportFormatSpecPtr ()) + ".mid";
-			map_it->second->midi.init (writer_filename, parent.timespan->get_start ());
+			ae->midi.init (writer_filename, timespan->get_start ());
 			parent.add_export_fn (writer_filename);
 		}
 		if ((*it)->audio ()) {
 			++n_audio;
-			map_it->second->add_output (interleaver->input (chan));
+			ae->add_output (interleaver->input (chan));
 		}
 	}
 
@@ -1155,7 +1257,7 @@ ExportGraphBuilder::ChannelConfig::remove_children (bool remove_out_files)
 bool
 ExportGraphBuilder::ChannelConfig::operator== (FileSpec const & other_config) const
 {
-	return config.channel_config == other_config.channel_config;
+	return config.channel_config == other_config.channel_config && timespan == parent.timespan;
 }
 
 } // namespace ARDOUR
@@ -40,6 +40,7 @@
 #include "ardour/export_status.h"
 #include "ardour/export_format_specification.h"
 #include "ardour/export_filename.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/soundcloud_upload.h"
 #include "ardour/surround_return.h"
 #include "ardour/system_exec.h"
@@ -112,12 +113,19 @@ ExportElementFactory::add_filename_copy (ExportFilenamePtr other)
 
 /*** ExportHandler ***/
 
+struct TimespanSortByStart {
+	bool operator() (ExportTimespanPtr a, ExportTimespanPtr b) {
+		return *a < *b;
+	}
+};
+
 ExportHandler::ExportHandler (Session & session)
   : ExportElementFactory (session)
   , session (session)
   , graph_builder (new ExportGraphBuilder (session))
   , export_status (session.get_export_status ())
   , post_processing (false)
+  , render_end (0)
   , cue_tracknum (0)
   , cue_indexnum (0)
 {
@@ -247,36 +255,85 @@ ExportHandler::start_timespan ()
 
 	export_status->timespan++;
 
-	/* finish_timespan pops the config_map entry that has been done, so
-	   this is the timespan to do this time
-	*/
+	/* finish_timespan pops the config_map entries that have been done,
+	 * continue with the earliest remaining timespan.
+	 */
 	current_timespan = config_map.begin()->first;
+	for (ConfigMap::iterator it = config_map.begin(); it != config_map.end(); it = config_map.upper_bound (it->first)) {
+		if (*it->first < *current_timespan) {
+			current_timespan = it->first;
+		}
+	}
+
+	render_timespans.clear ();
+	render_timespans.push_back (current_timespan);
+	render_end = current_timespan->get_end ();
+
+	/* Render timespans that overlap with it, or follow closely, in the same
+	 * pass. Each restart costs at least the export pre-roll, so rendering a
+	 * gap up to that length is cheaper than stopping and re-locating.
+	 */
+	if (can_share_render (current_timespan)) {
+		std::vector<ExportTimespanPtr> candidates;
+		for (ConfigMap::iterator it = config_map.begin(); it != config_map.end(); it = config_map.upper_bound (it->first)) {
+			if (it->first != current_timespan && can_share_render (it->first)) {
+				candidates.push_back (it->first);
+			}
+		}
+		std::sort (candidates.begin (), candidates.end (), TimespanSortByStart ());
+
+		samplecnt_t const max_gap = Config->get_export_preroll () * session.nominal_sample_rate ();
+		for (auto const& ts : candidates) {
+			if (ts->get_start () > render_end + max_gap) {
+				break;
+			}
+			render_timespans.push_back (ts);
+			render_end = std::max (render_end, ts->get_end ());
+		}
+	}
 
-	export_status->total_samples_current_timespan = current_timespan->get_length();
+	export_status->total_samples_current_timespan = render_end - current_timespan->get_start ();
 	export_status->timespan_name = current_timespan->name();
 	export_status->processed_samples_current_timespan = 0;
 
+	if (render_timespans.size () > 1) {
+		/* overlaps are rendered once, gaps are rendered, too */
+		samplecnt_t total = 0;
+		for (auto const& ts : render_timespans) {
+			total += ts->get_length ();
+		}
+		export_status->total_samples += export_status->total_samples_current_timespan - total;
+		export_status->timespan += render_timespans.size () - 1;
+	}
+
 	/* Register file configurations to graph builder */
 
-	/* Here's the config_map entries that use this timespan */
-	timespan_bounds = config_map.equal_range (current_timespan);
 	graph_builder->reset ();
-	graph_builder->set_current_timespan (current_timespan);
-	handle_duplicate_format_extensions();
 	bool realtime = current_timespan->realtime ();
 	bool region_export = true;
-	for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
-		// Filenames can be shared across timespans
-		FileSpec & spec = it->second;
-		spec.filename->set_timespan (it->first);
-		switch (spec.channel_config->region_processing_type ()) {
-			case RegionExportChannelFactory::None:
-				region_export = false;
-				break;
-			default:
-				break;
+	for (auto const& ts : render_timespans) {
+		/* Here's the config_map entries that use this timespan */
+		timespan_bounds = config_map.equal_range (ts);
+		graph_builder->set_current_timespan (ts);
+		handle_duplicate_format_extensions();
+		for (ConfigMap::iterator it = timespan_bounds.first; it != timespan_bounds.second; ++it) {
+			FileSpec & spec = it->second;
+			if (render_timespans.size () > 1) {
+				/* Filenames can be shared across timespans, but these are
+				 * written concurrently.
+				 */
+				spec.filename.reset (new ExportFilename (*spec.filename));
+			}
+			spec.filename->set_timespan (it->first);
+			switch (spec.channel_config->region_processing_type ()) {
+				case RegionExportChannelFactory::None:
+					region_export = false;
+					break;
+				default:
+					break;
+			}
+			graph_builder->add_config (spec, realtime);
 		}
-		graph_builder->add_config (spec, realtime);
 	}
 
 	// ExportDialog::update_realtime_selection does not allow this
@@ -296,6 +353,23 @@ ExportHandler::start_timespan ()
 	return session.start_audio_export (process_position, realtime, region_export);
 }
 
+bool
+ExportHandler::can_share_render (ExportTimespanPtr timespan) const
+{
+	if (timespan->realtime () || !timespan->vapor ().empty ()) {
+		return false;
+	}
+
+	ConfigMap::const_iterator it = config_map.lower_bound (timespan);
+	ConfigMap::const_iterator end = config_map.upper_bound (timespan);
+	for (; it != end; ++it) {
+		if (it->second.channel_config->region_processing_type () != RegionExportChannelFactory::None) {
+			return false;
+		}
+	}
+	return true;
+}
+
 void
 ExportHandler::handle_duplicate_format_extensions()
 {
@@ -358,7 +432,7 @@ ExportHandler::process_timespan (samplecnt_t samples)
 	/* update position */
 
 	samplecnt_t samples_to_read = 0;
-	samplepos_t const end = current_timespan->get_end();
+	samplepos_t const end = render_end;
 
 	if (process_position >= end) {
 		/* export complete, post-roll to feed and flush latent plugins
@@ -390,7 +464,7 @@ ExportHandler::process_timespan (samplecnt_t samples)
 	}
 
 	/* Do actual processing */
-	samplecnt_t ret = graph_builder->process (samples_to_read, last_cycle);
+	samplecnt_t ret = graph_builder->process (process_position, samples_to_read, last_cycle);
 	if (ret > 0) {
 		process_position += ret;
 		export_status->processed_samples += ret;
@@ -435,28 +509,50 @@ ExportHandler::finish_timespan ()
 
 	graph_builder->get_analysis_results (export_status->result_map);
 
+	/* the graph is reset below, before tagging files */
+	std::vector<std::vector<std::string> > exported_files;
+	for (auto const& ts : render_timespans) {
+		exported_files.push_back (graph_builder->exported_files (ts));
+	}
+
+	for (size_t i = 0; i < render_timespans.size (); ++i) {
+		current_timespan = render_timespans[i];
+		timespan_bounds = config_map.equal_range (current_timespan);
+		finish_timespan_files (exported_files[i]);
+	}
+
+	/* finish timespan is called in freewheeling rt-context,
+	 * we cannot start a new export from here */
+	assert (AudioEngine::instance()->freewheeling ());
+	timespan_thread_wakeup ();
+}
+
+void
+ExportHandler::finish_timespan_files (std::vector<std::string> const& exported_files)
+{
 	/* work-around: split-channel will produce several files
 	 * for a single config, config_map iterator below does not yet
 	 * take that into account.
 	 */
-	for (auto const& f : graph_builder->exported_files ()) {
-		Session::Exported (current_timespan->name(), f, config_map.begin()->second.format->reimport(), current_timespan->get_start ()); /* EMIT SIGNAL */
+	for (auto const& f : exported_files) {
+		Session::Exported (current_timespan->name(), f, timespan_bounds.first->second.format->reimport(), current_timespan->get_start ()); /* EMIT SIGNAL */
 	}
 
-	while (config_map.begin() != timespan_bounds.second) {
+	ConfigMap::iterator it = timespan_bounds.first;
+	while (it != timespan_bounds.second) {
 
 		// XXX single timespan+format may produce multiple files
 		// e.g export selection == session
 		// -> TagLib::FileRef is null
 
-		FileSpec& config = config_map.begin()->second;
+		FileSpec& config = it->second;
 		ExportFormatSpecPtr fmt = config.format;
 		config.filename->set_channel_config (config.channel_config);
 		std::string filename = config.filename->get_path (fmt);
 
 		if (fmt->type () == ExportFormatBase::T_None) {
 			graph_builder->reset ();
-			config_map.erase (config_map.begin());
+			it = config_map.erase (it);
 			continue;
 		}
 
@@ -575,13 +671,8 @@ ExportHandler::finish_timespan ()
 			}
 			delete soundcloud_uploader;
 		}
-		config_map.erase (config_map.begin());
+		it = config_map.erase (it);
 	}
-
-	/* finish timespan is called in freewheeling rt-context,
-	 * we cannot start a new export from here */
-	assert (AudioEngine::instance()->freewheeling ());
-	timespan_thread_wakeup ();
 }
 
 void
@@ -19,6 +19,8 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "pbd/microseconds.h"
+
 #include "ardour/export_status.h"
 
 namespace ARDOUR
@@ -52,6 +54,18 @@ ExportStatus::init ()
 	total_postprocessing_cycles = 0;
 	current_postprocessing_cycle = 0;
 	result_map.clear();
+
+	_start_time = PBD::get_microseconds ();
+}
+
+double
+ExportStatus::realtime_factor (samplecnt_t sample_rate) const
+{
+	int64_t const elapsed = PBD::get_microseconds () - _start_time;
+	if (elapsed <= 0 || sample_rate <= 0) {
+		return 0;
+	}
+	return (processed_samples / (double) sample_rate) / (elapsed / 1e6);
 }
 
 void
@@ -160,6 +160,10 @@ mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain   = 0;
 copy_vector_t           ARDOUR::copy_vector           = 0;
 
+apply_gain_ramp_t              ARDOUR::apply_gain_ramp              = 0;
+apply_gain_vector_to_buffer_t  ARDOUR::apply_gain_vector_to_buffer  = 0;
+mix_buffers_with_gain_vector_t ARDOUR::mix_buffers_with_gain_vector = 0;
+
 PBD::Signal<void(std::string)>                    ARDOUR::BootMessage;
 PBD::Signal<void(std::string, std::string, bool)> ARDOUR::PluginScanMessage;
 PBD::Signal<void(int)>                            ARDOUR::PluginScanTimeout;
@@ -214,6 +218,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_avx512f_mix_buffers_no_gain;
 			copy_vector           = x86_avx512f_copy_vector;
 
+			apply_gain_ramp              = x86_avx512f_apply_gain_ramp;
+			apply_gain_vector_to_buffer  = x86_avx512f_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = x86_avx512f_mix_buffers_with_gain_vector;
+
 			generic_mix_functions = false;
 
 		} else
@@ -231,6 +239,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+			apply_gain_ramp              = x86_avx_apply_gain_ramp;
+			apply_gain_vector_to_buffer  = x86_avx_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = x86_fma_mix_buffers_with_gain_vector;
+
 			generic_mix_functions = false;
 
 		} else
@@ -246,6 +258,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+			apply_gain_ramp              = x86_avx_apply_gain_ramp;
+			apply_gain_vector_to_buffer  = x86_avx_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = x86_avx_mix_buffers_with_gain_vector;
+
 			generic_mix_functions = false;
 
 		} else if (fpu->has_sse ()) {
@@ -259,6 +275,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_ramp              = x86_sse_apply_gain_ramp;
+			apply_gain_vector_to_buffer  = x86_sse_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+
 			generic_mix_functions = false;
 		}
 
@@ -274,6 +294,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 			copy_vector           = arm_neon_copy_vector;
 
+			apply_gain_ramp              = arm_neon_apply_gain_ramp;
+			apply_gain_vector_to_buffer  = arm_neon_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = arm_neon_mix_buffers_with_gain_vector;
+
 			generic_mix_functions = false;
 		}
 
@@ -287,6 +311,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_ramp              = default_apply_gain_ramp;
+			apply_gain_vector_to_buffer  = veclib_apply_gain_vector_to_buffer;
+			mix_buffers_with_gain_vector = veclib_mix_buffers_with_gain_vector;
+
 			generic_mix_functions = false;
 
 			info << "Apple VecLib H/W specific optimizations in use" << endmsg;
@@ -306,6 +334,10 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
 
+		apply_gain_ramp              = default_apply_gain_ramp;
+		apply_gain_vector_to_buffer  = default_apply_gain_vector_to_buffer;
+		mix_buffers_with_gain_vector = default_mix_buffers_with_gain_vector;
+
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
 
@@ -1076,6 +1108,7 @@ ARDOUR::reset_performance_meters (Session *session)
 		for (size_t n = 0; n < Session::NTT; ++n) {
 			session->dsp_stats[n].queue_reset ();
 		}
+		session->reset_process_graph_thread_stats ();
 	}
 	for (size_t n = 0; n < AudioEngine::NTT; ++n) {
 		AudioEngine::instance()->dsp_stats[n].queue_reset ();
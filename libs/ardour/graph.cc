@@ -24,7 +24,9 @@
 #include <stdio.h>
 
 #include "pbd/compose.h"
+#include "pbd/cpus.h"
 #include "pbd/debug_rt_alloc.h"
+#include "pbd/microseconds.h"
 #include "pbd/pthread_utils.h"
 
 #include "temporal/superclock.h"
@@ -35,6 +37,7 @@
 #include "ardour/graph.h"
 #include "ardour/io_plug.h"
 #include "ardour/process_thread.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/route.h"
 #include "ardour/rt_task.h"
 #include "ardour/rt_tasklist.h"
@@ -47,6 +50,9 @@ using namespace ARDOUR;
 using namespace PBD;
 using namespace std;
 
+/* index into Graph::_thread_state, -1 for threads that are not graph process threads */
+static thread_local int32_t graph_thread_id = -1;
+
 #ifdef DEBUG_RT_ALLOC
 static Graph* graph = 0;
 
@@ -62,6 +68,9 @@ alloc_allowed ()
 
 Graph::Graph (Session& session)
 	: SessionHandleRef (session)
+	, _thread_state (0)
+	, _max_threads (0)
+	, _work_stealing (false)
 	, _execution_sem ("graph_execution", 0)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
@@ -73,9 +82,20 @@ Graph::Graph (Session& session)
 	_n_workers.store (0);
 	_idle_thread_cnt.store (0);
 	_trigger_queue_size.store (0);
+	_stats_reset.store (0);
+
+	/* how_many_dsp_threads () never exceeds this */
+	_max_threads  = std::max<uint32_t> (2, hardware_concurrency ());
+	_thread_state = new ThreadState[_max_threads];
 
 	/* pre-allocate memory */
-	_trigger_queue.reserve (1024);
+	for (uint32_t l = 0; l < n_priority_levels; ++l) {
+		_trigger_queue[l].reserve (1024);
+	}
+	for (uint32_t i = 0; i < _max_threads; ++i) {
+		_thread_state[i].deque.reserve (1024);
+		_thread_state[i].reset_stats ();
+	}
 
 	ARDOUR::AudioEngine::instance ()->Running.connect_same_thread (engine_connections, std::bind (&Graph::reset_thread_list, this));
 	ARDOUR::AudioEngine::instance ()->Stopped.connect_same_thread (engine_connections, std::bind (&Graph::engine_stopped, this));
@@ -89,6 +109,11 @@ Graph::Graph (Session& session)
 #endif
 }
 
+Graph::~Graph ()
+{
+	delete[] _thread_state;
+}
+
 void
 Graph::engine_stopped ()
 {
@@ -104,7 +129,7 @@ Graph::engine_stopped ()
 void
 Graph::reset_thread_list ()
 {
-	uint32_t num_threads = how_many_dsp_threads ();
+	uint32_t num_threads = std::min (how_many_dsp_threads (), _max_threads);
 	uint32_t n_workers   = _n_workers.load();
 
 	/* don't bother doing anything here if we already have the right
@@ -152,7 +177,12 @@ Graph::session_going_away ()
 
 	/* now drop all references on the nodes. */
 	_trigger_queue_size.store (0);
-	_trigger_queue.clear ();
+	for (uint32_t l = 0; l < n_priority_levels; ++l) {
+		_trigger_queue[l].clear ();
+	}
+	for (uint32_t i = 0; i < _max_threads; ++i) {
+		_thread_state[i].deque.clear ();
+	}
 	_graph_chain = 0;
 }
 
@@ -214,8 +244,37 @@ Graph::prep ()
 	assert (_trigger_queue_size.load() == 0);
 	assert (_graph_empty != (_graph_chain->_n_terminal_nodes > 0));
 
-	if (_trigger_queue.capacity () < _graph_chain->_nodes_rt.size ()) {
-		_trigger_queue.reserve (_graph_chain->_nodes_rt.size ());
+	for (uint32_t l = 0; l < n_priority_levels; ++l) {
+		if (_trigger_queue[l].capacity () < _graph_chain->_nodes_rt.size ()) {
+			_trigger_queue[l].reserve (_graph_chain->_nodes_rt.size ());
+		}
+	}
+
+	/* Periodically re-evaluate the critical path, using the
+	 * measured DSP load of each node.
+	 */
+	if (_graph_chain->_prio_update_cnt++ % 64 == 0) {
+		_graph_chain->update_priorities (n_priority_levels);
+	}
+
+	/* All other threads are idle, it is safe to switch scheduler
+	 * and to resize the per-thread deques.
+	 */
+	_work_stealing = Config->get_graph_scheduling_mode () == GraphWorkStealing;
+
+	if (_work_stealing) {
+		uint32_t n_threads = 1 + _n_workers.load ();
+		for (uint32_t i = 0; i < n_threads; ++i) {
+			if (_thread_state[i].deque.capacity () < _graph_chain->_nodes_rt.size ()) {
+				_thread_state[i].deque.reserve (_graph_chain->_nodes_rt.size ());
+			}
+		}
+	}
+
+	if (_stats_reset.exchange (0)) {
+		for (uint32_t i = 0; i < _max_threads; ++i) {
+			_thread_state[i].reset_stats ();
+		}
 	}
 
 	_terminal_refcnt.store (_graph_chain->_n_terminal_nodes);
@@ -223,7 +282,7 @@ Graph::prep ()
 	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
 	for (auto const& i : _graph_chain->_init_trigger_list) {
 		_trigger_queue_size.fetch_add (1);
-		_trigger_queue.push_back (i.get ());
+		push_shared (i.get ());
 	}
 }
 
@@ -231,7 +290,96 @@ void
 Graph::trigger (ProcessNode* n)
 {
 	_trigger_queue_size.fetch_add (1);
-	_trigger_queue.push_back (n);
+
+	/* When work-stealing, a thread keeps the nodes that it unlocks,
+	 * idle threads can steal them. Fall back to the shared queue
+	 * if this is not a graph thread, or the deque is full.
+	 * Nodes on the critical path are always shared, so that
+	 * any idle thread can pick them up immediately.
+	 */
+	int32_t tid = graph_thread_id;
+	if (_work_stealing && tid >= 0 && n->priority () + 1 < n_priority_levels && _thread_state[tid].deque.push_back (n)) {
+		return;
+	}
+	push_shared (n);
+}
+
+void
+Graph::push_shared (ProcessNode* n)
+{
+	assert (n->priority () < n_priority_levels);
+	_trigger_queue[n->priority ()].push_back (n);
+}
+
+/** Take a node from the shared queues, highest priority first */
+bool
+Graph::pop_shared (ProcessNode*& to_run, uint32_t min_priority)
+{
+	for (uint32_t l = n_priority_levels; l > min_priority; --l) {
+		if (_trigger_queue[l - 1].pop_front (to_run)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/** Find a node to process.
+ *
+ * The shared queues are used for initial nodes of the graph, RTTasks
+ * and nodes on the critical path. When work-stealing, critical nodes
+ * are processed first, then the thread's own deque is checked (most
+ * recently triggered node), then the remaining shared queues, and
+ * lastly other threads' deques.
+ */
+bool
+Graph::pop_node (ProcessNode*& to_run)
+{
+	int32_t tid = graph_thread_id;
+
+	if (tid < 0) {
+		return pop_shared (to_run, 0);
+	}
+
+	ThreadState& ts (_thread_state[tid]);
+
+	if (!_work_stealing) {
+		if (pop_shared (to_run, 0)) {
+			ts.n_shared.fetch_add (1, std::memory_order_relaxed);
+			return true;
+		}
+		ts.n_miss.fetch_add (1, std::memory_order_relaxed);
+		return false;
+	}
+
+	if (pop_shared (to_run, n_priority_levels - 1)) {
+		ts.n_shared.fetch_add (1, std::memory_order_relaxed);
+		return true;
+	}
+
+	if (ts.deque.pop_back (to_run)) {
+		ts.n_local.fetch_add (1, std::memory_order_relaxed);
+		return true;
+	}
+
+	if (pop_shared (to_run, 0)) {
+		ts.n_shared.fetch_add (1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/* steal from other threads, start with the next one
+	 * to spread the load
+	 */
+	uint32_t n_threads = 1 + _n_workers.load ();
+	for (uint32_t i = 1; i < n_threads; ++i) {
+		if (_thread_state[(tid + i) % n_threads].deque.steal (to_run)) {
+			DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 stole work from thread %2\n", pthread_name (), (tid + i) % n_threads));
+			ts.n_stolen.fetch_add (1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	ts.n_miss.fetch_add (1, std::memory_order_relaxed);
+	return false;
 }
 
 /** Called when a node at the `output' end of the chain (ie one that has no-one to feed)
@@ -295,7 +443,7 @@ Graph::run_one ()
 		return;
 	}
 
-	if (_trigger_queue.pop_front (to_run)) {
+	if (pop_node (to_run)) {
 		/* Wake up idle threads, but at most as many as there's
 		 * work in the trigger queue that can be processed by
 		 * other threads.
@@ -316,6 +464,10 @@ Graph::run_one ()
 		_idle_thread_cnt.fetch_add (1);
 		assert (_idle_thread_cnt.load() <= _n_workers.load());
 
+		if (graph_thread_id >= 0) {
+			_thread_state[graph_thread_id].n_sleep.fetch_add (1, std::memory_order_relaxed);
+		}
+
 		DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 goes to sleep\n", pthread_name ()));
 		_execution_sem.wait ();
 
@@ -328,7 +480,7 @@ Graph::run_one ()
 		PBD::atomic_dec_and_test (_idle_thread_cnt);
 
 		/* Try to find some work to do */
-		_trigger_queue.pop_front (to_run);
+		pop_node (to_run);
 	}
 
 	/* Update the thread-local tempo map ptr.
@@ -341,7 +493,16 @@ Graph::run_one ()
 
 	/* Process the graph-node */
 	PBD::atomic_dec_and_test (_trigger_queue_size);
-	to_run->run (_graph_chain);
+
+	if (graph_thread_id >= 0) {
+		ThreadState&         ts (_thread_state[graph_thread_id]);
+		PBD::microseconds_t  t0 = PBD::get_microseconds ();
+		to_run->run (_graph_chain);
+		ts.busy_usec.fetch_add (PBD::get_microseconds () - t0, std::memory_order_relaxed);
+		ts.n_run.fetch_add (1, std::memory_order_relaxed);
+	} else {
+		to_run->run (_graph_chain);
+	}
 
 	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name ()));
 }
@@ -349,8 +510,8 @@ Graph::run_one ()
 void
 Graph::helper_thread ()
 {
-	_n_workers.fetch_add (1);
-	uint32_t id = _n_workers.load();
+	uint32_t id = _n_workers.fetch_add (1) + 1;
+	graph_thread_id = id;
 
 	/* This is needed for ARDOUR::Session requests called from rt-processors
 	 * in particular Lua scripts may do cross-thread calls */
@@ -381,6 +542,7 @@ void
 Graph::main_thread ()
 {
 	/* first time setup */
+	graph_thread_id = 0;
 
 	suspend_rt_malloc_checks ();
 	ProcessThread* pt = new ProcessThread ();
@@ -574,6 +736,47 @@ Graph::in_process_thread () const
 
 /* ****************************************************************************/
 
+void
+Graph::ThreadState::reset_stats ()
+{
+	n_run.store (0);
+	n_shared.store (0);
+	n_local.store (0);
+	n_stolen.store (0);
+	n_miss.store (0);
+	n_sleep.store (0);
+	busy_usec.store (0);
+}
+
+void
+Graph::thread_stats (std::vector<GraphThreadStats>& stats) const
+{
+	uint32_t n_threads = std::min (1 + _n_workers.load (), _max_threads);
+
+	stats.clear ();
+	for (uint32_t i = 0; i < n_threads; ++i) {
+		ThreadState const& ts (_thread_state[i]);
+		GraphThreadStats s;
+		s.n_run          = ts.n_run.load (std::memory_order_relaxed);
+		s.n_shared       = ts.n_shared.load (std::memory_order_relaxed);
+		s.n_local        = ts.n_local.load (std::memory_order_relaxed);
+		s.n_stolen       = ts.n_stolen.load (std::memory_order_relaxed);
+		s.n_miss         = ts.n_miss.load (std::memory_order_relaxed);
+		s.n_sleep        = ts.n_sleep.load (std::memory_order_relaxed);
+		s.busy_usec      = ts.busy_usec.load (std::memory_order_relaxed);
+		stats.push_back (s);
+	}
+}
+
+void
+Graph::reset_thread_stats ()
+{
+	/* applied by prep() at the start of the next cycle */
+	_stats_reset.store (1);
+}
+
+/* ****************************************************************************/
+
 void
 Graph::process_tasklist (RTTaskList const& rt)
 {
@@ -589,7 +792,7 @@ Graph::process_tasklist (RTTaskList const& rt)
 	_graph_empty = false;
 
 	for (auto const& t : tasks) {
-		_trigger_queue.push_back (const_cast<RTTask*>(&t));
+		push_shared (const_cast<RTTask*>(&t));
 	}
 
 	_graph_chain = 0;
@@ -608,6 +811,7 @@ GraphChain::GraphChain (GraphNodeList const& nodelist, GraphEdges const& edges)
 	 * once we have processed this number of those nodes, we have finished.
 	 */
 	_n_terminal_nodes = 0;
+	_prio_update_cnt  = 0;
 
 	/* copy nodelist to _nodes_rt, prepare GraphNodes for this graph */
 	for (auto const& ni : nodelist) {
@@ -720,13 +924,46 @@ GraphChain::plot (std::string const& file_name) const
 	return true;
 }
 
+/** Compute the critical path of each node, and assign scheduling priorities.
+ *
+ * The critical path of a node is its own measured DSP cost plus the most
+ * expensive path of the nodes it feeds. Nodes with the longest remaining
+ * path are processed first, so that expensive chains start early and do
+ * not set the cycle's wall time.
+ *
+ * This is called by the process thread while no other graph thread is active.
+ */
+void
+GraphChain::update_priorities (uint32_t n_levels) const
+{
+	float max_cp = 0;
+
+	/* _nodes_rt is topologically sorted, visit downstream nodes first */
+	for (auto i = _nodes_rt.rbegin (); i != _nodes_rt.rend (); ++i) {
+		float cp = 0;
+		for (auto const& a : (*i)->activation_set (this)) {
+			cp = std::max (cp, a->_critical_path);
+		}
+		(*i)->_critical_path = cp + (*i)->_dsp_cost;
+		max_cp = std::max (max_cp, (*i)->_critical_path);
+	}
+
+	for (auto const& ni : _nodes_rt) {
+		if (max_cp > 0) {
+			ni->_priority = std::min<uint32_t> (n_levels - 1, floorf (n_levels * ni->_critical_path / max_cp));
+		} else {
+			ni->_priority = 0;
+		}
+	}
+}
+
 void
 GraphChain::dump () const
 {
 #ifndef NDEBUG
 	DEBUG_TRACE (DEBUG::Graph, "--8<-- Graph dump ----------------------------\n");
 	for (auto const& ni : _nodes_rt) {
-		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2\n", ni->graph_node_name (), ni->init_refcount (this)));
+		DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  refcount: %2 cost: %3us critical-path: %4us\n", ni->graph_node_name (), ni->init_refcount (this), ni->dsp_cost (), ni->critical_path ()));
 		for (auto const& ai : ni->activation_set (this)) {
 			DEBUG_TRACE (DEBUG::Graph, string_compose ("  triggers: %1\n", ai->graph_node_name ()));
 		}
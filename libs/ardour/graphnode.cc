@@ -19,6 +19,7 @@
  */
 
 #include "pbd/atomic.h"
+#include "pbd/microseconds.h"
 
 #include "ardour/graphnode.h"
 #include "ardour/graph.h"
@@ -56,6 +57,8 @@ GraphActivision::flush_graph_activision_rcu ()
 
 GraphNode::GraphNode (std::shared_ptr<Graph> graph)
 	: _graph (graph)
+	, _dsp_cost (0)
+	, _critical_path (0)
 {
 	_refcount.store (0);
 }
@@ -70,7 +73,13 @@ GraphNode::prep (GraphChain const* chain)
 void
 GraphNode::run (GraphChain const* chain)
 {
+	PBD::microseconds_t t0 = PBD::get_microseconds ();
 	process ();
+
+	/* update rolling cost estimate, used for critical-path scheduling */
+	float dt = PBD::get_microseconds () - t0;
+	_dsp_cost += .05f * (dt - _dsp_cost);
+
 	finish (chain);
 }
 
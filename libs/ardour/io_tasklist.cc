@@ -20,6 +20,8 @@
 #include <sys/syscall.h>
 #endif
 
+#include <algorithm>
+
 #include "pbd/compose.h"
 #include "pbd/cpus.h"
 #include "pbd/debug.h"
@@ -40,7 +42,8 @@
 using namespace ARDOUR;
 
 IOTaskList::IOTaskList (uint32_t n_threads)
-	: _n_threads (n_threads)
+	: _next_task (0)
+	, _n_threads (n_threads)
 	, _terminate (false)
 	, _exec_sem ("io thread exec", 0)
 	, _idle_sem ("io thread idle", 0)
@@ -101,15 +104,19 @@ IOTaskList::~IOTaskList ()
 }
 
 void
-IOTaskList::push_back (std::function<void ()> fn)
+IOTaskList::push_back (std::function<void ()> fn, float priority)
 {
-	_tasks.push_back (fn);
+	_tasks.push_back (Task (fn, priority));
 }
 
 void
 IOTaskList::process ()
 {
 	assert (strcmp (pthread_name (), "butler") == 0);
+
+	std::stable_sort (_tasks.begin (), _tasks.end (), [] (Task const& a, Task const& b) { return a.priority > b.priority; });
+	_next_task.store (0);
+
 	if (_n_threads > 1 && _tasks.size () > 2) {
 		uint32_t wakeup = std::min<uint32_t> (_n_threads, _tasks.size ());
 		DEBUG_TRACE (PBD::DEBUG::IOTaskList, string_compose ("IOTaskList process wakeup %1 thread for %2 tasks.\n", wakeup, _tasks.size ()))
@@ -121,8 +128,8 @@ IOTaskList::process ()
 		}
 	} else {
 		DEBUG_TRACE (PBD::DEBUG::IOTaskList, string_compose ("IOTaskList process %1 task(s) in main thread.\n", _tasks.size ()))
-		for (auto const& fn : _tasks) {
-			fn ();
+		for (auto const& t : _tasks) {
+			t.fn ();
 		}
 	}
 	_tasks.clear ();
@@ -170,17 +177,10 @@ IOTaskList::io_thread ()
 
 		Temporal::TempoMap::fetch ();
 
-		while (1) {
-			std::function<void()> fn;
-			PBD::Mutex::Lock lm (_tasks_mutex);
-			if (_tasks.empty ()) {
-				break;
-			}
-			fn = _tasks.back ();
-			_tasks.pop_back ();
-			lm.release ();
-
-			fn ();
+		/* _tasks is not modified until all workers are idle */
+		size_t i;
+		while ((i = _next_task.fetch_add (1)) < _tasks.size ()) {
+			_tasks[i].fn ();
 		}
 		_idle_sem.signal ();
 	}
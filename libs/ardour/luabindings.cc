@@ -2081,6 +2081,10 @@ LuaBindings::common (lua_State* L)
 		.deriveWSPtrClass <LuaProc, Plugin> ("LuaProc")
 		.addFunction ("shmem", &LuaProc::instance_shm)
 		.addFunction ("table", &LuaProc::instance_ref)
+		.addFunction ("uses_tlsf", &LuaProc::uses_tlsf)
+		.addFunction ("clear_stats", &LuaProc::clear_stats)
+		.addRefFunction ("get_gc_stats", &LuaProc::get_gc_stats)
+		.addRefFunction ("get_mem_stats", &LuaProc::get_mem_stats)
 		.endClass ()
 
 		.deriveWSPtrClass <PluginInsert, Processor> ("PluginInsert")
@@ -2429,7 +2433,7 @@ LuaBindings::common (lua_State* L)
 		.beginStdList <std::shared_ptr<Evoral::PatchChange<Temporal::Beats> > > ("PatchChangePtrList")
 		.endClass ()
 
-		.beginConstStdCPtrList <Evoral::ControlEvent> ("EventList")
+		.beginConstStdVector <Evoral::ControlEvent*> ("EventList")
 		.endClass ()
 
 #if 0  // depends on Evoal:: Note, Beats see note_fixer.h
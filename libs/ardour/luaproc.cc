@@ -25,6 +25,8 @@
 
 #include "pbd/gstdio_compat.h"
 #include "pbd/pthread_utils.h"
+#include "pbd/reallocpool.h"
+#include "pbd/tlsf.h"
 
 #include "ardour/audio_buffer.h"
 #include "ardour/buffer_set.h"
@@ -34,6 +36,7 @@
 #include "ardour/luascripting.h"
 #include "ardour/midi_buffer.h"
 #include "ardour/plugin.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 
 #include "LuaBridge/LuaBridge.h"
@@ -47,13 +50,11 @@ LuaProc::LuaProc (AudioEngine& engine,
                   Session& session,
                   const std::string &script)
 	: Plugin (engine, session)
-	, _mempool ("LuaProc", 3145728)
-#ifdef USE_TLSF
-	, lua (lua_newstate (&PBD::TLSF::lalloc, &_mempool))
-#elif defined USE_MALLOC
+	, _mempool (Config->get_lua_dsp_use_tlsf ())
+#ifdef USE_MALLOC
 	, lua (true, true)
 #else
-	, lua (lua_newstate (&PBD::ReallocPool::lalloc, &_mempool))
+	, lua (lua_newstate (&LuaProc::MemPool::lalloc, &_mempool))
 #endif
 	, _lua_dsp (0)
 	, _lua_latency (0)
@@ -83,13 +84,11 @@ LuaProc::LuaProc (AudioEngine& engine,
 
 LuaProc::LuaProc (const LuaProc &other)
 	: Plugin (other)
-	, _mempool ("LuaProc", 3145728)
-#ifdef USE_TLSF
-	, lua (lua_newstate (&PBD::TLSF::lalloc, &_mempool))
-#elif defined USE_MALLOC
+	, _mempool (other.uses_tlsf ())
+#ifdef USE_MALLOC
 	, lua (true, true)
 #else
-	, lua (lua_newstate (&PBD::ReallocPool::lalloc, &_mempool))
+	, lua (lua_newstate (&LuaProc::MemPool::lalloc, &_mempool))
 #endif
 	, _lua_dsp (0)
 	, _lua_latency (0)
@@ -146,6 +145,7 @@ LuaProc::init ()
 	_stats_avg[0] = _stats_avg[1] = _stats_max[0] = _stats_max[1] = 0;
 	_stats_cnt = -25;
 #endif
+	_stat_reset.store (0);
 
 	lua.Print.connect (sigc::mem_fun (*this, &LuaProc::lua_print));
 	// register session object
@@ -198,6 +198,105 @@ LuaProc::route () const
 	return static_cast<Route*>(_owner)->weakroute ();
 }
 
+bool
+LuaProc::get_gc_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const
+{
+	return _gc_stats.get_stats (min, max, avg, dev);
+}
+
+bool
+LuaProc::get_mem_stats (int64_t& used, int64_t& peak, int64_t& n_alloc, int64_t& n_alloc_run) const
+{
+	used        = _mempool.used.load (std::memory_order_relaxed);
+	peak        = _mempool.peak.load (std::memory_order_relaxed);
+	n_alloc     = _mempool.n_alloc.load (std::memory_order_relaxed);
+	n_alloc_run = _mempool.n_alloc_run.load (std::memory_order_relaxed);
+	return true;
+}
+
+void
+LuaProc::clear_stats ()
+{
+	_stat_reset.store (1);
+}
+
+LuaProc::MemPool::MemPool (bool use_tlsf)
+	: rap (0)
+	, tlsf (0)
+	, used (0)
+	, peak (0)
+	, n_alloc (0)
+	, n_alloc_run (0)
+	, in_run (false)
+	, gc_cycles (2)
+{
+	if (use_tlsf) {
+		tlsf = new PBD::TLSF ("LuaProc", 3145728);
+	} else {
+		rap = new PBD::ReallocPool ("LuaProc", 3145728);
+	}
+}
+
+LuaProc::MemPool::~MemPool ()
+{
+	delete rap;
+	delete tlsf;
+}
+
+void
+LuaProc::MemPool::set_name (std::string const& name)
+{
+	if (tlsf) {
+		tlsf->set_name (name);
+	} else {
+		rap->set_name (name);
+	}
+}
+
+void
+LuaProc::MemPool::reset_stats ()
+{
+	peak.store (used.load (std::memory_order_relaxed), std::memory_order_relaxed);
+	n_alloc.store (0, std::memory_order_relaxed);
+	n_alloc_run.store (0, std::memory_order_relaxed);
+}
+
+void*
+LuaProc::MemPool::lalloc (void* pool, void* ptr, size_t oldsize, size_t newsize)
+{
+	MemPool* mp = static_cast<MemPool*> (pool);
+
+	void* rv;
+	if (mp->tlsf) {
+		rv = PBD::TLSF::lalloc (mp->tlsf, ptr, oldsize, newsize);
+	} else {
+		rv = PBD::ReallocPool::lalloc (mp->rap, ptr, oldsize, newsize);
+	}
+
+	if (newsize > 0 && !rv) {
+		/* out of memory, the block is unchanged */
+		return rv;
+	}
+
+	/* for new objects Lua passes the type as oldsize */
+	size_t const os = ptr ? oldsize : 0;
+
+	/* only the thread using the Lua state writes the counters */
+	size_t const used = mp->used.load (std::memory_order_relaxed) + newsize - os;
+	mp->used.store (used, std::memory_order_relaxed);
+	if (used > mp->peak.load (std::memory_order_relaxed)) {
+		mp->peak.store (used, std::memory_order_relaxed);
+	}
+	if (newsize > os) {
+		mp->n_alloc.store (mp->n_alloc.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		if (mp->in_run) {
+			mp->n_alloc_run.store (mp->n_alloc_run.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+		mp->gc_cycles = 2;
+	}
+	return rv;
+}
+
 void
 LuaProc::lua_print (std::string s) {
 #ifndef NDEBUG
@@ -749,10 +848,18 @@ LuaProc::connect_and_run (BufferSet& bufs,
 		}
 	}
 
+	int canderef (1);
+	if (_stat_reset.compare_exchange_strong (canderef, 0)) {
+		_gc_stats.reset ();
+		_mempool.reset_stats ();
+	}
+
 #ifdef WITH_LUAPROC_STATS
 	int64_t t0 = g_get_monotonic_time ();
 #endif
 
+	_mempool.in_run = true;
+
 	try {
 		lua_State* L = lua.getState ();
 
@@ -909,19 +1016,36 @@ LuaProc::connect_and_run (BufferSet& bufs,
 		}
 
 	} catch (luabridge::LuaException const& e) {
+		_mempool.in_run = false;
 #ifndef NDEBUG
 		std::cerr << "LuaException: " << e.what () << "\n";
 #endif
 		PBD::warning << "LuaException: " << e.what () << "\n";
 		return -1;
 	} catch (...) {
+		_mempool.in_run = false;
 		return -1;
 	}
+
+	_mempool.in_run = false;
+
 #ifdef WITH_LUAPROC_STATS
 	int64_t t1 = g_get_monotonic_time ();
 #endif
 
-	lua.collect_garbage_step ();
+	/* Only garbage that was allocated can be collected. A script that
+	 * did not allocate since the last completed cycle does not need to
+	 * spend any time in the GC. One more cycle is needed after the last
+	 * allocation, since objects may still have been reachable when the
+	 * current cycle started.
+	 */
+	if (_mempool.gc_cycles > 0) {
+		_gc_stats.start ();
+		if (lua.collect_garbage_step ()) {
+			--_mempool.gc_cycles;
+		}
+		_gc_stats.update ();
+	}
 #ifdef WITH_LUAPROC_STATS
 	if (++_stats_cnt > 0) {
 		int64_t t2 = g_get_monotonic_time ();
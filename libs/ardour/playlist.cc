@@ -45,6 +45,7 @@
 #include "ardour/playlist_source.h"
 #include "ardour/region.h"
 #include "ardour/region_factory.h"
+#include "ardour/region_index.h"
 #include "ardour/region_sorters.h"
 #include "ardour/session.h"
 #include "ardour/session_playlists.h"
@@ -349,6 +350,8 @@ Playlist::init (bool hide)
 	_frozen                     = false;
 	_capture_insertion_underway = false;
 	_combine_ops                = 0;
+	_region_index_valid         = false;
+	_region_write_locked        = false;
 
 	_refcnt.store (0);
 
@@ -1691,6 +1694,11 @@ Playlist::region_changed (const PropertyChange& what_changed, std::shared_ptr<Re
 	PropertyChange bounds;
 	bool           save = false;
 
+	if (what_changed.contains (Properties::region_fx_changed) || what_changed.contains (Properties::time_domain)) {
+		/* regions with a tail, or their ordering may have changed */
+		invalidate_region_index ();
+	}
+
 	if (in_set_state || in_flush) {
 		return false;
 	}
@@ -1794,6 +1802,34 @@ Playlist::clear (bool with_signals)
 FINDING THINGS
 **********************************************************************/
 
+std::shared_ptr<RegionIndex const>
+Playlist::region_index () const
+{
+	/* Caller must hold lock */
+
+	if (_region_write_locked) {
+		/* regions are being modified by the caller */
+		return std::shared_ptr<RegionIndex const> ();
+	}
+
+	PBD::Mutex::Lock lm (_region_index_lock);
+
+	if (!_region_index_valid) {
+		_region_index       = RegionIndex::create (regions.rlist ());
+		_region_index_valid = true;
+	}
+
+	return _region_index;
+}
+
+void
+Playlist::invalidate_region_index ()
+{
+	PBD::Mutex::Lock lm (_region_index_lock);
+	_region_index.reset ();
+	_region_index_valid = false;
+}
+
 std::shared_ptr<RegionList>
 Playlist::region_list ()
 {
@@ -1825,6 +1861,19 @@ Playlist::count_regions_at (timepos_t const & pos) const
 	RegionReadLock rlock (const_cast<Playlist*> (this));
 	uint32_t       cnt = 0;
 
+	std::shared_ptr<RegionIndex const> idx (region_index ());
+
+	if (idx) {
+		RegionList rl;
+		idx->overlapping (pos, pos.increment (), rl);
+		for (auto const & r : rl) {
+			if (r->covers (pos)) {
+				cnt++;
+			}
+		}
+		return cnt;
+	}
+
 	for (auto const & r : regions) {
 		if (r->covers (pos)) {
 			cnt++;
@@ -1958,6 +2007,15 @@ Playlist::find_regions_at (timepos_t const & pos)
 
 	std::shared_ptr<RegionList> rlist (new RegionList);
 
+	std::shared_ptr<RegionIndex const> idx (region_index ());
+
+	if (idx) {
+		idx->overlapping (pos, pos.increment (), *rlist);
+		/* the index may lag behind a region that was just modified */
+		rlist->remove_if ([&pos] (std::shared_ptr<Region> const& r) { return !r->covers (pos); });
+		return rlist;
+	}
+
 	for (auto & r : regions) {
 		if (r->covers (pos)) {
 			rlist->push_back (r);
@@ -1973,6 +2031,14 @@ Playlist::regions_with_start_within (Temporal::Range range)
 	RegionReadLock              rlock (this);
 	std::shared_ptr<RegionList> rlist (new RegionList);
 
+	std::shared_ptr<RegionIndex const> idx (region_index ());
+
+	if (idx) {
+		idx->starting_within (range.start (), range.end (), *rlist);
+		rlist->remove_if ([&range] (std::shared_ptr<Region> const& r) { return r->position() < range.start() || r->position() >= range.end(); });
+		return rlist;
+	}
+
 	for (auto & r : regions) {
 		if (r->position() >= range.start() && r->position() < range.end()) {
 			rlist->push_back (r);
@@ -1988,6 +2054,15 @@ Playlist::regions_with_end_within (Temporal::Range range)
 	RegionReadLock              rlock (this);
 	std::shared_ptr<RegionList> rlist (new RegionList);
 
+	std::shared_ptr<RegionIndex const> idx (region_index ());
+
+	if (idx) {
+		/* a region ending within the range also overlaps it */
+		idx->overlapping (range.start (), range.end (), *rlist);
+		rlist->remove_if ([&range] (std::shared_ptr<Region> const& r) { return r->nt_last() < range.start() || r->nt_last() >= range.end(); });
+		return rlist;
+	}
+
 	for (auto & r : regions) {
 		if (r->nt_last() >= range.start() && r->nt_last() < range.end()) {
 			rlist->push_back (r);
@@ -2009,6 +2084,34 @@ Playlist::regions_touched_locked (timepos_t const & start, timepos_t const & end
 {
 	std::shared_ptr<RegionList> rlist (new RegionList);
 
+	std::shared_ptr<RegionIndex const> idx (region_index ());
+
+	if (idx) {
+		idx->overlapping (start, end, *rlist);
+
+		if (with_tail) {
+			/* the index does not include region-fx tails, add regions
+			 * whose tail reaches into the range, retaining position order.
+			 */
+			for (auto const & r : idx->tail_regions ()) {
+				if (std::find (rlist->begin (), rlist->end (), r) != rlist->end ()) {
+					continue;
+				}
+				if (r->coverage (start, end, true) == Temporal::OverlapNone) {
+					continue;
+				}
+				RegionList::iterator i = rlist->begin ();
+				while (i != rlist->end () && (*i)->position () <= r->position ()) {
+					++i;
+				}
+				rlist->insert (i, r);
+			}
+		}
+
+		rlist->remove_if ([&] (std::shared_ptr<Region> const& r) { return r->coverage (start, end, with_tail) == Temporal::OverlapNone; });
+		return rlist;
+	}
+
 	for (auto & r : regions) {
 		if (r->coverage (start, end, with_tail) != Temporal::OverlapNone) {
 			rlist->push_back (r);
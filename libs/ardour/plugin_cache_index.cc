@@ -0,0 +1,361 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <ctime>
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#include <glibmm/convert.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/pathexpand.h"
+#include "pbd/search_path.h"
+#include "pbd/xml++.h"
+
+#include "ardour/debug.h"
+#include "ardour/filesystem_paths.h"
+#include "ardour/plugin_cache_index.h"
+#include "ardour/revision.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+#define PLUGIN_CACHE_INDEX_VERSION 1
+
+PluginCacheIndex::PluginCacheIndex ()
+	: _dirty (false)
+{
+}
+
+PluginCacheIndex::~PluginCacheIndex ()
+{
+	clear ();
+}
+
+void
+PluginCacheIndex::clear ()
+{
+	for (Plugins::iterator i = _plugins.begin (); i != _plugins.end (); ++i) {
+		delete i->second;
+	}
+	for (Dirs::iterator i = _dirs.begin (); i != _dirs.end (); ++i) {
+		delete i->second;
+	}
+	_plugins.clear ();
+	_dirs.clear ();
+	_used.clear ();
+	_dirty = false;
+}
+
+void
+PluginCacheIndex::load ()
+{
+	clear ();
+
+	_path = Glib::build_filename (user_cache_directory (), X_("plugin_cache_index"));
+
+	if (!Glib::file_test (_path, Glib::FILE_TEST_EXISTS)) {
+		return;
+	}
+
+	XMLTree tree;
+	if (!tree.read (_path)) {
+		warning << string_compose (_("Cannot read plugin cache index '%1'"), _path) << endmsg;
+		return;
+	}
+
+	XMLNode*    root = tree.root ();
+	int         version;
+	std::string rev;
+
+	if (!root->get_property (X_("version"), version) || version != PLUGIN_CACHE_INDEX_VERSION
+	    || !root->get_property (X_("revision"), rev) || rev != revision) {
+		DEBUG_TRACE (DEBUG::PluginManager, "Ignoring plugin cache index of a different version\n");
+		return;
+	}
+
+	/* take ownership of the entries, anything else is deleted with the tree */
+	for (XMLNodeConstIterator i = root->children ().begin (); i != root->children ().end (); ++i) {
+		std::string path;
+		std::string type;
+		if ((*i)->name () == X_("Plugin") && (*i)->get_property (X_("module"), path)) {
+			_plugins.insert (std::make_pair (path, *i));
+		} else if ((*i)->name () == X_("Dir") && (*i)->get_property (X_("path"), path) && (*i)->get_property (X_("type"), type)) {
+			_dirs.insert (std::make_pair (std::make_pair (type, path), *i));
+		}
+	}
+	root->remove_nodes (X_("Plugin"));
+	root->remove_nodes (X_("Dir"));
+
+	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Loaded plugin cache index with %1 plugins and %2 directories\n", _plugins.size (), _dirs.size ()));
+}
+
+void
+PluginCacheIndex::save ()
+{
+	if (_path.empty ()) {
+		return;
+	}
+
+	/* drop entries of plugins and directories that no longer exist */
+	for (Plugins::iterator i = _plugins.begin (); i != _plugins.end ();) {
+		if (_used.find (i->second) == _used.end ()) {
+			delete i->second;
+			_plugins.erase (i++);
+			_dirty = true;
+		} else {
+			++i;
+		}
+	}
+	for (Dirs::iterator i = _dirs.begin (); i != _dirs.end ();) {
+		if (_used.find (i->second) == _used.end ()) {
+			delete i->second;
+			_dirs.erase (i++);
+			_dirty = true;
+		} else {
+			++i;
+		}
+	}
+
+	_used.clear ();
+
+	if (!_dirty) {
+		return;
+	}
+
+	XMLNode* root = new XMLNode (X_("PluginCacheIndex"));
+	root->set_property (X_("version"), PLUGIN_CACHE_INDEX_VERSION);
+	root->set_property (X_("revision"), revision);
+
+	for (Plugins::const_iterator i = _plugins.begin (); i != _plugins.end (); ++i) {
+		root->add_child_nocopy (*i->second);
+	}
+	for (Dirs::const_iterator i = _dirs.begin (); i != _dirs.end (); ++i) {
+		root->add_child_nocopy (*i->second);
+	}
+
+	XMLTree tree;
+	tree.set_root (root);
+	tree.set_binary (true);
+
+	if (!tree.write (_path)) {
+		error << string_compose (_("Could not save plugin cache index to '%1'"), _path) << endmsg;
+		::g_unlink (_path.c_str ());
+	} else {
+		_dirty = false;
+	}
+
+	/* the entries remain owned by the index */
+	tree.set_root (0);
+	root->remove_nodes (X_("Plugin"));
+	root->remove_nodes (X_("Dir"));
+	delete root;
+}
+
+bool
+PluginCacheIndex::set_stat (XMLNode& node, std::string const& prefix, std::string const& path)
+{
+	GStatBuf sb;
+	if (g_stat (path.c_str (), &sb) != 0) {
+		return false;
+	}
+	node.set_property ((prefix + "mtime").c_str (), (int64_t) sb.st_mtime);
+	node.set_property ((prefix + "size").c_str (), (int64_t) sb.st_size);
+	node.set_property ((prefix + "inode").c_str (), (uint64_t) sb.st_ino);
+	return true;
+}
+
+bool
+PluginCacheIndex::unchanged (XMLNode const& node, std::string const& prefix, std::string const& path)
+{
+	GStatBuf sb;
+	int64_t  mtime;
+	int64_t  size;
+	uint64_t inode;
+
+	return g_stat (path.c_str (), &sb) == 0
+	       && node.get_property ((prefix + "mtime").c_str (), mtime) && mtime == (int64_t) sb.st_mtime
+	       && node.get_property ((prefix + "size").c_str (), size) && size == (int64_t) sb.st_size
+	       && node.get_property ((prefix + "inode").c_str (), inode) && inode == (uint64_t) sb.st_ino;
+}
+
+XMLNode const*
+PluginCacheIndex::lookup (std::string const& module_path, std::string const& cache_file)
+{
+	Plugins::const_iterator i = _plugins.find (module_path);
+	if (i == _plugins.end ()) {
+		return 0;
+	}
+
+	XMLNode const* node = i->second;
+	if (node->children ().empty () || !unchanged (*node, "", module_path) || !unchanged (*node, "cache-", cache_file)) {
+		DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Plugin cache index entry for '%1' is stale\n", module_path));
+		return 0;
+	}
+
+	_used.insert (node);
+	return node->children ().front ();
+}
+
+void
+PluginCacheIndex::add (std::string const& module_path, std::string const& cache_file, XMLNode const& root)
+{
+	XMLNode* node = new XMLNode (X_("Plugin"));
+	node->set_property (X_("module"), module_path);
+
+	if (!set_stat (*node, "", module_path) || !set_stat (*node, "cache-", cache_file)) {
+		delete node;
+		return;
+	}
+
+	node->add_child_copy (root);
+
+	Plugins::iterator i = _plugins.find (module_path);
+	if (i != _plugins.end ()) {
+		_used.erase (i->second);
+		delete i->second;
+		i->second = node;
+	} else {
+		_plugins.insert (std::make_pair (module_path, node));
+	}
+
+	_used.insert (node);
+	_dirty = true;
+}
+
+void
+PluginCacheIndex::find_paths (std::vector<std::string>& result, Searchpath const& paths, std::string const& type,
+                              bool (*filter)(const std::string&, void*), bool files_only)
+{
+	std::set<std::string> scanned;
+	for (std::vector<std::string>::const_iterator i = paths.begin (); i != paths.end (); ++i) {
+		walk (result, path_expand (*i), type, filter, files_only, scanned);
+	}
+}
+
+void
+PluginCacheIndex::walk (std::vector<std::string>& result, std::string const& dir, std::string const& type,
+                        bool (*filter)(const std::string&, void*), bool files_only, std::set<std::string>& scanned)
+{
+	GStatBuf sb;
+	if (g_stat (dir.c_str (), &sb) != 0 || !S_ISDIR (sb.st_mode)) {
+		return;
+	}
+
+	XMLNode* node = 0;
+	int64_t  mtime;
+	int64_t  listed;
+
+	Dirs::iterator i = _dirs.find (std::make_pair (type, dir));
+
+	/* a directory that was modified in the same second in which it was
+	 * listed may have changed after that, list it again to be sure.
+	 */
+	if (i != _dirs.end ()
+	    && i->second->get_property (X_("mtime"), mtime) && mtime == (int64_t) sb.st_mtime
+	    && i->second->get_property (X_("listed"), listed) && mtime < listed) {
+		node = i->second;
+	} else {
+		node = list_dir (dir, type, filter, files_only, sb.st_mtime);
+		if (!node) {
+			return;
+		}
+		if (i != _dirs.end ()) {
+			_used.erase (i->second);
+			delete i->second;
+			i->second = node;
+		} else {
+			_dirs.insert (std::make_pair (std::make_pair (type, dir), node));
+		}
+		_dirty = true;
+	}
+
+	_used.insert (node);
+
+	for (XMLNodeConstIterator c = node->children ().begin (); c != node->children ().end (); ++c) {
+		std::string name;
+		bool        is_dir = false;
+		bool        match  = false;
+
+		if (!(*c)->get_property (X_("name"), name)) {
+			continue;
+		}
+		(*c)->get_property (X_("dir"), is_dir);
+		(*c)->get_property (X_("match"), match);
+
+		std::string const fullpath = Glib::build_filename (dir, name);
+
+		if (is_dir && scanned.find (fullpath) == scanned.end ()) {
+			scanned.insert (fullpath);
+			walk (result, fullpath, type, filter, files_only, scanned);
+		}
+
+		if (match) {
+			result.push_back (fullpath);
+		}
+	}
+}
+
+XMLNode*
+PluginCacheIndex::list_dir (std::string const& dir, std::string const& type,
+                            bool (*filter)(const std::string&, void*), bool files_only, int64_t mtime)
+{
+	XMLNode* node = new XMLNode (X_("Dir"));
+	node->set_property (X_("type"), type);
+	node->set_property (X_("path"), dir);
+	node->set_property (X_("mtime"), mtime);
+	node->set_property (X_("listed"), (int64_t) time (0));
+
+	try {
+		Glib::Dir d (dir);
+		for (Glib::DirIterator di = d.begin (); di != d.end (); di++) {
+			std::string const name   = *di;
+			bool const        is_dir = Glib::file_test (Glib::build_filename (dir, name), Glib::FILE_TEST_IS_DIR);
+			bool const        match  = !(is_dir && files_only) && filter (name, 0);
+
+			if (!is_dir && !match) {
+				continue;
+			}
+
+			XMLNode* e = node->add_child (X_("Entry"));
+			e->set_property (X_("name"), name);
+			if (is_dir) {
+				e->set_property (X_("dir"), true);
+			}
+			if (match) {
+				e->set_property (X_("match"), true);
+			}
+		}
+	}
+	catch (Glib::FileError const& err) {
+		warning << string_compose (_("Cannot access file: %1"), err.what ()) << endmsg;
+		delete node;
+		return 0;
+	}
+	catch (Glib::ConvertError const& err) {
+		warning << string_compose (_("Cannot convert filename: %1"), err.what ()) << endmsg;
+		delete node;
+		return 0;
+	}
+
+	return node;
+}
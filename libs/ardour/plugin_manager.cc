@@ -127,6 +127,7 @@
 #include "ardour/vst3_scan.h"
 #endif
 
+#include "pbd/cpus.h"
 #include "pbd/error.h"
 #include "pbd/stl_delete.h"
 
@@ -467,6 +468,7 @@ PluginManager::refresh (bool cache_only)
 	}
 
 	load_scanlog ();
+	_cache_index.load ();
 
 	DEBUG_TRACE (DEBUG::PluginManager, "PluginManager::refresh\n");
 	reset_scan_cancel_state ();
@@ -602,6 +604,8 @@ PluginManager::refresh (bool cache_only)
 		Config->save_state();
 	}
 
+	_cache_index.save ();
+
 	BootMessage (_("Plugin Scan Complete..."));
 
 	reset_scan_cancel_state ();
@@ -703,6 +707,163 @@ PluginManager::reset_scan_cancel_state (bool single)
 	_enable_scan_timeout     = false;
 }
 
+#if (defined LXVST_SUPPORT || defined VST3_SUPPORT)
+
+uint32_t
+PluginManager::scanner_jobs () const
+{
+	uint32_t n_jobs = Config->get_plugin_scan_jobs ();
+	if (n_jobs == 0) {
+		n_jobs = hardware_concurrency ();
+	}
+	return std::max<uint32_t> (1, n_jobs);
+}
+
+static void scanner_app_log (std::string msg, std::stringstream* ss)
+{
+	*ss << msg;
+}
+
+/* Run the external scanner app for all given jobs, up to scanner_jobs() at a time,
+ * each with its own timeout. "Skip" and "disable timeout" of the scan dialog
+ * apply to all scans that are running at the time.
+ *
+ * @a start is called right before a scanner app is launched.
+ */
+void
+PluginManager::run_scanner_apps (std::string const& scanner_bin, std::string const& type, std::vector<ScanJob>& jobs, std::function<void (ScanJob const&)> start)
+{
+	struct Scan {
+		Scan (ScanJob& j) : job (j), scanner (0), timeout (0), notime (true), keep_notime (false) {}
+		~Scan () { delete scanner; }
+
+		ScanJob&              job;
+		ARDOUR::SystemExec*   scanner;
+		std::stringstream     log;
+		PBD::ScopedConnection connection;
+		int                   timeout; /* deciseconds */
+		bool                  notime;
+		bool                  keep_notime;
+	};
+
+	uint32_t const n_jobs = scanner_jobs ();
+	int64_t const  t_start = g_get_monotonic_time ();
+	size_t         n_started = 0;
+
+	std::list<Scan> running;
+	std::vector<ScanJob>::iterator next = jobs.begin ();
+
+	while (!running.empty () || (next != jobs.end () && !_cancel_scan_all)) {
+
+		while (next != jobs.end () && running.size () < n_jobs && !_cancel_scan_all) {
+			ScanJob& job (*next++);
+
+			++n_started;
+			ARDOUR::PluginScanMessage (string_compose (_("%1 (%2 / %3)"), type, n_started, jobs.size ()), job.path, true);
+			start (job);
+
+			char **argp= (char**) calloc (5, sizeof (char*));
+			argp[0] = strdup (scanner_bin.c_str ());
+			argp[1] = strdup ("-f");
+			if (Config->get_verbose_plugin_scan()) {
+				argp[2] = strdup ("-v");
+			} else {
+				argp[2] = strdup ("-f");
+			}
+			argp[3] = strdup (job.path.c_str ());
+			argp[4] = 0;
+
+			running.emplace_back (job);
+			Scan& s (running.back ());
+			s.scanner = new ARDOUR::SystemExec (scanner_bin, argp);
+			s.scanner->ReadStdout.connect_same_thread (s.connection, std::bind (&scanner_app_log, _1, &s.log));
+
+			if (s.scanner->start (ARDOUR::SystemExec::MergeWithStdin)) {
+				job.psle->msg (PluginScanLogEntry::Error, string_compose (_("Cannot launch VST scanner app '%1': %2"), scanner_bin, strerror (errno)));
+				job.state = ScanJob::Failed;
+				running.pop_back ();
+				continue;
+			}
+
+			s.timeout = _enable_scan_timeout ? 1 + Config->get_plugin_scan_timeout() : 0;
+			s.notime  = (s.timeout <= 0);
+		}
+
+		if (running.empty ()) {
+			continue;
+		}
+
+		Glib::usleep (100000);
+
+		bool const cancel_one = _cancel_scan_one;
+		if (_cancel_scan_timeout_one) {
+			for (auto& s : running) {
+				s.keep_notime = true;
+			}
+		}
+		_cancel_scan_one         = false;
+		_cancel_scan_timeout_one = false;
+
+		int timeout = 0;
+
+		for (std::list<Scan>::iterator i = running.begin (); i != running.end ();) {
+			Scan& s (*i);
+
+			if (!s.scanner->is_running ()) {
+				s.job.psle->msg (PluginScanLogEntry::OK, s.log.str());
+				s.job.state = ScanJob::Done;
+				i = running.erase (i);
+				continue;
+			}
+
+			if (!s.notime && (s.keep_notime || _cancel_scan_timeout_all)) {
+				s.notime = true;
+				s.timeout = -1;
+			} else if (s.notime && !s.keep_notime && !_cancel_scan_timeout_all && _enable_scan_timeout) {
+				s.notime = false;
+				s.timeout = 1 + Config->get_plugin_scan_timeout ();
+			}
+
+			if (s.timeout > -864000) {
+				--s.timeout;
+			}
+
+			if (cancel_one || _cancel_scan_all || (!s.notime && s.timeout == 0)) {
+				s.scanner->terminate ();
+				s.job.psle->msg (PluginScanLogEntry::OK, s.log.str());
+				if (cancel_one || _cancel_scan_all) {
+					s.job.psle->msg (PluginScanLogEntry::New, "Scan was cancelled.");
+				} else {
+					s.job.psle->msg (PluginScanLogEntry::TimeOut, "Scan Timed Out.");
+				}
+				s.job.state = ScanJob::Aborted;
+				i = running.erase (i);
+				continue;
+			}
+
+			/* report the scan closest to its timeout, or else the longest running one */
+			if (s.timeout > 0) {
+				timeout = timeout > 0 ? std::min (timeout, s.timeout) : s.timeout;
+			} else if (timeout <= 0) {
+				timeout = std::min (timeout, s.timeout);
+			}
+			++i;
+		}
+
+		if (timeout != 0) {
+			ARDOUR::PluginScanTimeout (timeout);
+		}
+	}
+
+	if (n_started > 0) {
+		info << string_compose (_("%1: scanned %2 plugin bundles in %3 sec (up to %4 at a time)"),
+		                        type, n_started, (g_get_monotonic_time () - t_start) / 100000 / 10.0, n_jobs)
+		     << endmsg;
+	}
+}
+
+#endif
+
 void
 PluginManager::clear_vst_cache ()
 {
@@ -1635,7 +1796,14 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 	bool run_scan = false;
 	bool is_new   = false;
 
-	string cache_file = vst2_valid_cache_file (path, false, &is_new);
+	/* an up-to-date index entry saves reading the cache file */
+	string cache_file = vst2_cache_file (path);
+	XMLNode const* root = _cache_index.lookup (path, cache_file);
+	bool const indexed = root != 0;
+
+	if (!indexed) {
+		cache_file = vst2_valid_cache_file (path, false, &is_new);
+	}
 
 	if (!cache_only && vst2_scanner_bin_path.empty () && cache_file.empty ()) {
 		/* scan in host context */
@@ -1656,7 +1824,9 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 
 
 	XMLTree tree;
-	if (cache_file.empty ()) {
+	if (indexed) {
+		/* version was checked when it was indexed */
+	} else if (cache_file.empty ()) {
 		run_scan = true;
 	} else if (tree.read (cache_file)) {
 		/* valid cache file was found, now check version */
@@ -1702,8 +1872,12 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 		return -1;
 	}
 
+	if (!indexed) {
+		root = tree.root ();
+	}
+
 	std::string binary;
-	if (!tree.root()->get_property ("binary", binary) || binary != path) {
+	if (!root->get_property ("binary", binary) || binary != path) {
 		psle->msg (PluginScanLogEntry::Incompatible, string_compose (_("Invalid VST2 cache file '%1'"), cache_file)); // XXX log as error msg
 		psle->msg (PluginScanLogEntry::Blacklisted);
 		vst2_blacklist (path);
@@ -1711,18 +1885,22 @@ PluginManager::vst2_discover (string path, ARDOUR::PluginType type, bool cache_o
 	}
 
 	std::string arch;
-	if (!tree.root()->get_property ("arch", arch) || arch != vst2_arch ()) {
+	if (!root->get_property ("arch", arch) || arch != vst2_arch ()) {
 		vst2_blacklist (path);
 		psle->msg (PluginScanLogEntry::Blacklisted);
 		psle->msg (PluginScanLogEntry::Incompatible, string_compose (_("VST2 architecture mismatches '%1'"), arch));
 		return -1;
 	}
 
+	if (!indexed) {
+		_cache_index.add (path, cache_file, *root);
+	}
+
 	vst2_whitelist (path);
 	psle->set_result (PluginScanLogEntry::OK);
 
 	uint32_t discovered = 0;
-	for (XMLNodeConstIterator i = tree.root()->children().begin(); i != tree.root()->children().end(); ++i) {
+	for (XMLNodeConstIterator i = root->children().begin(); i != root->children().end(); ++i) {
 		try {
 			VST2Info nfo (**i);
 			if (vst2_plugin (path, type, nfo)) {
@@ -1931,22 +2109,77 @@ PluginManager::lxvst_discover_from_path (string path, bool cache_only)
 
 	DEBUG_TRACE (DEBUG::PluginManager, string_compose ("Discovering linuxVST plugins along %1\n", path));
 
-	find_files_matching_filter (plugin_objects, Config->get_plugin_path_lxvst(), lxvst_filter, 0, false, true, true);
+	_cache_index.find_paths (plugin_objects, Config->get_plugin_path_lxvst(), X_("LXVST"), lxvst_filter, true);
 
 	sort (plugin_objects.begin (), plugin_objects.end ());
 	plugin_objects.erase (unique (plugin_objects.begin (), plugin_objects.end ()), plugin_objects.end ());
 
+	/* plugins that were already handled by a parallel scan */
+	std::set<std::string> skip;
+	if (!cache_only && !vst2_scanner_bin_path.empty () && scanner_jobs () > 1) {
+		lxvst_scan_parallel (plugin_objects, skip);
+	}
+
 	size_t n = 1;
 	size_t all_modules = plugin_objects.size ();
 	for (x = plugin_objects.begin(); x != plugin_objects.end (); ++x, ++n) {
 		reset_scan_cancel_state (true);
 		ARDOUR::PluginScanMessage (string_compose (_("VST2 (%1 / %2)"), n, all_modules), *x, !cache_only && !cancelled());
+		if (skip.find (*x) != skip.end ()) {
+			continue;
+		}
 		vst2_discover (*x, LXVST, cache_only || cancelled());
 	}
 
 	return 0;
 }
 
+/* Run the scanner app for all plugins that have no valid cache, several at a time.
+ * Plugins whose scan completes successfully are whitelisted and later read from
+ * the cache by vst2_discover(). All others are added to @a skip.
+ */
+void
+PluginManager::lxvst_scan_parallel (std::vector<std::string> const& plugin_objects, std::set<std::string>& skip)
+{
+	std::vector<ScanJob> jobs;
+	for (auto const& path : plugin_objects) {
+		if (vst2_is_blacklisted (path) || _cache_index.lookup (path, vst2_cache_file (path)) || !vst2_valid_cache_file (path).empty ()) {
+			continue;
+		}
+		jobs.push_back (ScanJob (path, path, scan_log_entry (LXVST, path)));
+	}
+
+	run_scanner_apps (vst2_scanner_bin_path, "VST2", jobs, [] (ScanJob const& job) {
+		job.psle->reset ();
+		vst2_blacklist (job.path);
+	});
+
+	for (auto const& job : jobs) {
+		switch (job.state) {
+			case ScanJob::Pending:
+				break;
+			case ScanJob::Failed:
+				skip.insert (job.path);
+				break;
+			case ScanJob::Aborted:
+				/* may be partially written */
+				g_unlink (vst2_cache_file (job.path).c_str ());
+				vst2_whitelist (job.path);
+				skip.insert (job.path);
+				break;
+			case ScanJob::Done:
+				if (vst2_valid_cache_file (job.path).empty ()) {
+					job.psle->msg (PluginScanLogEntry::Error, _("Scan Failed."));
+					job.psle->msg (PluginScanLogEntry::Blacklisted);
+					skip.insert (job.path);
+				} else {
+					vst2_whitelist (job.path);
+				}
+				break;
+		}
+	}
+}
+
 #endif // LXVST_SUPPORT
 
 void
@@ -2084,12 +2317,18 @@ PluginManager::vst3_discover_from_path (string const& path, bool cache_only)
 
 	vector<string> plugin_objects;
 
-	find_paths_matching_filter (plugin_objects, paths, vst3_filter, 0, false, true, true);
+	_cache_index.find_paths (plugin_objects, paths, X_("VST3"), vst3_filter, false);
 
 #ifndef PLATFORM_WINDOWS
 	std::regex win_vst_regex ("Contents/\\w+-win/");
 #endif
 
+	/* bundles that were already handled by a parallel scan */
+	std::set<std::string> skip;
+	if (!cache_only && !vst3_scanner_bin_path.empty () && scanner_jobs () > 1) {
+		vst3_scan_parallel (plugin_objects, skip);
+	}
+
 	size_t n = 0;
 	size_t all_modules = plugin_objects.size ();
 	for (auto const& path : plugin_objects) {
@@ -2103,12 +2342,75 @@ PluginManager::vst3_discover_from_path (string const& path, bool cache_only)
 			continue;
 		}
 #endif
+		if (skip.find (path) != skip.end ()) {
+			continue;
+		}
 		vst3_discover (path, cache_only || cancelled ());
 	}
 
 	return cancelled() ? -1 : 0;
 }
 
+/* Run the scanner app for all bundles that have no valid cache, several at a time.
+ * Bundles whose scan completes successfully are whitelisted and later read from
+ * the cache by vst3_discover(). All others are added to @a skip.
+ */
+void
+PluginManager::vst3_scan_parallel (std::vector<std::string> const& bundles, std::set<std::string>& skip)
+{
+#ifndef PLATFORM_WINDOWS
+	std::regex win_vst_regex ("Contents/\\w+-win/");
+#endif
+
+	std::vector<ScanJob> jobs;
+	for (auto const& path : bundles) {
+#ifndef PLATFORM_WINDOWS
+		if (std::regex_search (path, win_vst_regex)) {
+			continue;
+		}
+#endif
+		string module_path = module_path_vst3 (path);
+		if (module_path.empty () || module_path == "-1" || vst3_is_blacklisted (module_path)) {
+			continue;
+		}
+		if (_cache_index.lookup (module_path, vst3_cache_file (module_path)) || !vst3_valid_cache_file (module_path).empty ()) {
+			continue;
+		}
+		jobs.push_back (ScanJob (path, module_path, scan_log_entry (VST3, path)));
+	}
+
+	run_scanner_apps (vst3_scanner_bin_path, "VST3", jobs, [] (ScanJob const& job) {
+		job.psle->reset ();
+		vst3_blacklist (job.module_path);
+		job.psle->msg (PluginScanLogEntry::OK, string_compose ("VST3 module-path '%1'", job.module_path));
+	});
+
+	for (auto const& job : jobs) {
+		switch (job.state) {
+			case ScanJob::Pending:
+				break;
+			case ScanJob::Failed:
+				skip.insert (job.path);
+				break;
+			case ScanJob::Aborted:
+				/* may be partially written */
+				g_unlink (vst3_cache_file (job.module_path).c_str ());
+				vst3_whitelist (job.module_path);
+				skip.insert (job.path);
+				break;
+			case ScanJob::Done:
+				if (vst3_valid_cache_file (job.module_path).empty ()) {
+					job.psle->msg (PluginScanLogEntry::Blacklisted);
+					job.psle->msg (PluginScanLogEntry::Error, _("Scan Failed."));
+					skip.insert (job.path);
+				} else {
+					vst3_whitelist (job.module_path);
+				}
+				break;
+		}
+	}
+}
+
 void
 PluginManager::vst3_plugin (string const& module_path, string const& bundle_path, VST3Info const& i)
 {
@@ -2167,7 +2469,14 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 	bool run_scan = false;
 	bool is_new   = false;
 
-	string cache_file = vst3_valid_cache_file (module_path, false, &is_new);
+	/* an up-to-date index entry saves parsing the cache file */
+	string cache_file = vst3_cache_file (module_path);
+	XMLNode const* root = _cache_index.lookup (module_path, cache_file);
+	bool const indexed = root != 0;
+
+	if (!indexed) {
+		cache_file = vst3_valid_cache_file (module_path, false, &is_new);
+	}
 
 	if (!cache_only && vst3_scanner_bin_path.empty () && cache_file.empty ()) {
 		/* scan in host context */
@@ -2186,7 +2495,9 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 	}
 
 	XMLTree tree;
-	if (cache_file.empty ()) {
+	if (indexed) {
+		/* use the indexed copy */
+	} else if (cache_file.empty ()) {
 		run_scan = true;
 	} else if (!tree.read (cache_file)) {
 		/* failed to parse XML */
@@ -2226,8 +2537,12 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 		return -1;
 	}
 
+	if (!indexed) {
+		root = tree.root ();
+	}
+
 	std::string module;
-	if (!tree.root()->get_property ("module", module) || module != module_path) {
+	if (!root->get_property ("module", module) || module != module_path) {
 		psle->msg (PluginScanLogEntry::Error, string_compose (_("Invalid VST3 cache file '%1'"), cache_file));
 		psle->msg (PluginScanLogEntry::Blacklisted);
 		if (!vst3_is_blacklisted (path)) {
@@ -2236,10 +2551,14 @@ PluginManager::vst3_discover (string const& path, bool cache_only)
 		return -1;
 	}
 
+	if (!indexed) {
+		_cache_index.add (module_path, cache_file, *root);
+	}
+
 	vst3_whitelist (module_path);
 	psle->set_result (PluginScanLogEntry::OK);
 
-	for (XMLNodeConstIterator i = tree.root()->children().begin(); i != tree.root()->children().end(); ++i) {
+	for (XMLNodeConstIterator i = root->children().begin(); i != root->children().end(); ++i) {
 		try {
 			VST3Info nfo (**i);
 			vst3_plugin (module_path, path, nfo);
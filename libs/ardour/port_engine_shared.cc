@@ -35,6 +35,7 @@ BackendPort::BackendPort (PortEngineSharedImpl &b, const std::string& name, Port
 	: _backend (b)
 	, _name  (name)
 	, _flags (flags)
+	, _connection_list (new ConnectionList)
 {
 	_capture_latency_range.min = 0;
 	_capture_latency_range.max = 0;
@@ -105,6 +106,21 @@ BackendPort::store_connection (BackendPortHandle port)
 	 */
 	PBD::Mutex::Lock lm (AudioEngine::instance()->process_lock (), PBD::Mutex::TryLock);
 	_connections.insert (port);
+	update_connection_list ();
+}
+
+void
+BackendPort::update_connection_list ()
+{
+	/* ports are only destroyed after they were disconnected, so the
+	 * list does not need to own them
+	 */
+	RCUWriter<ConnectionList> writer (_connection_list);
+	std::shared_ptr<ConnectionList> cl = writer.get_copy ();
+	cl->clear ();
+	for (std::set<BackendPortPtr>::const_iterator i = _connections.begin (); i != _connections.end (); ++i) {
+		cl->push_back (i->get ());
+	}
 }
 
 int
@@ -141,6 +157,7 @@ void BackendPort::remove_connection (BackendPortHandle port)
 	std::set<BackendPortPtr>::iterator it = _connections.find (port);
 	assert (it != _connections.end ());
 	_connections.erase (it);
+	update_connection_list ();
 }
 
 
@@ -158,6 +175,7 @@ void BackendPort::disconnect_all (BackendPortHandle self)
 		_backend.port_connect_callback (name(), (*it)->name(), false);
 		_connections.erase (it);
 	}
+	update_connection_list ();
 }
 
 bool
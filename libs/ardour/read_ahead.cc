@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2026 Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#ifndef PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "pbd/compose.h"
+#include "pbd/debug.h"
+#include "pbd/failed_constructor.h"
+#include "pbd/pthread_utils.h"
+
+#include "ardour/debug.h"
+#include "ardour/read_ahead.h"
+
+using namespace ARDOUR;
+
+/* max number of pending requests */
+static const size_t max_requests = 1024;
+
+ReadAhead::ReadAhead (uint32_t n_threads)
+	: _n_threads (std::max<uint32_t> (1, n_threads))
+	, _enabled (false)
+	, _terminate (false)
+	, _request_sem ("read-ahead", 0)
+{
+}
+
+ReadAhead::~ReadAhead ()
+{
+	_enabled.store (false);
+	_terminate.store (true);
+	for (size_t i = 0; i < _workers.size (); ++i) {
+		_request_sem.signal ();
+	}
+	for (auto const& t : _workers) {
+		pthread_join (t, NULL);
+	}
+#ifndef PLATFORM_WINDOWS
+	for (auto const& r : _requests) {
+		::close (r.fd);
+	}
+#endif
+}
+
+void
+ReadAhead::set_enabled (bool yn)
+{
+#ifdef PLATFORM_WINDOWS
+	yn = false;
+#endif
+	if (yn && _workers.empty ()) {
+		start_threads ();
+	}
+	_enabled.store (yn && !_workers.empty ());
+}
+
+void
+ReadAhead::start_threads ()
+{
+	DEBUG_TRACE (PBD::DEBUG::IOTaskList, string_compose ("ReadAhead starting %1 threads\n", _n_threads));
+
+	for (uint32_t i = 0; i < _n_threads; ++i) {
+		pthread_t t;
+		if (pbd_pthread_create (0, &t, &_worker_thread, this)) {
+			std::cerr << "Failed to start ReadAhead thread\n";
+			break;
+		}
+		_workers.push_back (t);
+	}
+}
+
+bool
+ReadAhead::queue (int fd, int64_t offset, int64_t len)
+{
+#ifdef PLATFORM_WINDOWS
+	return false;
+#else
+	if (!_enabled.load () || len <= 0) {
+		return false;
+	}
+
+	PBD::Mutex::Lock lm (_requests_lock);
+
+	if (_requests.size () >= max_requests) {
+		return false;
+	}
+
+	/* the source may close its file before the request is handled */
+	int dfd = ::dup (fd);
+	if (dfd < 0) {
+		return false;
+	}
+
+	_requests.push_back (Request { dfd, offset, len });
+	lm.release ();
+
+	_request_sem.signal ();
+	return true;
+#endif
+}
+
+void*
+ReadAhead::_worker_thread (void* me)
+{
+	ReadAhead* self = static_cast<ReadAhead*> (me);
+	pthread_set_name ("ReadAhead");
+	self->io_thread ();
+	return 0;
+}
+
+void
+ReadAhead::io_thread ()
+{
+#if !defined PLATFORM_WINDOWS && !defined POSIX_FADV_WILLNEED
+	const size_t bufsize = 262144;
+	char*        buf     = new char[bufsize];
+#endif
+
+	while (1) {
+		_request_sem.wait ();
+		if (_terminate.load ()) {
+			break;
+		}
+
+		PBD::Mutex::Lock lm (_requests_lock);
+		if (_requests.empty ()) {
+			continue;
+		}
+		Request r = _requests.front ();
+		_requests.pop_front ();
+		lm.release ();
+
+#ifndef PLATFORM_WINDOWS
+# ifdef POSIX_FADV_WILLNEED
+		/* initiate non-blocking kernel read-ahead */
+		posix_fadvise (r.fd, r.offset, r.len, POSIX_FADV_WILLNEED);
+# else
+		/* read into the page-cache */
+		for (int64_t off = 0; off < r.len;) {
+			ssize_t n = ::pread (r.fd, buf, std::min<int64_t> (bufsize, r.len - off), r.offset + off);
+			if (n <= 0) {
+				break;
+			}
+			off += n;
+		}
+# endif
+		::close (r.fd);
+#endif
+	}
+
+#if !defined PLATFORM_WINDOWS && !defined POSIX_FADV_WILLNEED
+	delete [] buf;
+#endif
+}
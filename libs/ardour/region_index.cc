@@ -0,0 +1,178 @@
+/*
+ * Copyright (C) 2026 Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#include "ardour/region.h"
+#include "ardour/region_index.h"
+
+using namespace ARDOUR;
+using namespace Temporal;
+
+RegionIndex::Entry::Entry (std::shared_ptr<Region> const& r)
+	: start (r->position ())
+	, end (r->end ())
+	, max_end (end)
+	, region (r)
+{
+}
+
+std::shared_ptr<RegionIndex const>
+RegionIndex::create (RegionList const& rl)
+{
+	std::shared_ptr<RegionIndex> idx (new RegionIndex);
+
+	if (!rl.empty ()) {
+		/* Regions in different time-domains may change their relative
+		 * order when the tempo-map changes.
+		 */
+		TimeDomain const td = rl.front ()->position ().time_domain ();
+		for (auto const& r : rl) {
+			if (r->position ().time_domain () != td || r->length ().time_domain () != td) {
+				return std::shared_ptr<RegionIndex const> ();
+			}
+		}
+	}
+
+	idx->_entries.reserve (rl.size ());
+
+	for (auto const& r : rl) {
+		idx->_entries.push_back (Entry (r));
+		if (r->has_region_fx ()) {
+			idx->_tail_regions.push_back (r);
+		}
+	}
+
+	idx->build ();
+	return idx;
+}
+
+void
+RegionIndex::build ()
+{
+	/* stable, to retain the order of regions with equal position */
+	std::stable_sort (_entries.begin (), _entries.end (), [] (Entry const& a, Entry const& b) { return a.start < b.start; });
+
+	int64_t const n = _entries.size ();
+
+	_max_level = 0;
+
+	if (n == 0) {
+		return;
+	}
+
+	/* Nodes at level k are at indices with the lowest k bits set,
+	 * leaves are at even indices.
+	 */
+	int64_t   last_i = 0;
+	timepos_t last;
+
+	for (int64_t i = 0; i < n; i += 2) {
+		last_i = i;
+		last   = _entries[i].max_end = _entries[i].end;
+	}
+
+	int k;
+	for (k = 1; (int64_t (1) << k) <= n; ++k) {
+		int64_t const x    = int64_t (1) << (k - 1);
+		int64_t const i0   = (x << 1) - 1;
+		int64_t const step = x << 2;
+
+		for (int64_t i = i0; i < n; i += step) {
+			timepos_t const& el = _entries[i - x].max_end;
+			timepos_t const& er = i + x < n ? _entries[i + x].max_end : last;
+			timepos_t        e  = _entries[i].end;
+			if (e < el) {
+				e = el;
+			}
+			if (e < er) {
+				e = er;
+			}
+			_entries[i].max_end = e;
+		}
+
+		/* max_end of the right-most (possibly incomplete) sub-tree */
+		last_i = (last_i >> k & 1) ? last_i - x : last_i + x;
+		if (last_i < n && last < _entries[last_i].max_end) {
+			last = _entries[last_i].max_end;
+		}
+	}
+
+	_max_level = k - 1;
+}
+
+void
+RegionIndex::overlapping (timepos_t const& start, timepos_t const& end, RegionList& rl) const
+{
+	struct StackEntry {
+		int64_t x; // node
+		int     k; // level
+		bool    w; // left child has been processed
+	};
+
+	int64_t const n = _entries.size ();
+
+	if (n == 0) {
+		return;
+	}
+
+	StackEntry stack[64];
+	int        t = 0;
+
+	stack[t++] = { (int64_t (1) << _max_level) - 1, _max_level, false };
+
+	while (t > 0) {
+		StackEntry const z = stack[--t];
+
+		if (z.k <= 3) {
+			/* small sub-tree, linear scan */
+			int64_t const i0 = z.x >> z.k << z.k;
+			int64_t const i1 = std::min (n, i0 + (int64_t (1) << (z.k + 1)) - 1);
+			for (int64_t i = i0; i < i1 && _entries[i].start < end; ++i) {
+				if (start < _entries[i].end) {
+					rl.push_back (_entries[i].region);
+				}
+			}
+		} else if (!z.w) {
+			/* re-visit this node after its left child. The left child may
+			 * be beyond the end (incomplete tree), its sub-tree may not be.
+			 */
+			int64_t const y = z.x - (int64_t (1) << (z.k - 1));
+			stack[t++] = { z.x, z.k, true };
+			if (y >= n || start < _entries[y].max_end) {
+				stack[t++] = { y, z.k - 1, false };
+			}
+		} else if (z.x < n && _entries[z.x].start < end) {
+			if (start < _entries[z.x].end) {
+				rl.push_back (_entries[z.x].region);
+			}
+			stack[t++] = { z.x + (int64_t (1) << (z.k - 1)), z.k - 1, false };
+		}
+	}
+}
+
+void
+RegionIndex::starting_within (timepos_t const& start, timepos_t const& end, RegionList& rl) const
+{
+	std::vector<Entry>::const_iterator i = std::lower_bound (_entries.begin (), _entries.end (), start,
+	                                                          [] (Entry const& e, timepos_t const& p) { return e.start < p; });
+
+	for (; i != _entries.end () && i->start < end; ++i) {
+		rl.push_back (i->region);
+	}
+}
@@ -82,6 +82,7 @@
 #include "ardour/graph.h"
 #include "ardour/io_plug.h"
 #include "ardour/io_tasklist.h"
+#include "ardour/read_ahead.h"
 #include "ardour/luabindings.h"
 #include "ardour/lv2_plugin.h"
 #include "ardour/midiport_manager.h"
@@ -624,6 +625,7 @@ Session::immediately_post_engine ()
 	_rt_tasklist.reset (new RTTaskList (_process_graph));
 
 	_io_tasklist.reset (new IOTaskList (how_many_io_threads ()));
+	_read_ahead.reset (new ReadAhead (how_many_io_threads ()));
 
 	/* every time we reconnect, recompute worst case output latencies */
 
@@ -759,6 +761,7 @@ Session::destroy ()
 	_io_graph_chain[1].reset ();
 
 	_io_tasklist.reset ();
+	_read_ahead.reset ();
 
 	_butler->drop_references ();
 	delete _butler;
@@ -6852,6 +6855,24 @@ Session::plot_process_graph (std::string const& file_name) const {
 	return _graph_chain ? _graph_chain->plot (file_name) : false;
 }
 
+void
+Session::process_graph_thread_stats (std::vector<GraphThreadStats>& stats) const
+{
+	if (_process_graph) {
+		_process_graph->thread_stats (stats);
+	} else {
+		stats.clear ();
+	}
+}
+
+void
+Session::reset_process_graph_thread_stats ()
+{
+	if (_process_graph) {
+		_process_graph->reset_thread_stats ();
+	}
+}
+
 void
 Session::add_automation_list(AutomationList *al)
 {
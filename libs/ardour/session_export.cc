@@ -458,6 +458,10 @@ Session::finalize_audio_export (TransportRequestSource trs)
 
 	/* maybe write CUE/TOC */
 
+	if (export_status && !export_status->aborted () && export_status->processed_samples > 0) {
+		info << string_compose (_("Export finished at %1x realtime"), export_status->realtime_factor (nominal_sample_rate ())) << endmsg;
+	}
+
 	export_handler.reset();
 	export_status.reset();
 
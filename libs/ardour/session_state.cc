@@ -119,6 +119,7 @@
 #include "ardour/port.h"
 #include "ardour/processor.h"
 #include "ardour/profile.h"
+#include "ardour/read_ahead.h"
 #include "ardour/proxy_controllable.h"
 #include "ardour/recent_sessions.h"
 #include "ardour/region_factory.h"
@@ -687,6 +688,8 @@ Session::remove_pending_capture_state ()
 
 	pending_state_file_path = Glib::build_filename (pending_state_file_path, legalize_for_path (_current_snapshot_name + pending_suffix));
 
+	_state_journal.discard (pending_state_file_path + journal_suffix);
+
 	if (!Glib::file_test (pending_state_file_path, Glib::FILE_TEST_EXISTS)) {
 		return;
 	}
@@ -849,6 +852,9 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		tree.set_root (&state (false, fork_state, for_archive, only_used_assets));
 	}
 
+	/* templates and archives are meant to be shared, keep those as XML */
+	tree.set_binary (Config->get_save_binary_state () && !template_only && !for_archive);
+
 	if (snapshot_name.empty()) {
 		snapshot_name = _current_snapshot_name;
 	} else if (switch_to_snapshot) {
@@ -874,6 +880,12 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		assert (snapshot_name == _current_snapshot_name);
 		/* pending save: use pending_suffix (.pending in English) */
 		xml_path = Glib::build_filename (xml_path, legalize_for_path (snapshot_name + pending_suffix));
+
+		/* only journal what changed since the last pending save, if possible */
+		if (Config->get_save_incremental_state () && _state_journal.append (*tree.root (), xml_path + journal_suffix)) {
+			DEBUG_TRACE (DEBUG::SaveState, string_compose ("appended state to '%1'\n", xml_path + journal_suffix));
+			return 0;
+		}
 	}
 
 	std::string tmp_path(_session_dir->root_path());
@@ -893,6 +905,17 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 
 		DEBUG_TRACE (DEBUG::SaveState, string_compose ("renaming state to '%1'\n", xml_path));
 
+		/* the journal must not outlive the state it is based on,
+		 * or a crash before it is reset would replay it onto the new state.
+		 */
+		if (pending && !_state_journal.discard (xml_path + journal_suffix)) {
+			if (g_remove (tmp_path.c_str()) != 0) {
+				error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
+						tmp_path, g_strerror (errno)) << endmsg;
+			}
+			return -1;
+		}
+
 		if (::g_rename (tmp_path.c_str(), xml_path.c_str()) != 0) {
 			error << string_compose (_("could not rename temporary session file %1 to %2 (%3)"),
 					tmp_path, xml_path, g_strerror(errno)) << endmsg;
@@ -904,6 +927,15 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		}
 	}
 
+	if (pending) {
+		/* the full state is the base of all further pending saves */
+		std::string const journal_path = xml_path + journal_suffix;
+		if (Config->get_save_incremental_state ()) {
+			GStatBuf statbuf;
+			_state_journal.reset (*tree.root (), journal_path, g_stat (xml_path.c_str (), &statbuf) == 0 ? statbuf.st_size : 0);
+		}
+	}
+
 	//Mixbus auto-backup mechanism
 	if(Profile->get_mixbus()) {
 		if (pending) {  //"pending" save means it's a backup, or some other non-user-initiated save;  a good time to make a backup
@@ -1035,6 +1067,17 @@ Session::load_state (string snapshot_name, bool from_template)
 		return -1;
 	}
 
+	if (state_was_pending && Glib::file_test (xmlpath + journal_suffix, Glib::FILE_TEST_IS_REGULAR)) {
+		/* apply changes saved after the last full pending state */
+		GStatBuf statbuf;
+		int const records = g_stat (xmlpath.c_str (), &statbuf) == 0 ? StateJournal::replay (*state_tree->root(), xmlpath + journal_suffix, statbuf.st_size) : -1;
+		if (records < 0) {
+			warning << string_compose (_("Could not recover changes from %1, using older state"), xmlpath + journal_suffix) << endmsg;
+		} else {
+			DEBUG_TRACE (DEBUG::SaveState, string_compose ("replayed %1 journal records\n", records));
+		}
+	}
+
 	std::string version;
 	root.get_property ("version", version);
 	Stateful::loading_state_version = parse_stateful_loading_version (version);
@@ -4943,6 +4986,10 @@ Session::config_changed (std::string p, bool ours)
 				remove_surround_master ();
 			}
 		}
+	} else if (p == "async-disk-read") {
+		if (_read_ahead) {
+			_read_ahead->set_enabled (config.get_async_disk_read ());
+		}
 	} else if (p == "loop-fade-choice") {
 		last_loopend = 0; /* force locate to refill buffers with new loop boundary data */
 		auto_loop_changed (_locations->auto_loop_location());
@@ -5285,36 +5332,25 @@ Session::get_info_from_path (const string& xmlpath, float& sample_rate, SampleFo
 		return -1;
 	}
 
-	xmlParserCtxtPtr ctxt = xmlNewParserCtxt();
-	if (ctxt == NULL) {
-		return -2;
-	}
-	xmlDocPtr doc = xmlCtxtReadFile (ctxt, xmlpath.c_str(), NULL, XML_PARSE_HUGE);
-
-	if (doc == NULL) {
-		xmlFreeParserCtxt(ctxt);
+	/* XMLTree also handles the binary encoding, see save-binary-state */
+	XMLTree tree;
+	if (!tree.read (xmlpath)) {
 		return -2;
 	}
 
-	xmlNodePtr node = xmlDocGetRootElement(doc);
+	XMLNode const* root = tree.root ();
 
-	if (node == NULL) {
-		xmlFreeParserCtxt(ctxt);
-		xmlFreeDoc (doc);
+	if (!root) {
 		return -2;
 	}
 
 	/* sample rate & version*/
 
-	xmlAttrPtr attr;
-	for (attr = node->properties; attr; attr = attr->next) {
-		if (!strcmp ((const char*)attr->name, "version") && attr->children) {
-			version = std::string ((char*)attr->children->content);
-		}
-		if (!strcmp ((const char*)attr->name, "sample-rate") && attr->children) {
-			sample_rate = atoi ((char*)attr->children->content);
-			found_sr = true;
-		}
+	std::string sr;
+	root->get_property (X_("version"), version);
+	if (root->get_property (X_("sample-rate"), sr)) {
+		sample_rate = atoi (sr.c_str ());
+		found_sr = true;
 	}
 
 	if ((parse_stateful_loading_version(version) / 1000L) > (CURRENT_SESSION_FILE_VERSION / 1000L)) {
@@ -5327,63 +5363,48 @@ Session::get_info_from_path (const string& xmlpath, float& sample_rate, SampleFo
 		found_data_format = true;
 	}
 
-	node = node->children;
-	while (node != NULL) {
-		 if (!strcmp((const char*) node->name, "ProgramVersion")) {
-			 xmlChar* val = xmlGetProp (node, (const xmlChar*)"modified-with");
-			 if (val) {
-				 program_version = string ((const char*)val);
-				 size_t sep = program_version.find_first_of("-");
-				 if (sep != string::npos) {
-					 program_version = program_version.substr (0, sep);
-				 }
-			 }
-			 xmlFree (val);
-		 }
-		 if (engine_hints && strcmp((const char*) node->name, "EngineHints") == 0)  {
-			 xmlChar* val = xmlGetProp (node, (const xmlChar*)"backend");
-			 if (val) {
-				 engine_hints->set_property ("backend", (const char*)val);
-			 }
-			 xmlFree (val);
-			 val = xmlGetProp (node, (const xmlChar*)"input-device");
-			 if (val) {
-				 engine_hints->set_property ("input-device", (const char*)val);
-			 }
-			 xmlFree (val);
-			 val = xmlGetProp (node, (const xmlChar*)"output-device");
-			 if (val) {
-				 engine_hints->set_property ("output-device", (const char*)val);
-			 }
-			 xmlFree (val);
-		 }
-
-		 if (strcmp((const char*) node->name, "Config")) {
-			 node = node->next;
-			 continue;
-		 }
-		 for (node = node->children; node; node = node->next) {
-			 xmlChar* pv = xmlGetProp (node, (const xmlChar*)"name");
-			 if (pv && !strcmp ((const char*)pv, "native-file-data-format")) {
-				 xmlFree (pv);
-				 xmlChar* val = xmlGetProp (node, (const xmlChar*)"value");
-				 if (val) {
-					 try {
-						 SampleFormat fmt = (SampleFormat) string_2_enum (string ((const char*)val), fmt);
-						 data_format = fmt;
-						 found_data_format = true;
-					 } catch (PBD::unknown_enumeration& e) {}
-				 }
-				 xmlFree (val);
-				 break;
-			 }
-			 xmlFree (pv);
-		 }
-		 break;
-	}
-
-	xmlFreeParserCtxt(ctxt);
-	xmlFreeDoc (doc);
+	for (XMLNodeConstIterator i = root->children ().begin (); i != root->children ().end (); ++i) {
+		XMLNode const* node = *i;
+		std::string    val;
+
+		if (node->name () == X_("ProgramVersion")) {
+			if (node->get_property (X_("modified-with"), program_version)) {
+				size_t sep = program_version.find_first_of("-");
+				if (sep != string::npos) {
+					program_version = program_version.substr (0, sep);
+				}
+			}
+		}
+		if (engine_hints && node->name () == X_("EngineHints")) {
+			if (node->get_property (X_("backend"), val)) {
+				engine_hints->set_property ("backend", val);
+			}
+			if (node->get_property (X_("input-device"), val)) {
+				engine_hints->set_property ("input-device", val);
+			}
+			if (node->get_property (X_("output-device"), val)) {
+				engine_hints->set_property ("output-device", val);
+			}
+		}
+
+		if (node->name () != X_("Config")) {
+			continue;
+		}
+		for (XMLNodeConstIterator c = node->children ().begin (); c != node->children ().end (); ++c) {
+			if (!(*c)->get_property (X_("name"), val) || val != X_("native-file-data-format")) {
+				continue;
+			}
+			if ((*c)->get_property (X_("value"), val)) {
+				try {
+					SampleFormat fmt = (SampleFormat) string_2_enum (val, fmt);
+					data_format = fmt;
+					found_data_format = true;
+				} catch (PBD::unknown_enumeration& e) {}
+			}
+			break;
+		}
+		break;
+	}
 
 	return (found_sr && found_data_format) ? 0 : 1;
 }
@@ -5552,6 +5573,7 @@ Session::save_as (SaveAs& saveas)
 	vector<string> do_not_copy_extensions;
 	do_not_copy_extensions.push_back (statefile_suffix);
 	do_not_copy_extensions.push_back (pending_suffix);
+	do_not_copy_extensions.push_back (journal_suffix);
 	do_not_copy_extensions.push_back (backup_suffix);
 	do_not_copy_extensions.push_back (temp_suffix);
 	do_not_copy_extensions.push_back (history_suffix);
@@ -6044,6 +6066,7 @@ Session::archive_session (const std::string& dest,
 	vector<string> do_not_copy_extensions;
 	do_not_copy_extensions.push_back (statefile_suffix);
 	do_not_copy_extensions.push_back (pending_suffix);
+	do_not_copy_extensions.push_back (journal_suffix);
 	do_not_copy_extensions.push_back (backup_suffix);
 	do_not_copy_extensions.push_back (temp_suffix);
 	do_not_copy_extensions.push_back (history_suffix);
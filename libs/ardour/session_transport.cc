@@ -1341,7 +1341,9 @@ Session::non_realtime_locate ()
 		std::shared_ptr<IOTaskList> tl = io_tasklist ();
 		for (auto const& i : *rl) {
 			++nt;
-			tl->push_back ([this, i, tf, sc]() { if (sc == _seek_counter.load ()) { i->non_realtime_locate (tf); }});
+			/* start with tracks that were slowest to refill */
+			std::shared_ptr<Track> tr = std::dynamic_pointer_cast<Track> (i);
+			tl->push_back ([this, i, tf, sc]() { if (sc == _seek_counter.load ()) { i->non_realtime_locate (tf); }}, tr ? tr->last_refill_time () : 0);
 		}
 		tl->process ();
 		if (sc != _seek_counter.load ()) {
@@ -1591,6 +1593,7 @@ Session::non_realtime_stop (bool abort, int on_entry, bool& finished, bool will_
 
 		std::atomic<bool> fini (finished);
 		for (auto const& i : *r) {
+			std::shared_ptr<Track> tr = std::dynamic_pointer_cast<Track> (i);
 			tl->push_back ([this, i, on_entry, &fini]() {
 				if (!fini.load ()) {
 					return;
@@ -1600,7 +1603,7 @@ Session::non_realtime_stop (bool abort, int on_entry, bool& finished, bool will_
 				if (on_entry != _butler->should_do_transport_work.load()) {
 					fini = false;
 				}
-			});
+			}, tr ? tr->last_refill_time () : 0);
 		}
 		tl->process ();
 		if (!fini.load ()) {
@@ -34,6 +34,10 @@
 
 #include <sys/stat.h>
 
+#ifndef PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
 #include <glib.h>
 #include "pbd/gstdio_compat.h"
 #include "pbd/progress.h"
@@ -48,6 +52,7 @@
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
+#include "ardour/read_ahead.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
@@ -342,6 +347,10 @@ SndFileSource::init_sndfile ()
 
 	memset (&_info, 0, sizeof(_info));
 
+	_fd          = -1;
+	_block_width = 0;
+	_data_offset = -1;
+
 	AudioFileSource::HeaderPositionOffsetChanged.connect_same_thread (header_position_connection, std::bind (&SndFileSource::handle_header_position_change, this));
 }
 
@@ -391,6 +400,46 @@ SndFileSource::open ()
 		return -1;
 	}
 
+	_fd          = fd;
+	_data_offset = -1;
+
+	/* uncompressed files have a fixed size per sample */
+	switch (_info.format & SF_FORMAT_TYPEMASK) {
+		case SF_FORMAT_WAV:
+		case SF_FORMAT_WAVEX:
+		case SF_FORMAT_RF64:
+		case SF_FORMAT_W64:
+		case SF_FORMAT_AIFF:
+		case SF_FORMAT_CAF:
+			switch (_info.format & SF_FORMAT_SUBMASK) {
+				case SF_FORMAT_PCM_S8:
+				case SF_FORMAT_PCM_U8:
+					_block_width = 1;
+					break;
+				case SF_FORMAT_PCM_16:
+					_block_width = 2;
+					break;
+				case SF_FORMAT_PCM_24:
+					_block_width = 3;
+					break;
+				case SF_FORMAT_PCM_32:
+				case SF_FORMAT_FLOAT:
+					_block_width = 4;
+					break;
+				case SF_FORMAT_DOUBLE:
+					_block_width = 8;
+					break;
+				default:
+					_block_width = 0;
+					break;
+			}
+			break;
+		default:
+			_block_width = 0;
+			break;
+	}
+	_block_width *= _info.channels;
+
 	if (_channel >= _info.channels) {
 #ifndef HAVE_COREAUDIO
 		error << string_compose(_("SndFileSource: file only contains %1 channels; %2 is invalid as a channel number"), _info.channels, _channel) << endmsg;
@@ -561,6 +610,8 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 			return 0;
 		}
 
+		queue_read_ahead (start, cnt);
+
 		if (_info.channels == 1) {
 			samplecnt_t ret = sf_read_float (_sndfile, dst, file_cnt);
 			if (ret != file_cnt) {
@@ -602,6 +653,41 @@ SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) c
 	return nread;
 }
 
+void
+SndFileSource::queue_read_ahead (samplepos_t start, samplecnt_t cnt) const
+{
+#ifndef PLATFORM_WINDOWS
+	if (_block_width == 0 || writable ()) {
+		return;
+	}
+
+	std::shared_ptr<ReadAhead> ra = _session.read_ahead ();
+	if (!ra || !ra->enabled ()) {
+		return;
+	}
+
+	if (_data_offset < 0) {
+		/* called directly after sf_seek (start), which positions the
+		 * file at the first byte of the given sample.
+		 */
+		off_t pos = ::lseek (_fd, 0, SEEK_CUR);
+		if (pos < 0) {
+			_block_width = 0;
+			return;
+		}
+		_data_offset = pos - (int64_t) start * _block_width;
+	}
+
+	/* assume sequential reads, queue the block after this one */
+	samplepos_t next = start + cnt;
+	samplecnt_t len  = std::min<samplecnt_t> (cnt, _length.samples () - next);
+
+	if (len > 0) {
+		ra->queue (_fd, _data_offset + (int64_t) next * _block_width, (int64_t) len * _block_width);
+	}
+#endif
+}
+
 samplecnt_t
 SndFileSource::write_unlocked (Sample const * data, samplecnt_t cnt)
 {
@@ -114,5 +114,74 @@ x86_sse_find_peaks(const ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float *
 	_mm_store_ss(max, work);
 }
 
+/* 1-pole low-pass gain ramp, using the closed form
+ * g[i] = target + (initial - target) * (1 - coeff)^i
+ * to process 4 samples in parallel.
+ */
+float
+x86_sse_apply_gain_ramp (float* buf, uint32_t nframes, float initial, float target, float coeff)
+{
+	const float k = 1.f - coeff;
+
+	if (nframes >= 4) {
+		const float k2 = k * k;
+		const float d  = initial - target;
+
+		__m128 vt = _mm_set1_ps (target);
+		__m128 vk = _mm_set1_ps (k2 * k2);
+		__m128 vd = _mm_set_ps (d * k2 * k, d * k2, d * k, d);
+
+		while (nframes >= 4) {
+			__m128 x = _mm_loadu_ps (buf);
+			x = _mm_mul_ps (x, _mm_add_ps (vt, vd));
+			_mm_storeu_ps (buf, x);
+			vd = _mm_mul_ps (vd, vk);
+			buf += 4;
+			nframes -= 4;
+		}
+
+		initial = target + _mm_cvtss_f32 (vd);
+	}
 
+	while (nframes > 0) {
+		*buf++ *= initial;
+		initial += coeff * (target - initial);
+		--nframes;
+	}
+
+	return initial;
+}
+
+void
+x86_sse_apply_gain_vector_to_buffer (float* buf, float const* gain, uint32_t nframes)
+{
+	while (nframes >= 4) {
+		_mm_storeu_ps (buf, _mm_mul_ps (_mm_loadu_ps (buf), _mm_loadu_ps (gain)));
+		buf += 4;
+		gain += 4;
+		nframes -= 4;
+	}
 
+	while (nframes > 0) {
+		*buf++ *= *gain++;
+		--nframes;
+	}
+}
+
+void
+x86_sse_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes)
+{
+	while (nframes >= 4) {
+		__m128 x = _mm_mul_ps (_mm_loadu_ps (src), _mm_loadu_ps (gain));
+		_mm_storeu_ps (dst, _mm_add_ps (_mm_loadu_ps (dst), x));
+		dst += 4;
+		src += 4;
+		gain += 4;
+		nframes -= 4;
+	}
+
+	while (nframes > 0) {
+		*dst++ += *src++ * *gain++;
+		--nframes;
+	}
+}
@@ -0,0 +1,454 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+#include <glibmm/fileutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+#include "pbd/xml++.h"
+
+#include "ardour/state_journal.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+using std::string;
+
+/* write a full state file after this many journal records */
+static const uint32_t max_records = 100;
+
+static const uint64_t hash_seed = 14695981039346656037ULL;
+
+StateJournal::StateJournal ()
+	: _valid (false)
+	, _root_hash (0)
+	, _base_size (0)
+	, _journal_size (0)
+	, _records (0)
+{
+}
+
+void
+StateJournal::invalidate ()
+{
+	_valid = false;
+	_entries.clear ();
+	_order.clear ();
+	_containers.clear ();
+}
+
+string
+StateJournal::unit_id (string const& parent, string const& key)
+{
+	return parent + '/' + key;
+}
+
+uint64_t
+StateJournal::hash (XMLNode const& node, uint64_t h)
+{
+	/* FNV-1a, nodes and properties are terminated by distinct bytes */
+	static const uint64_t prime = 1099511628211ULL;
+
+	string const& s (node.is_content () ? node.content () : node.name ());
+	for (string::const_iterator i = s.begin (); i != s.end (); ++i) {
+		h = (h ^ (uint8_t) *i) * prime;
+	}
+	h = (h ^ 0x01) * prime;
+
+	for (XMLPropertyConstIterator p = node.properties ().begin (); p != node.properties ().end (); ++p) {
+		for (string::const_iterator i = (*p)->name ().begin (); i != (*p)->name ().end (); ++i) {
+			h = (h ^ (uint8_t) *i) * prime;
+		}
+		h = (h ^ 0x02) * prime;
+		for (string::const_iterator i = (*p)->value ().begin (); i != (*p)->value ().end (); ++i) {
+			h = (h ^ (uint8_t) *i) * prime;
+		}
+		h = (h ^ 0x03) * prime;
+	}
+
+	for (XMLNodeConstIterator c = node.children ().begin (); c != node.children ().end (); ++c) {
+		h = hash (**c, h);
+	}
+
+	return (h ^ 0x04) * prime;
+}
+
+uint64_t
+StateJournal::root_hash (XMLNode const& root)
+{
+	XMLNode props (root.name ());
+	for (XMLPropertyConstIterator p = root.properties ().begin (); p != root.properties ().end (); ++p) {
+		props.set_property ((*p)->name ().c_str (), (*p)->value ());
+	}
+	return hash (props, hash_seed);
+}
+
+void
+StateJournal::collect (XMLNode const& root, Units& units, std::set<string>& containers)
+{
+	std::map<string, uint32_t> name_count;
+
+	for (XMLNodeConstIterator i = root.children ().begin (); i != root.children ().end (); ++i) {
+		XMLNode const& node (**i);
+
+		if (node.is_content ()) {
+			continue;
+		}
+
+		uint32_t const n = name_count[node.name ()]++;
+		string const key = n == 0 ? node.name () : string_compose ("%1#%2", node.name (), n);
+
+		/* a container is split when all of its children can be
+		 * identified by a unique id, and it has nothing else to save.
+		 */
+		bool split = n == 0 && node.properties ().empty () && !node.children ().empty ();
+		std::set<string> ids;
+
+		for (XMLNodeConstIterator c = node.children ().begin (); split && c != node.children ().end (); ++c) {
+			XMLProperty const* id = (*c)->property (X_("id"));
+			split = !(*c)->is_content () && id && ids.insert (id->value ()).second;
+		}
+
+		/* containers are listed as well, with a null node, to track
+		 * the order of top-level nodes.
+		 */
+		units.push_back (Unit (string (), key, split ? 0 : &node, split ? 0 : hash (node, hash_seed)));
+
+		if (!split) {
+			continue;
+		}
+
+		containers.insert (key);
+
+		for (XMLNodeConstIterator c = node.children ().begin (); c != node.children ().end (); ++c) {
+			units.push_back (Unit (key, (*c)->property (X_("id"))->value (), *c, hash (**c, hash_seed)));
+		}
+	}
+}
+
+void
+StateJournal::set_base (Units const& units, std::set<string> const& containers, XMLNode const& root)
+{
+	_entries.clear ();
+	_order.clear ();
+
+	for (Units::const_iterator u = units.begin (); u != units.end (); ++u) {
+		string const id = unit_id (u->parent, u->key);
+		_order.push_back (id);
+		_entries[id] = Entry (u->node ? u->node->name () : u->key, u->hash);
+	}
+
+	_containers = containers;
+	_root_hash = root_hash (root);
+}
+
+bool
+StateJournal::discard (string const& path)
+{
+	invalidate ();
+
+	if (Glib::file_test (path, Glib::FILE_TEST_EXISTS) && ::g_unlink (path.c_str ()) != 0) {
+		error << string_compose (_("Could not remove state journal at path \"%1\" (%2)"), path, g_strerror (errno)) << endmsg;
+		return false;
+	}
+	return true;
+}
+
+void
+StateJournal::reset (XMLNode const& root, string const& path, size_t base_size)
+{
+	if (!discard (path)) {
+		return;
+	}
+
+	Units units;
+	std::set<string> containers;
+	collect (root, units, containers);
+	set_base (units, containers, root);
+
+	_valid        = true;
+	_path         = path;
+	_base_size    = base_size;
+	_journal_size = 0;
+	_records      = 0;
+}
+
+bool
+StateJournal::append (XMLNode const& root, string const& path)
+{
+	if (!_valid || path != _path || _records >= max_records || _journal_size > _base_size / 2) {
+		return false;
+	}
+
+	Units units;
+	std::set<string> containers;
+	collect (root, units, containers);
+
+	if (containers != _containers) {
+		return false;
+	}
+
+	/* replay can only replace nodes in place, append nodes at the end
+	 * of their parent, and remove children of containers. Anything else
+	 * (reordering, removing top-level nodes) needs a full save.
+	 */
+	std::set<string> current;
+	for (Units::const_iterator u = units.begin (); u != units.end (); ++u) {
+		current.insert (unit_id (u->parent, u->key));
+	}
+
+	std::vector<string> retained;
+	for (std::vector<string>::const_iterator i = _order.begin (); i != _order.end (); ++i) {
+		if (current.find (*i) != current.end ()) {
+			retained.push_back (*i);
+		} else if (i->at (0) == '/') {
+			return false;
+		}
+	}
+
+	std::vector<string>::const_iterator r = retained.begin ();
+	std::set<string> appended_to;
+
+	for (Units::const_iterator u = units.begin (); u != units.end (); ++u) {
+		string const id = unit_id (u->parent, u->key);
+		if (_entries.find (id) == _entries.end ()) {
+			appended_to.insert (u->parent);
+			continue;
+		}
+		if (r == retained.end () || *r != id || appended_to.find (u->parent) != appended_to.end ()) {
+			return false;
+		}
+		++r;
+	}
+
+	XMLNode* delta = new XMLNode (X_("Delta"));
+	bool changed = false;
+
+	uint64_t const rh = root_hash (root);
+	if (rh != _root_hash) {
+		XMLNode* props = delta->add_child (X_("Root"));
+		for (XMLPropertyConstIterator p = root.properties ().begin (); p != root.properties ().end (); ++p) {
+			props->set_property ((*p)->name ().c_str (), (*p)->value ());
+		}
+		changed = true;
+	}
+
+	for (Units::const_iterator u = units.begin (); u != units.end (); ++u) {
+		if (!u->node) {
+			continue;
+		}
+		Entries::const_iterator e = _entries.find (unit_id (u->parent, u->key));
+		if (e != _entries.end () && e->second.hash == u->hash) {
+			continue;
+		}
+		XMLNode* n = delta->add_child (X_("Node"));
+		n->set_property (X_("parent"), u->parent);
+		n->set_property (X_("key"), u->key);
+		n->add_child_copy (*u->node);
+		changed = true;
+	}
+
+	for (std::vector<string>::const_iterator i = _order.begin (); i != _order.end (); ++i) {
+		if (current.find (*i) != current.end ()) {
+			continue;
+		}
+		string::size_type const sep = i->find ('/');
+		XMLNode* n = delta->add_child (X_("Remove"));
+		n->set_property (X_("parent"), i->substr (0, sep));
+		n->set_property (X_("key"), i->substr (sep + 1));
+		n->set_property (X_("name"), _entries[*i].name);
+		changed = true;
+	}
+
+	if (!changed) {
+		delete delta;
+		return true;
+	}
+
+	XMLTree tree;
+	tree.set_root (delta);
+	string const& buf (tree.write_buffer ());
+
+	FILE* f = g_fopen (path.c_str (), "ab");
+	if (!f) {
+		error << string_compose (_("Could not open state journal at path \"%1\" (%2)"), path, g_strerror (errno)) << endmsg;
+		invalidate ();
+		return false;
+	}
+
+	/* each record is its size and the size of the base state file in
+	 * decimal, a newline, and an XML document
+	 */
+	bool ok = fprintf (f, "%zu %zu\n", buf.size (), _base_size) > 0 && fwrite (buf.data (), 1, buf.size (), f) == buf.size ();
+	ok = fclose (f) == 0 && ok;
+
+	if (!ok) {
+		error << string_compose (_("Could not write state journal at path \"%1\" (%2)"), path, g_strerror (errno)) << endmsg;
+		invalidate ();
+		return false;
+	}
+
+	set_base (units, containers, root);
+	_journal_size += buf.size ();
+	++_records;
+
+	return true;
+}
+
+XMLNode*
+StateJournal::top_level (XMLNode& root, string const& key)
+{
+	string name (key);
+	uint32_t n = 0;
+
+	string::size_type const sep = key.find ('#');
+	if (sep != string::npos) {
+		name = key.substr (0, sep);
+		n = atoi (key.c_str () + sep + 1);
+	}
+
+	XMLNodeList const& children (root.children (name));
+	for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i, --n) {
+		if (n == 0) {
+			return *i;
+		}
+	}
+	return 0;
+}
+
+void
+StateJournal::apply (XMLNode& root, XMLNode const& delta)
+{
+	for (XMLNodeConstIterator i = delta.children ().begin (); i != delta.children ().end (); ++i) {
+		XMLNode const& change (**i);
+		string parent;
+		string key;
+
+		if (change.name () == X_("Root")) {
+			for (XMLPropertyConstIterator p = change.properties ().begin (); p != change.properties ().end (); ++p) {
+				root.set_property ((*p)->name ().c_str (), (*p)->value ());
+			}
+			continue;
+		}
+
+		if (!change.get_property (X_("parent"), parent) || !change.get_property (X_("key"), key)) {
+			continue;
+		}
+
+		if (change.name () == X_("Remove")) {
+			string name;
+			XMLNode* container = top_level (root, parent);
+			if (container && change.get_property (X_("name"), name)) {
+				container->remove_node_and_delete (name, X_("id"), key);
+			}
+			continue;
+		}
+
+		if (change.name () != X_("Node") || change.children ().empty ()) {
+			continue;
+		}
+
+		XMLNode const& node (*change.children ().front ());
+		XMLNode* old = 0;
+
+		if (parent.empty ()) {
+			old = top_level (root, key);
+			if (!old) {
+				root.add_child_copy (node);
+				continue;
+			}
+		} else {
+			XMLNode* container = top_level (root, parent);
+			if (!container) {
+				container = root.add_child (parent.c_str ());
+			}
+			for (XMLNodeConstIterator c = container->children ().begin (); c != container->children ().end (); ++c) {
+				if ((*c)->has_property_with_value (X_("id"), key)) {
+					old = *c;
+					break;
+				}
+			}
+			if (!old) {
+				container->add_child_copy (node);
+				continue;
+			}
+		}
+
+		*old = node;
+	}
+}
+
+int
+StateJournal::replay (XMLNode& root, string const& path, size_t base_size)
+{
+	gchar* contents;
+	gsize  length;
+	GError* err = 0;
+
+	if (!g_file_get_contents (path.c_str (), &contents, &length, &err)) {
+		error << string_compose (_("Could not read state journal at path \"%1\" (%2)"), path, err->message) << endmsg;
+		g_error_free (err);
+		return -1;
+	}
+
+	int records = 0;
+	gsize pos = 0;
+
+	/* a record that was not completely written (crash during a save) ends the journal */
+	while (pos < length) {
+		char const* nl = (char const*) memchr (contents + pos, '\n', length - pos);
+		if (!nl) {
+			break;
+		}
+		char* end;
+		unsigned long long const size = strtoull (contents + pos, &end, 10);
+		if (*end != ' ' || !g_ascii_isdigit (end[1])) {
+			break;
+		}
+		unsigned long long const base = strtoull (end + 1, &end, 10);
+		if (end != nl || size == 0 || size > length - (nl + 1 - contents)) {
+			break;
+		}
+
+		if (base != base_size) {
+			/* left over from an older state file */
+			warning << string_compose (_("Ignoring stale state journal at path \"%1\""), path) << endmsg;
+			break;
+		}
+
+		string const record (nl + 1, size);
+		pos = (nl + 1 - contents) + size;
+
+		XMLTree tree;
+		if (!tree.read_buffer (record.c_str ()) || !tree.root () || tree.root ()->name () != X_("Delta")) {
+			break;
+		}
+
+		apply (root, *tree.root ());
+		++records;
+	}
+
+	g_free (contents);
+	return records;
+}
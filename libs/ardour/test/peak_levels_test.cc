@@ -0,0 +1,151 @@
+#ifdef COMPILER_MSVC
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/gstdio_compat.h"
+
+#include "ardour/audiofilesource.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session.h"
+#include "ardour/session_directory.h"
+#include "ardour/source_factory.h"
+
+#include "peak_levels_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PeakLevelsTest);
+
+using namespace std;
+using namespace ARDOUR;
+
+/* peak-file data, and the coarsest level (256 * 4^6 samples per peak) */
+static const samplecnt_t fpp = 256;
+static const int n_levels = 6;
+static const samplecnt_t signal_length = 4 * (fpp << (2 * n_levels));
+
+void
+PeakLevelsTest::setUp ()
+{
+	TestNeedingSession::setUp ();
+
+	_use_peak_levels = Config->get_use_peak_levels ();
+	_build_peakfiles = AudioFileSource::get_build_peakfiles ();
+	Config->set_use_peak_levels (true);
+	AudioFileSource::set_build_peakfiles (true);
+
+	std::string const path = Glib::build_filename (new_test_output_dir (), "peak_levels.wav");
+	_source = std::dynamic_pointer_cast<AudioSource> (SourceFactory::createWritable (DataType::AUDIO, *_session, path, get_test_sample_rate ()));
+	CPPUNIT_ASSERT (_source);
+
+	/* a waveform that differs between all peaks of all levels */
+	const samplecnt_t block = 65536;
+	std::unique_ptr<Sample[]> buf (new Sample[block]);
+
+	for (samplecnt_t s = 0; s < signal_length; s += block) {
+		for (samplecnt_t i = 0; i < block; ++i) {
+			uint32_t const x = (s + i) * 2654435761U;
+			buf[i] = ((x >> 8) % 20001) / 10000.f - 1.f;
+		}
+		CPPUNIT_ASSERT_EQUAL (block, _source->write (buf.get (), block));
+	}
+
+	_source->done_with_peakfile_writes (true);
+}
+
+void
+PeakLevelsTest::tearDown ()
+{
+	_source.reset ();
+	Config->set_use_peak_levels (_use_peak_levels);
+	AudioFileSource::set_build_peakfiles (_build_peakfiles);
+
+	TestNeedingSession::tearDown ();
+}
+
+std::string
+PeakLevelsTest::level_path (int level) const
+{
+	std::string const dir = _session->session_directory ().peak_path ();
+	std::string const suffix = string_compose ("%1.%2", peakfile_suffix, level);
+
+	Glib::Dir d (dir);
+	for (Glib::DirIterator i = d.begin (); i != d.end (); ++i) {
+		std::string const name (*i);
+		if (name.size () > suffix.size () && name.compare (name.size () - suffix.size (), suffix.size (), suffix) == 0) {
+			return Glib::build_filename (dir, name);
+		}
+	}
+	return std::string ();
+}
+
+/** Compare peaks read from each decimated level with peaks computed from level 0 */
+void
+PeakLevelsTest::compare_levels ()
+{
+	for (int l = 1; l <= n_levels; ++l) {
+		samplecnt_t const spp    = fpp << (2 * l);
+		samplecnt_t const npeaks = signal_length / spp;
+		samplepos_t const start  = 2 * spp;
+		samplecnt_t const cnt    = (npeaks - 2) * spp;
+
+		std::unique_ptr<PeakData[]> decimated (new PeakData[npeaks]);
+		std::unique_ptr<PeakData[]> reference (new PeakData[npeaks]);
+
+		Config->set_use_peak_levels (true);
+		CPPUNIT_ASSERT_EQUAL (0, _source->read_peaks (decimated.get (), npeaks - 2, start, cnt, spp));
+		Config->set_use_peak_levels (false);
+		CPPUNIT_ASSERT_EQUAL (0, _source->read_peaks (reference.get (), npeaks - 2, start, cnt, spp));
+		Config->set_use_peak_levels (true);
+
+		for (samplecnt_t i = 0; i < npeaks - 2; ++i) {
+			CPPUNIT_ASSERT_EQUAL (reference[i].max, decimated[i].max);
+			CPPUNIT_ASSERT_EQUAL (reference[i].min, decimated[i].min);
+		}
+	}
+}
+
+void
+PeakLevelsTest::decimatedReadTest ()
+{
+	for (int l = 1; l <= n_levels; ++l) {
+		CPPUNIT_ASSERT (Glib::file_test (level_path (l), Glib::FILE_TEST_IS_REGULAR));
+	}
+
+	compare_levels ();
+}
+
+void
+PeakLevelsTest::outdatedLevelTest ()
+{
+	/* clobber the data of a level */
+	std::string const path = level_path (1);
+	GStatBuf statbuf;
+	CPPUNIT_ASSERT (g_stat (path.c_str (), &statbuf) == 0);
+
+	std::string const garbage (statbuf.st_size / 2, 'x');
+	FILE* f = g_fopen (path.c_str (), "r+b");
+	CPPUNIT_ASSERT (f);
+	CPPUNIT_ASSERT (fseek (f, statbuf.st_size / 4, SEEK_SET) == 0);
+	CPPUNIT_ASSERT_EQUAL (garbage.size (), fwrite (garbage.data (), 1, garbage.size (), f));
+	fclose (f);
+
+	/* and touch the peak-file the levels were built from */
+	std::string const base = path.substr (0, path.size () - 2);
+	CPPUNIT_ASSERT (g_stat (base.c_str (), &statbuf) == 0);
+	struct utimbuf tbuf;
+	tbuf.actime  = statbuf.st_atime;
+	tbuf.modtime = statbuf.st_mtime + 60;
+	CPPUNIT_ASSERT (g_utime (base.c_str (), &tbuf) == 0);
+
+	/* levels are checked when the peak-file is set up, and rebuilt */
+	CPPUNIT_ASSERT_EQUAL (0, _source->setup_peakfile ());
+
+	compare_levels ();
+}
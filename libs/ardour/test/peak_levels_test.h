@@ -0,0 +1,30 @@
+#include <memory>
+
+#include "test_needing_session.h"
+
+namespace ARDOUR {
+	class AudioSource;
+}
+
+class PeakLevelsTest : public TestNeedingSession
+{
+	CPPUNIT_TEST_SUITE (PeakLevelsTest);
+	CPPUNIT_TEST (decimatedReadTest);
+	CPPUNIT_TEST (outdatedLevelTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp ();
+	void tearDown ();
+
+	void decimatedReadTest ();
+	void outdatedLevelTest ();
+
+private:
+	void compare_levels ();
+	std::string level_path (int level) const;
+
+	std::shared_ptr<ARDOUR::AudioSource> _source;
+	bool _use_peak_levels;
+	bool _build_peakfiles;
+};
@@ -0,0 +1,490 @@
+/* Benchmark and regression check for the runtime-dispatched DSP kernels
+ * (ardour/runtime_functions.h).
+ *
+ * Every implementation that the CPU supports is compared against the
+ * default C version for a range of buffer sizes and (mis)alignments,
+ * then timed. The throughput is printed in samples per nanosecond.
+ *
+ * The program exits with a non-zero status if any implementation
+ * produces different results, or if an optimized implementation is
+ * slower than the default C version.
+ */
+
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "pbd/fpu.h"
+#include "pbd/malign.h"
+#include "pbd/microseconds.h"
+
+#include "ardour/ardour.h"
+#include "ardour/mix.h"
+#include "ardour/runtime_functions.h"
+
+#if defined(__APPLE__)
+#include <CoreFoundation/CoreFoundation.h>
+#endif
+
+using namespace std;
+using namespace ARDOUR;
+
+static const char* localedir = LOCALEDIR;
+
+enum Kernel {
+	ComputePeak = 0,
+	FindPeaks,
+	ApplyGainToBuffer,
+	MixBuffersWithGain,
+	MixBuffersNoGain,
+	CopyVector,
+	ApplyGainRamp,
+	ApplyGainVectorToBuffer,
+	MixBuffersWithGainVector,
+	NKernels
+};
+
+static const char* kernel_names[NKernels] = {
+	"compute_peak",
+	"find_peaks",
+	"apply_gain_to_buffer",
+	"mix_buffers_with_gain",
+	"mix_buffers_no_gain",
+	"copy_vector",
+	"apply_gain_ramp",
+	"apply_gain_vector_to_buffer",
+	"mix_buffers_with_gain_vector",
+};
+
+/* max. allowed difference relative to the reference value */
+static const float kernel_tolerance[NKernels] = {
+	0,               /* compute_peak */
+	0,               /* find_peaks */
+	0,               /* apply_gain_to_buffer */
+	2 * FLT_EPSILON, /* mix_buffers_with_gain, FMA rounds once */
+	0,               /* mix_buffers_no_gain */
+	0,               /* copy_vector */
+	1e-5,            /* apply_gain_ramp, closed form vs. recursion */
+	0,               /* apply_gain_vector_to_buffer */
+	2 * FLT_EPSILON, /* mix_buffers_with_gain_vector, FMA rounds once */
+};
+
+struct Implementation {
+	Implementation (const char* n)
+		: name (n)
+	{
+		memset (fn, 0, sizeof (fn));
+	}
+
+	Implementation&
+	set (Kernel k, void* f)
+	{
+		fn[k] = f;
+		return *this;
+	}
+
+	const char* name;
+	void*       fn[NKernels];
+};
+
+#define FN(f) ((void*)(f))
+
+/* ****************************************************************************/
+
+struct Buffers {
+	Buffers (size_t n)
+		: size (n)
+	{
+		cache_aligned_malloc ((void**)&dst, sizeof (float) * n);
+		cache_aligned_malloc ((void**)&src, sizeof (float) * n);
+		cache_aligned_malloc ((void**)&gain, sizeof (float) * n);
+	}
+
+	~Buffers ()
+	{
+		cache_aligned_free (dst);
+		cache_aligned_free (src);
+		cache_aligned_free (gain);
+	}
+
+	void
+	fill (uint32_t seed)
+	{
+		for (size_t i = 0; i < size; ++i) {
+			seed    = seed * 1664525 + 1013904223;
+			dst[i]  = (seed >> 8) / 8388608.f - 1.f; // -1 .. +1
+			seed    = seed * 1664525 + 1013904223;
+			src[i]  = (seed >> 8) / 8388608.f - 1.f;
+			seed    = seed * 1664525 + 1013904223;
+			gain[i] = (seed >> 8) / 8388608.f;       // 0 .. 2
+		}
+	}
+
+	size_t size;
+	float* dst;
+	float* src;
+	float* gain;
+};
+
+/* Run kernel `k' of implementation `im' once using scalar gain `g',
+ * results that are not written to the buffer are returned in r0, r1.
+ */
+static void
+run (Kernel k, Implementation const& im, Buffers& b, size_t off, size_t n, float g, float& r0, float& r1)
+{
+	float*       dst  = &b.dst[off];
+	float const* src  = &b.src[off];
+	float const* gain = &b.gain[off];
+	void*        fn   = im.fn[k];
+
+	switch (k) {
+		case ComputePeak:
+			r0 = ((compute_peak_t)fn) (src, n, r0);
+			break;
+		case FindPeaks:
+			((find_peaks_t)fn) (src, n, &r0, &r1);
+			break;
+		case ApplyGainToBuffer:
+			((apply_gain_to_buffer_t)fn) (dst, n, g);
+			break;
+		case MixBuffersWithGain:
+			((mix_buffers_with_gain_t)fn) (dst, src, n, g);
+			break;
+		case MixBuffersNoGain:
+			((mix_buffers_no_gain_t)fn) (dst, src, n);
+			break;
+		case CopyVector:
+			((copy_vector_t)fn) (dst, src, n);
+			break;
+		case ApplyGainRamp:
+			r0 = ((apply_gain_ramp_t)fn) (dst, n, r0, 1.f, .005f);
+			break;
+		case ApplyGainVectorToBuffer:
+			((apply_gain_vector_to_buffer_t)fn) (dst, gain, n);
+			break;
+		case MixBuffersWithGainVector:
+			((mix_buffers_with_gain_vector_t)fn) (dst, src, gain, n);
+			break;
+		default:
+			abort ();
+	}
+}
+
+static bool
+differs (float a, float b, float tolerance)
+{
+	return fabsf (a - b) > tolerance * max (1.f, fabsf (b));
+}
+
+/* compare implementation `im' against reference implementation `ref' */
+static bool
+verify (Kernel k, Implementation const& im, Implementation const& ref, size_t align_max)
+{
+	static const size_t sizes[] = { 255, 256, 257, 1023, 1024, 4096 };
+
+	Buffers test (4096 + align_max);
+	Buffers comp (4096 + align_max);
+
+	float const tolerance = kernel_tolerance[k];
+
+	for (size_t off = 0; off < align_max; ++off) {
+		for (size_t i = 0; i < 2 * align_max + 6; ++i) {
+			size_t const n = i < 2 * align_max ? i + 1 : sizes[i - 2 * align_max];
+
+			test.fill (n + off);
+			comp.fill (n + off);
+
+			float t0 = 0.5f;
+			float c0 = 0.5f;
+			float t1 = test.src[off];
+			float c1 = comp.src[off];
+			if (k == FindPeaks) {
+				t0 = c0 = t1;
+			}
+
+			run (k, im, test, off, n, .45f, t0, t1);
+			run (k, ref, comp, off, n, .45f, c0, c1);
+
+			bool ok = !differs (t0, c0, tolerance) && !differs (t1, c1, tolerance);
+			for (size_t s = 0; s < test.size && ok; ++s) {
+				ok = !differs (test.dst[s], comp.dst[s], tolerance);
+			}
+			if (!ok) {
+				printf ("FAIL: %s %s differs from %s, offset: %zu nframes: %zu\n", im.name, kernel_names[k], ref.name, off, n);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/* return throughput in samples/ns, best of several trials */
+static double
+bench (Kernel k, Implementation const& im, size_t off, size_t n, size_t n_samples)
+{
+	Buffers b (n + off);
+	b.fill (1);
+
+	/* unity gain, repeated processing must not produce denormals or inf */
+	for (size_t i = 0; i < b.size; ++i) {
+		b.gain[i] = 1.f;
+	}
+
+	size_t const iter = max<size_t> (1, n_samples / n);
+	int64_t      best = INT64_MAX;
+
+	for (int trial = 0; trial < 5; ++trial) {
+		float   r0    = 0.5f;
+		float   r1    = 0.5f;
+		int64_t start = PBD::get_microseconds ();
+		for (size_t i = 0; i < iter; ++i) {
+			run (k, im, b, off, n, 1.f, r0, r1);
+		}
+		best = min<int64_t> (best, PBD::get_microseconds () - start);
+	}
+	return (double)(iter * n) / (1000. * max<int64_t> (1, best));
+}
+
+/* ****************************************************************************/
+
+static void
+usage ()
+{
+	printf ("dsp_kernels - benchmark and verify runtime DSP functions.\n\n");
+	printf ("Usage: dsp_kernels [ OPTIONS ]\n\n");
+	printf ("Options:\n\
+  -h, --help                 Display this help and exit\n\
+  -n, --no-timing-check      Do not fail if an optimized kernel is slower than C\n\
+  -s, --samples <num>        Number of samples to process per trial (default 16M)\n\
+  -t, --tolerance <ratio>    Fail if optimized/C throughput is below this (default 0.9)\n\
+\n");
+}
+
+int
+main (int argc, char* argv[])
+{
+	bool   check_timing = true;
+	size_t n_samples    = 1 << 24;
+	double min_ratio    = 0.9;
+
+	const char*          optstring = "hns:t:";
+	const struct option longopts[] = {
+		{ "help",            no_argument,       0, 'h' },
+		{ "no-timing-check", no_argument,       0, 'n' },
+		{ "samples",         required_argument, 0, 's' },
+		{ "tolerance",       required_argument, 0, 't' },
+		{ 0, 0, 0, 0 }
+	};
+
+	int c = 0;
+	while (EOF != (c = getopt_long (argc, argv, optstring, longopts, (int*)0))) {
+		switch (c) {
+			case 'n':
+				check_timing = false;
+				break;
+			case 's':
+				n_samples = max (65536, atoi (optarg));
+				break;
+			case 't':
+				min_ratio = atof (optarg);
+				break;
+			case 'h':
+				usage ();
+				::exit (EXIT_SUCCESS);
+				break;
+			default:
+				usage ();
+				::exit (EXIT_FAILURE);
+				break;
+		}
+	}
+
+	/* this sets up the dispatched function pointers */
+	ARDOUR::init (true, localedir);
+
+	Implementation ref ("default");
+	ref.set (ComputePeak, FN (default_compute_peak))
+	   .set (FindPeaks, FN (default_find_peaks))
+	   .set (ApplyGainToBuffer, FN (default_apply_gain_to_buffer))
+	   .set (MixBuffersWithGain, FN (default_mix_buffers_with_gain))
+	   .set (MixBuffersNoGain, FN (default_mix_buffers_no_gain))
+	   .set (CopyVector, FN (default_copy_vector))
+	   .set (ApplyGainRamp, FN (default_apply_gain_ramp))
+	   .set (ApplyGainVectorToBuffer, FN (default_apply_gain_vector_to_buffer))
+	   .set (MixBuffersWithGainVector, FN (default_mix_buffers_with_gain_vector));
+
+	vector<Implementation> impl;
+
+	impl.push_back (Implementation ("dispatch"));
+	impl.back ()
+	   .set (ComputePeak, FN (ARDOUR::compute_peak))
+	   .set (FindPeaks, FN (ARDOUR::find_peaks))
+	   .set (ApplyGainToBuffer, FN (ARDOUR::apply_gain_to_buffer))
+	   .set (MixBuffersWithGain, FN (ARDOUR::mix_buffers_with_gain))
+	   .set (MixBuffersNoGain, FN (ARDOUR::mix_buffers_no_gain))
+	   .set (CopyVector, FN (ARDOUR::copy_vector))
+	   .set (ApplyGainRamp, FN (ARDOUR::apply_gain_ramp))
+	   .set (ApplyGainVectorToBuffer, FN (ARDOUR::apply_gain_vector_to_buffer))
+	   .set (MixBuffersWithGainVector, FN (ARDOUR::mix_buffers_with_gain_vector));
+
+	PBD::FPU* fpu = PBD::FPU::instance ();
+	(void) fpu;
+
+#if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
+# if (defined(__x86_64__) || defined(_M_X64))
+	size_t const align_max = 64;
+# else
+	size_t const align_max = 16;
+# endif
+	if (fpu->has_sse ()) {
+		impl.push_back (Implementation ("sse"));
+		impl.back ()
+		   .set (ComputePeak, FN (x86_sse_compute_peak))
+		   .set (FindPeaks, FN (x86_sse_find_peaks))
+		   .set (ApplyGainToBuffer, FN (x86_sse_apply_gain_to_buffer))
+		   .set (MixBuffersWithGain, FN (x86_sse_mix_buffers_with_gain))
+		   .set (MixBuffersNoGain, FN (x86_sse_mix_buffers_no_gain))
+		   .set (ApplyGainRamp, FN (x86_sse_apply_gain_ramp))
+		   .set (ApplyGainVectorToBuffer, FN (x86_sse_apply_gain_vector_to_buffer))
+		   .set (MixBuffersWithGainVector, FN (x86_sse_mix_buffers_with_gain_vector));
+	}
+	if (fpu->has_avx ()) {
+		impl.push_back (Implementation ("avx"));
+		impl.back ()
+		   .set (ComputePeak, FN (x86_sse_avx_compute_peak))
+		   .set (FindPeaks, FN (x86_sse_avx_find_peaks))
+		   .set (ApplyGainToBuffer, FN (x86_sse_avx_apply_gain_to_buffer))
+		   .set (MixBuffersWithGain, FN (x86_sse_avx_mix_buffers_with_gain))
+		   .set (MixBuffersNoGain, FN (x86_sse_avx_mix_buffers_no_gain))
+		   .set (CopyVector, FN (x86_sse_avx_copy_vector))
+		   .set (ApplyGainRamp, FN (x86_avx_apply_gain_ramp))
+		   .set (ApplyGainVectorToBuffer, FN (x86_avx_apply_gain_vector_to_buffer))
+		   .set (MixBuffersWithGainVector, FN (x86_avx_mix_buffers_with_gain_vector));
+	}
+# ifdef FPU_AVX_FMA_SUPPORT
+	if (fpu->has_avx () && fpu->has_fma ()) {
+		impl.push_back (Implementation ("fma"));
+		impl.back ()
+		   .set (MixBuffersWithGain, FN (x86_fma_mix_buffers_with_gain))
+		   .set (MixBuffersWithGainVector, FN (x86_fma_mix_buffers_with_gain_vector));
+	}
+# endif
+# ifdef FPU_AVX512F_SUPPORT
+	if (fpu->has_avx512f ()) {
+		impl.push_back (Implementation ("avx512f"));
+		impl.back ()
+		   .set (ComputePeak, FN (x86_avx512f_compute_peak))
+		   .set (FindPeaks, FN (x86_avx512f_find_peaks))
+		   .set (ApplyGainToBuffer, FN (x86_avx512f_apply_gain_to_buffer))
+		   .set (MixBuffersWithGain, FN (x86_avx512f_mix_buffers_with_gain))
+		   .set (MixBuffersNoGain, FN (x86_avx512f_mix_buffers_no_gain))
+		   .set (CopyVector, FN (x86_avx512f_copy_vector))
+		   .set (ApplyGainRamp, FN (x86_avx512f_apply_gain_ramp))
+		   .set (ApplyGainVectorToBuffer, FN (x86_avx512f_apply_gain_vector_to_buffer))
+		   .set (MixBuffersWithGainVector, FN (x86_avx512f_mix_buffers_with_gain_vector));
+	}
+# endif
+
+#elif defined ARM_NEON_SUPPORT
+	size_t const align_max = 16;
+	if (fpu->has_neon ()) {
+		impl.push_back (Implementation ("neon"));
+		impl.back ()
+		   .set (ComputePeak, FN (arm_neon_compute_peak))
+		   .set (FindPeaks, FN (arm_neon_find_peaks))
+		   .set (ApplyGainToBuffer, FN (arm_neon_apply_gain_to_buffer))
+		   .set (MixBuffersWithGain, FN (arm_neon_mix_buffers_with_gain))
+		   .set (MixBuffersNoGain, FN (arm_neon_mix_buffers_no_gain))
+		   .set (CopyVector, FN (arm_neon_copy_vector))
+		   .set (ApplyGainRamp, FN (arm_neon_apply_gain_ramp))
+		   .set (ApplyGainVectorToBuffer, FN (arm_neon_apply_gain_vector_to_buffer))
+		   .set (MixBuffersWithGainVector, FN (arm_neon_mix_buffers_with_gain_vector));
+	}
+
+#elif defined(__APPLE__) && defined(BUILD_VECLIB_OPTIMIZATIONS)
+	size_t const align_max = 16;
+	if (floor (kCFCoreFoundationVersionNumber) > kCFCoreFoundationVersionNumber10_4) {
+		impl.push_back (Implementation ("veclib"));
+		impl.back ()
+		   .set (ComputePeak, FN (veclib_compute_peak))
+		   .set (FindPeaks, FN (veclib_find_peaks))
+		   .set (ApplyGainToBuffer, FN (veclib_apply_gain_to_buffer))
+		   .set (MixBuffersWithGain, FN (veclib_mix_buffers_with_gain))
+		   .set (MixBuffersNoGain, FN (veclib_mix_buffers_no_gain))
+		   .set (ApplyGainVectorToBuffer, FN (veclib_apply_gain_vector_to_buffer))
+		   .set (MixBuffersWithGainVector, FN (veclib_mix_buffers_with_gain_vector));
+	}
+#else
+	size_t const align_max = 16;
+#endif
+
+	int n_fail = 0;
+
+	/* correctness */
+	for (int k = 0; k < NKernels; ++k) {
+		for (vector<Implementation>::const_iterator i = impl.begin (); i != impl.end (); ++i) {
+			if (i->fn[k] && i->fn[k] != ref.fn[k] && !verify ((Kernel)k, *i, ref, align_max)) {
+				++n_fail;
+			}
+		}
+	}
+
+	/* throughput */
+	static const size_t sizes[] = { 64, 256, 1024, 8192 };
+	/* only compare in-cache sizes. Short buffers are dominated by call
+	 * overhead, 8192 samples exceed L1 and are memory-bound.
+	 */
+	static const bool compare[] = { false, true, true, false };
+
+	printf ("%-30s %-10s", "Kernel [samples/ns]", "Impl");
+	for (size_t s = 0; s < sizeof (sizes) / sizeof (size_t); ++s) {
+		printf (" %7zu %7s", sizes[s], "(+1)");
+	}
+	printf ("\n");
+
+	for (int k = 0; k < NKernels; ++k) {
+		double c_rate[2 * sizeof (sizes) / sizeof (size_t)];
+
+		for (int i = -1; i < (int)impl.size (); ++i) {
+			Implementation const& im = i < 0 ? ref : impl[i];
+			if (!im.fn[k] || (i >= 0 && im.fn[k] == ref.fn[k])) {
+				continue;
+			}
+
+			printf ("%-30s %-10s", kernel_names[k], im.name);
+
+			bool slow = false;
+			for (size_t s = 0; s < sizeof (sizes) / sizeof (size_t); ++s) {
+				for (size_t off = 0; off < 2; ++off) {
+					double rate = bench ((Kernel)k, im, off, sizes[s], n_samples);
+					if (i < 0) {
+						c_rate[2 * s + off] = rate;
+					} else if (compare[s] && rate < min_ratio * c_rate[2 * s + off]) {
+						slow = true;
+					}
+					printf (" %7.2f", rate);
+				}
+			}
+			if (slow && check_timing) {
+				printf ("  SLOWER THAN C");
+				++n_fail;
+			}
+			printf ("\n");
+		}
+	}
+
+	ARDOUR::cleanup ();
+
+	if (n_fail > 0) {
+		printf ("%d test(s) failed\n", n_fail);
+		return EXIT_FAILURE;
+	}
+	return EXIT_SUCCESS;
+}
@@ -5,17 +5,37 @@
 #include "ardour/midi_region.h"
 #include "ardour/session.h"
 #include "ardour/playlist.h"
+#include "pbd/microseconds.h"
 #include "pbd/stateful_diff_command.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
 using namespace std;
 using namespace ARDOUR;
 using namespace PBD;
 
 static const char* localedir = LOCALEDIR;
 
+static void
+report (char const* what, int64_t usec, int n_queries)
+{
+	printf ("%-24s %10.3f us/query\n", what, usec / (double) n_queries);
+}
+
 int
 main (int argc, char* argv[])
 {
+	int n_copies  = argc > 1 ? atoi (argv[1]) : 10000;
+	int n_queries = argc > 2 ? atoi (argv[2]) : 10000;
+
+	if (n_copies < 1 || n_queries < 1) {
+		fprintf (stderr, "Usage: %s [copies] [queries]\n", argv[0]);
+		return 1;
+	}
+
 	ARDOUR::init (true, localedir);
 	TestUI* test_ui = new TestUI();
 	create_and_start_dummy_backend ();
@@ -23,6 +43,8 @@ main (int argc, char* argv[])
 
 	assert (session->get_routes()->size() == 2);
 
+	int rv = 0;
+
 	{
 
 	/* Find the track */
@@ -37,11 +59,13 @@ main (int argc, char* argv[])
 	std::shared_ptr<MidiRegion> region = std::dynamic_pointer_cast<MidiRegion> (playlist->region_list_property().rlist().front());
 	assert (region);
 
+	int64_t t0 = get_microseconds ();
+
 	/* Duplicate it a lot */
 	session->begin_reversible_command ("foo");
 	playlist->clear_changes ();
 	timepos_t pos (region->last_sample() + 1);
-	playlist->duplicate (region, pos, 1000);
+	playlist->duplicate (region, pos, n_copies);
 	session->add_command (new StatefulDiffCommand (playlist));
 	session->commit_reversible_command ();
 
@@ -52,15 +76,93 @@ main (int argc, char* argv[])
 	session->begin_reversible_command ("foo");
 	playlist->clear_changes ();
 	timepos_t pos2 (region->last_sample() + 1);
-	playlist->duplicate (region, pos2, 1000);
+	playlist->duplicate (region, pos2, n_copies);
 	session->add_command (new StatefulDiffCommand (playlist));
 	session->commit_reversible_command ();
 
+	/* and a second layer, overlapping the first */
+	session->begin_reversible_command ("foo");
+	playlist->clear_changes ();
+	timepos_t pos3 (region->position_sample() + region->length_samples() / 2);
+	playlist->duplicate (region, pos3, n_copies);
+	session->add_command (new StatefulDiffCommand (playlist));
+	session->commit_reversible_command ();
+
+	printf ("%-24s %10.3f ms\n", "edit", (get_microseconds () - t0) / 1000.0);
+
+	/* Positional queries */
+	samplepos_t const extent = playlist->get_extent ().second.samples ();
+	samplecnt_t const window = region->length_samples () / 4;
+
+	vector<timepos_t> positions;
+	srand (1);
+	for (int i = 0; i < n_queries; ++i) {
+		positions.push_back (timepos_t ((samplepos_t) (extent * (rand () / (RAND_MAX + 1.0)))));
+	}
+
+	printf ("%-24s %10zu\n", "regions", (size_t) playlist->n_regions ());
+
+	size_t  n_found = 0;
+	int64_t t;
+
+	t = get_microseconds ();
+	for (auto const& p : positions) {
+		n_found += playlist->regions_at (p)->size ();
+	}
+	report ("regions_at", get_microseconds () - t, n_queries);
+
+	t = get_microseconds ();
+	for (auto const& p : positions) {
+		n_found += playlist->count_regions_at (p);
+	}
+	report ("count_regions_at", get_microseconds () - t, n_queries);
+
+	t = get_microseconds ();
+	for (auto const& p : positions) {
+		n_found += playlist->top_region_at (p) ? 1 : 0;
+	}
+	report ("top_region_at", get_microseconds () - t, n_queries);
+
+	t = get_microseconds ();
+	for (auto const& p : positions) {
+		n_found += playlist->audible_regions_at (p)->size ();
+	}
+	report ("audible_regions_at", get_microseconds () - t, n_queries);
+
+	t = get_microseconds ();
+	for (auto const& p : positions) {
+		n_found += playlist->regions_touched (p, p + timecnt_t (window))->size ();
+	}
+	report ("regions_touched", get_microseconds () - t, n_queries);
+
+	/* Compare with a linear scan of all regions, as used to be done
+	 * for every query. This also verifies the results.
+	 */
+	std::shared_ptr<RegionList> all = playlist->region_list ();
+	int const n_check = std::min (n_queries, 500);
+
+	t = get_microseconds ();
+	for (int i = 0; i < n_check; ++i) {
+		RegionList rl;
+		for (auto const& r : *all) {
+			if (r->covers (positions[i])) {
+				rl.push_back (r);
+			}
+		}
+		if (rl != *playlist->regions_at (positions[i])) {
+			fprintf (stderr, "regions_at (%s) mismatch\n", positions[i].str ().c_str ());
+			rv = 1;
+		}
+	}
+	report ("linear scan (reference)", get_microseconds () - t, n_check);
+
+	printf ("%-24s %10zu\n", "found", n_found);
+
 	}
 
 	delete session;
 	stop_and_destroy_backend ();
 	delete test_ui;
 	ARDOUR::cleanup ();
-	return 0;
+	return rv;
 }
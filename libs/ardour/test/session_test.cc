@@ -6,8 +6,11 @@
 
 #include "pbd/textreceiver.h"
 #include "pbd/file_utils.h"
+#include "pbd/xml++.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/session.h"
 #include "ardour/audioengine.h"
+#include "ardour/filename_extensions.h"
 #include "ardour/smf_source.h"
 #include "ardour/midi_model.h"
 
@@ -150,3 +153,48 @@ SessionTest::open_session_utf8_path ()
 	}
 
 }
+
+void
+SessionTest::binary_session_info ()
+{
+	const string session_name ("binary_session");
+	std::string new_session_dir = Glib::build_filename (new_test_output_dir (), session_name);
+	std::string state_file = Glib::build_filename (new_session_dir, session_name + statefile_suffix);
+
+	CPPUNIT_ASSERT (!Glib::file_test (new_session_dir, Glib::FILE_TEST_EXISTS));
+
+	bool const save_binary = Config->get_save_binary_state ();
+	Config->set_save_binary_state (true);
+
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session (new_session_dir, session_name);
+	CPPUNIT_ASSERT (session);
+	float const session_rate = session->nominal_sample_rate ();
+
+	CPPUNIT_ASSERT (0 == session->save_state ());
+	delete session;
+	stop_and_destroy_backend ();
+
+	Config->set_save_binary_state (save_binary);
+
+	CPPUNIT_ASSERT (XMLTree::is_binary_file (state_file));
+
+	/* read the information that is needed to open the session */
+	float        sample_rate = 0;
+	SampleFormat data_format = FormatInt16;
+	std::string  program_version;
+	XMLNode      engine_hints ("EngineHints");
+
+	CPPUNIT_ASSERT_EQUAL (0, Session::get_info_from_path (state_file, sample_rate, data_format, program_version, &engine_hints));
+	CPPUNIT_ASSERT_EQUAL (session_rate, sample_rate);
+	CPPUNIT_ASSERT (!program_version.empty ());
+
+	/* and re-open it */
+	create_and_start_dummy_backend ();
+	session = load_session (new_session_dir, session_name);
+	CPPUNIT_ASSERT (session);
+	CPPUNIT_ASSERT_EQUAL (session_rate, (float) session->nominal_sample_rate ());
+	delete session;
+	stop_and_destroy_backend ();
+}
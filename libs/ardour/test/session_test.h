@@ -8,6 +8,7 @@ class SessionTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (new_session);
 	CPPUNIT_TEST (new_session_from_template);
 	CPPUNIT_TEST (open_session_utf8_path);
+	CPPUNIT_TEST (binary_session_info);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -15,4 +16,5 @@ public:
 	void new_session ();
 	void new_session_from_template ();
 	void open_session_utf8_path ();
+	void binary_session_info ();
 };
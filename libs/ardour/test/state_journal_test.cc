@@ -0,0 +1,161 @@
+#include <glib.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/gstdio_compat.h"
+
+#include "pbd/xml++.h"
+
+#include "ardour/state_journal.h"
+
+#include "state_journal_test.h"
+#include "test_util.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (StateJournalTest);
+
+using namespace ARDOUR;
+using namespace std;
+
+/* large enough for the journal to never exceed half of it */
+static const size_t base_size = 100000;
+
+static XMLNode*
+route (char const* id, char const* name)
+{
+	XMLNode* node = new XMLNode ("Route");
+	node->set_property ("id", id);
+	node->set_property ("name", name);
+	return node;
+}
+
+static XMLNode
+base_state ()
+{
+	XMLNode root ("Session");
+	root.set_property ("version", 7000);
+	XMLNode* config = root.add_child ("Config");
+	config->set_property ("foo", 1);
+	XMLNode* routes = root.add_child ("Routes");
+	routes->add_child_nocopy (*route ("1", "Audio 1"));
+	routes->add_child_nocopy (*route ("2", "Audio 2"));
+	return root;
+}
+
+static string
+journal_path (string const& name)
+{
+	string const path = Glib::build_filename (new_test_output_dir ("state_journal"), name + ".pending.journal");
+	if (Glib::file_test (path, Glib::FILE_TEST_EXISTS)) {
+		g_unlink (path.c_str ());
+	}
+	return path;
+}
+
+/** Modify a route, remove another one and add a third one */
+static XMLNode
+first_change (XMLNode const& base)
+{
+	XMLNode state (base);
+	XMLNode* routes = state.child ("Routes");
+	routes->remove_node_and_delete ("Route", "id", "1");
+	routes->child ("Route")->set_property ("name", "Vocals");
+	routes->add_child_nocopy (*route ("3", "Audio 3"));
+	return state;
+}
+
+/** Change root properties and a top-level node */
+static XMLNode
+second_change (XMLNode const& first)
+{
+	XMLNode state (first);
+	state.set_property ("sample-rate", 48000);
+	state.child ("Config")->set_property ("foo", 2);
+	return state;
+}
+
+void
+StateJournalTest::appendReplayTest ()
+{
+	string const path = journal_path ("append");
+	XMLNode const base (base_state ());
+	XMLNode const first (first_change (base));
+	XMLNode const second (second_change (first));
+
+	StateJournal journal;
+	CPPUNIT_ASSERT (!journal.append (base, path));
+
+	journal.reset (base, path, base_size);
+
+	/* nothing changed, nothing is written */
+	CPPUNIT_ASSERT (journal.append (base, path));
+	CPPUNIT_ASSERT (!Glib::file_test (path, Glib::FILE_TEST_EXISTS));
+
+	CPPUNIT_ASSERT (journal.append (first, path));
+	CPPUNIT_ASSERT (journal.append (second, path));
+
+	XMLNode state (base);
+	CPPUNIT_ASSERT_EQUAL (2, StateJournal::replay (state, path, base_size));
+	CPPUNIT_ASSERT (state == second);
+
+	/* reordering top-level nodes needs a full save */
+	XMLNode reordered ("Session");
+	reordered.add_child_copy (*second.child ("Routes"));
+	reordered.add_child_copy (*second.child ("Config"));
+	CPPUNIT_ASSERT (!journal.append (reordered, path));
+
+	CPPUNIT_ASSERT (journal.discard (path));
+	CPPUNIT_ASSERT (!Glib::file_test (path, Glib::FILE_TEST_EXISTS));
+	CPPUNIT_ASSERT (!journal.append (second, path));
+}
+
+void
+StateJournalTest::staleJournalTest ()
+{
+	string const path = journal_path ("stale");
+	XMLNode const base (base_state ());
+	XMLNode const first (first_change (base));
+
+	StateJournal journal;
+	journal.reset (base, path, base_size);
+	CPPUNIT_ASSERT (journal.append (first, path));
+
+	/* a full save of a different size replaced the state the journal
+	 * is based on, but the journal was left behind.
+	 */
+	XMLNode state (first);
+	CPPUNIT_ASSERT_EQUAL (0, StateJournal::replay (state, path, base_size + 1));
+	CPPUNIT_ASSERT (state == first);
+
+	/* a journal without base size stamp is not replayed either */
+	string const record = "9\n<Delta/>\n";
+	CPPUNIT_ASSERT (g_file_set_contents (path.c_str (), record.c_str (), record.size (), 0));
+	state = base;
+	CPPUNIT_ASSERT_EQUAL (0, StateJournal::replay (state, path, base_size));
+	CPPUNIT_ASSERT (state == base);
+}
+
+void
+StateJournalTest::truncatedRecordTest ()
+{
+	string const path = journal_path ("truncated");
+	XMLNode const base (base_state ());
+	XMLNode const first (first_change (base));
+	XMLNode const second (second_change (first));
+
+	StateJournal journal;
+	journal.reset (base, path, base_size);
+	CPPUNIT_ASSERT (journal.append (first, path));
+	CPPUNIT_ASSERT (journal.append (second, path));
+
+	gchar* contents;
+	gsize  length;
+	CPPUNIT_ASSERT (g_file_get_contents (path.c_str (), &contents, &length, 0));
+
+	/* a crash while writing the second record */
+	CPPUNIT_ASSERT (g_file_set_contents (path.c_str (), contents, length - 8, 0));
+	g_free (contents);
+
+	XMLNode state (base);
+	CPPUNIT_ASSERT_EQUAL (1, StateJournal::replay (state, path, base_size));
+	CPPUNIT_ASSERT (state == first);
+}
@@ -0,0 +1,19 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+class StateJournalTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (StateJournalTest);
+	CPPUNIT_TEST (appendReplayTest);
+	CPPUNIT_TEST (staleJournalTest);
+	CPPUNIT_TEST (truncatedRecordTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void setUp () {}
+	void tearDown () {}
+
+	void appendReplayTest ();
+	void staleJournalTest ();
+	void truncatedRecordTest ();
+};
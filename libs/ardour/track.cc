@@ -620,6 +620,24 @@ Track::do_refill ()
 	return _disk_reader->do_refill ();
 }
 
+bool
+Track::get_refill_stats (PBD::microseconds_t& min, PBD::microseconds_t& max, double& avg, double& dev) const
+{
+	return _disk_reader->get_refill_stats (min, max, avg, dev);
+}
+
+void
+Track::clear_refill_stats ()
+{
+	_disk_reader->clear_refill_stats ();
+}
+
+PBD::microseconds_t
+Track::last_refill_time () const
+{
+	return _disk_reader->last_refill_time ();
+}
+
 int
 Track::do_flush (RunContext c, bool force)
 {
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ardour/mix.h"
+
+#include <immintrin.h>
+
+#ifndef __AVX__
+#error "__AVX__ must be enabled for this module to work"
+#endif
+
+/**
+ * @brief x86 AVX optimized 1-pole low-pass gain ramp
+ *
+ * Uses the closed form g[i] = target + (initial - target) * (1 - coeff)^i
+ * to process 8 samples in parallel.
+ *
+ * @param[in,out] buf Pointer to buffer
+ * @param nframes Number of samples to process
+ * @param initial Gain of the first sample
+ * @param target Target gain
+ * @param coeff Low-pass filter coefficient
+ * @return float Gain after the last sample
+ */
+float
+x86_avx_apply_gain_ramp (float* buf, uint32_t nframes, float initial, float target, float coeff)
+{
+	const float k = 1.f - coeff;
+
+	if (nframes >= 8) {
+		const float d = initial - target;
+		float       dv[8];
+		float       kn = 1.f;
+		for (int i = 0; i < 8; ++i) {
+			dv[i] = d * kn;
+			kn *= k;
+		}
+
+		__m256 vt = _mm256_set1_ps (target);
+		__m256 vk = _mm256_set1_ps (kn);
+		__m256 vd = _mm256_loadu_ps (dv);
+
+		while (nframes >= 8) {
+			__m256 x = _mm256_loadu_ps (buf);
+			x = _mm256_mul_ps (x, _mm256_add_ps (vt, vd));
+			_mm256_storeu_ps (buf, x);
+			vd = _mm256_mul_ps (vd, vk);
+			buf += 8;
+			nframes -= 8;
+		}
+
+		initial = target + _mm256_cvtss_f32 (vd);
+	}
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*buf++ *= initial;
+		initial += coeff * (target - initial);
+		--nframes;
+	}
+
+	return initial;
+}
+
+/**
+ * @brief x86 AVX optimized routine to apply a per-sample gain
+ *
+ * @param[in,out] buf Pointer to buffer
+ * @param[in] gain Pointer to gain coefficients
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx_apply_gain_vector_to_buffer (float* buf, float const* gain, uint32_t nframes)
+{
+	while (nframes >= 8) {
+		_mm256_storeu_ps (buf, _mm256_mul_ps (_mm256_loadu_ps (buf), _mm256_loadu_ps (gain)));
+		buf += 8;
+		gain += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*buf++ *= *gain++;
+		--nframes;
+	}
+}
+
+/**
+ * @brief x86 AVX optimized routine for mixing buffer with a per-sample gain
+ *
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param[in] gain Pointer to gain coefficients
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes)
+{
+	while (nframes >= 8) {
+		__m256 x = _mm256_mul_ps (_mm256_loadu_ps (src), _mm256_loadu_ps (gain));
+		_mm256_storeu_ps (dst, _mm256_add_ps (_mm256_loadu_ps (dst), x));
+		dst += 8;
+		src += 8;
+		gain += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper ();
+
+	while (nframes > 0) {
+		*dst++ += *src++ * *gain++;
+		--nframes;
+	}
+}
@@ -290,8 +290,8 @@ x86_avx512f_find_peaks(const float *src, uint32_t nframes, float *minf, float *m
 		if (frames >= 8 && IS_ALIGNED_TO(src, sizeof(__m256))) {
 			__m512 x = _mm512_castps256_ps512(_mm256_load_ps(src));
 
-			zmin = _mm512_min_ps(zmin, x);
-			zmax = _mm512_max_ps(zmax, x);
+			zmin = _mm512_mask_min_ps(zmin, 0x00ff, zmin, x);
+			zmax = _mm512_mask_max_ps(zmax, 0x00ff, zmax, x);
 
 			src += 8;
 			frames -= 8;
@@ -301,8 +301,8 @@ x86_avx512f_find_peaks(const float *src, uint32_t nframes, float *minf, float *m
 		if (frames >= 4 && IS_ALIGNED_TO(src, sizeof(__m128))) {
 			__m512 x = _mm512_castps128_ps512(_mm_load_ps(src));
 
-			zmin = _mm512_min_ps(zmin, x);
-			zmax = _mm512_max_ps(zmax, x);
+			zmin = _mm512_mask_min_ps(zmin, 0x000f, zmin, x);
+			zmax = _mm512_mask_max_ps(zmax, 0x000f, zmax, x);
 
 			src += 4;
 			frames -= 4;
@@ -312,8 +312,8 @@ x86_avx512f_find_peaks(const float *src, uint32_t nframes, float *minf, float *m
 		// Pointers are aligned to float boundaries (4 bytes)
 		__m512 x = _mm512_castps128_ps512(_mm_load_ss(src));
 
-		zmin = _mm512_min_ps(zmin, x);
-		zmax = _mm512_max_ps(zmax, x);
+		zmin = _mm512_mask_min_ps(zmin, 0x0001, zmin, x);
+		zmax = _mm512_mask_max_ps(zmax, 0x0001, zmax, x);
 
 		++src;
 		--frames;
@@ -460,8 +460,8 @@ x86_avx512f_find_peaks(const float *src, uint32_t nframes, float *minf, float *m
 	while (frames >= 8) {
 		__m512 x = _mm512_castps256_ps512(_mm256_load_ps(src));
 
-		zmin = _mm512_min_ps(zmin, x);
-		zmax = _mm512_max_ps(zmax, x);
+		zmin = _mm512_mask_min_ps(zmin, 0x00ff, zmin, x);
+		zmax = _mm512_mask_max_ps(zmax, 0x00ff, zmax, x);
 
 		src += 8;
 		frames -= 8;
@@ -471,8 +471,8 @@ x86_avx512f_find_peaks(const float *src, uint32_t nframes, float *minf, float *m
 	while (frames >= 4) {
 		__m512 x = _mm512_castps128_ps512(_mm_load_ps(src));
 
-		zmin = _mm512_min_ps(zmin, x);
-		zmax = _mm512_max_ps(zmax, x);
+		zmin = _mm512_mask_min_ps(zmin, 0x000f, zmin, x);
+		zmax = _mm512_mask_max_ps(zmax, 0x000f, zmax, x);
 
 		src += 4;
 		frames -= 4;
@@ -482,8 +482,8 @@ x86_avx512f_find_peaks(const float *src, uint32_t nframes, float *minf, float *m
 	while (frames > 0) {
 		__m512 x = _mm512_castps128_ps512(_mm_load_ss(src));
 
-		zmin = _mm512_min_ps(zmin, x);
-		zmax = _mm512_max_ps(zmax, x);
+		zmin = _mm512_mask_min_ps(zmin, 0x0001, zmin, x);
+		zmax = _mm512_mask_max_ps(zmax, 0x0001, zmax, x);
 
 		++src;
 		--frames;
@@ -988,40 +988,34 @@ x86_avx512f_copy_vector(float *dst, const float *src, uint32_t nframes)
     // Convert to signed integer to prevent any arithmetic overflow errors
 	int32_t frames = static_cast<int32_t>(nframes);
 
-	while (frames > 0) {
-		if (IS_ALIGNED_TO(src, sizeof(__m512)) &&
-		    IS_ALIGNED_TO(dst, sizeof(__m512))) {
-			break;
+	if ((reinterpret_cast<uintptr_t>(src) ^ reinterpret_cast<uintptr_t>(dst)) % sizeof(__m512)) {
+		// src and dst can never be aligned at the same time,
+		// use unaligned access
+		while (frames >= 16) {
+			_mm512_storeu_ps(dst, _mm512_loadu_ps(src));
+			src += 16;
+			dst += 16;
+			frames -= 16;
 		}
-
-		if (frames >= 8                        &&
-		    IS_ALIGNED_TO(src, sizeof(__m256)) &&
-		    IS_ALIGNED_TO(dst, sizeof(__m256))) {
-			__m256 x = _mm256_load_ps(src);
-			_mm256_store_ps(dst, x);
-			src += 8;
-			dst += 8;
-			frames -= 8;
-			continue;
+		if (frames > 0) {
+			const __mmask16 mask = (1 << frames) - 1;
+			_mm512_mask_storeu_ps(dst, mask, _mm512_maskz_loadu_ps(mask, src));
 		}
+		_mm256_zeroupper();
+		return;
+	}
 
-		if (frames >= 4                        &&
-		    IS_ALIGNED_TO(src, sizeof(__m128)) &&
-		    IS_ALIGNED_TO(dst, sizeof(__m128))) {
-			__m128 x = _mm_load_ps(src);
-			_mm_store_ps(dst, x);
-			src += 4;
-			dst += 4;
-			frames -= 4;
-			continue;
+	// Copy the unaligned head using a single masked load/store
+	if (frames > 0 && !IS_ALIGNED_TO(dst, sizeof(__m512))) {
+		int32_t head = (sizeof(__m512) - reinterpret_cast<uintptr_t>(dst) % sizeof(__m512)) / sizeof(float);
+		if (head > frames) {
+			head = frames;
 		}
-
-		// Pointers are aligned to float boundaries (4 bytes)
-		__m128 x = _mm_load_ss(src);
-		_mm_store_ss(dst, x);
-		++src;
-		++dst;
-		--frames;
+		const __mmask16 mask = (1 << head) - 1;
+		_mm512_mask_storeu_ps(dst, mask, _mm512_maskz_loadu_ps(mask, src));
+		src += head;
+		dst += head;
+		frames -= head;
 	}
 
 	// Process 256 samples at a time
@@ -1109,41 +1103,133 @@ x86_avx512f_copy_vector(float *dst, const float *src, uint32_t nframes)
 		frames -= 16;
 	}
 
-	// Process remaining samples x8
-	while (frames >= 8) {
-		__m256 x = _mm256_load_ps(src);
-		_mm256_store_ps(dst, x);
+	// Process remaining samples
+	if (frames > 0) {
+		const __mmask16 mask = (1 << frames) - 1;
+		_mm512_mask_store_ps(dst, mask, _mm512_maskz_load_ps(mask, src));
+	}
 
-		src += 8;
-		dst += 8;
-		frames -= 8;
+	// There's a penalty going from AVX mode to SSE mode. This can
+	// be avoided by ensuring the CPU that rest of the routine is no
+	// longer interested in the upper portion of the YMM register.
+
+	_mm256_zeroupper(); // zeros the upper portion of YMM register
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized 1-pole low-pass gain ramp
+ *
+ * Uses the closed form g[i] = target + (initial - target) * (1 - coeff)^i
+ * to process 16 samples in parallel.
+ *
+ * @param[in,out] dst Pointer to buffer
+ * @param nframes Number of samples to process
+ * @param initial Gain of the first sample
+ * @param target Target gain
+ * @param coeff Low-pass filter coefficient
+ * @return float Gain after the last sample
+ */
+float
+x86_avx512f_apply_gain_ramp(float *dst, uint32_t nframes, float initial, float target, float coeff)
+{
+	const float k = 1.f - coeff;
+
+	if (nframes >= 16) {
+		const float d = initial - target;
+		float dv[16];
+		float kn = 1.f;
+		for (int i = 0; i < 16; ++i) {
+			dv[i] = d * kn;
+			kn *= k;
+		}
+
+		const __m512 vt = _mm512_set1_ps(target);
+		const __m512 vk = _mm512_set1_ps(kn);
+		__m512 vd = _mm512_loadu_ps(dv);
+
+		while (nframes >= 16) {
+			__m512 x = _mm512_loadu_ps(dst);
+			x = _mm512_mul_ps(x, _mm512_add_ps(vt, vd));
+			_mm512_storeu_ps(dst, x);
+			vd = _mm512_mul_ps(vd, vk);
+			dst += 16;
+			nframes -= 16;
+		}
+
+		initial = target + _mm512_cvtss_f32(vd);
 	}
 
-	// Process remaining samples x4
-	while (frames >= 4) {
-		__m128 x = _mm_load_ps(src);
-		_mm_store_ps(dst, x);
+	// Process the remaining samples
+	if (nframes > 0) {
+		const __mmask16 mask = (1 << nframes) - 1;
+		float gv[16];
+		for (uint32_t i = 0; i < nframes; ++i) {
+			gv[i] = initial;
+			initial += coeff * (target - initial);
+		}
+		__m512 x = _mm512_maskz_loadu_ps(mask, dst);
+		x = _mm512_mul_ps(x, _mm512_maskz_loadu_ps(mask, gv));
+		_mm512_mask_storeu_ps(dst, mask, x);
+	}
 
-		src += 4;
-		dst += 4;
-		frames -= 4;
+	_mm256_zeroupper();
+
+	return initial;
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine to apply a per-sample gain
+ * @param[in,out] dst Pointer to buffer
+ * @param[in] gain Pointer to gain coefficients
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_apply_gain_vector_to_buffer(float *dst, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		_mm512_storeu_ps(dst, _mm512_mul_ps(_mm512_loadu_ps(dst), _mm512_loadu_ps(gain)));
+		dst += 16;
+		gain += 16;
+		nframes -= 16;
 	}
 
-	// Process remaining samples
-	while (frames > 0) {
-		__m128 x = _mm_load_ss(src);
-		_mm_store_ss(dst, x);
+	if (nframes > 0) {
+		const __mmask16 mask = (1 << nframes) - 1;
+		__m512 x = _mm512_mul_ps(_mm512_maskz_loadu_ps(mask, dst), _mm512_maskz_loadu_ps(mask, gain));
+		_mm512_mask_storeu_ps(dst, mask, x);
+	}
 
-		++src;
-		++dst;
-		--frames;
+	_mm256_zeroupper();
+}
+
+/**
+ * @brief x86-64 AVX-512F optimized routine for mixing buffer with a per-sample gain
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param[in] gain Pointer to gain coefficients
+ * @param nframes Number of samples to process
+ */
+void
+x86_avx512f_mix_buffers_with_gain_vector(float *dst, const float *src, const float *gain, uint32_t nframes)
+{
+	while (nframes >= 16) {
+		__m512 d0 = _mm512_loadu_ps(dst);
+		d0 = _mm512_fmadd_ps(_mm512_loadu_ps(src), _mm512_loadu_ps(gain), d0);
+		_mm512_storeu_ps(dst, d0);
+		dst += 16;
+		src += 16;
+		gain += 16;
+		nframes -= 16;
 	}
 
-	// There's a penalty going from AVX mode to SSE mode. This can
-	// be avoided by ensuring the CPU that rest of the routine is no
-	// longer interested in the upper portion of the YMM register.
+	if (nframes > 0) {
+		const __mmask16 mask = (1 << nframes) - 1;
+		__m512 d0 = _mm512_maskz_loadu_ps(mask, dst);
+		d0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, src), _mm512_maskz_loadu_ps(mask, gain), d0);
+		_mm512_mask_storeu_ps(dst, mask, d0);
+	}
 
-	_mm256_zeroupper(); // zeros the upper portion of YMM register
+	_mm256_zeroupper();
 }
 
 #endif // FPU_AVX512F_SUPPORT
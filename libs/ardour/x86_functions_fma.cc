@@ -138,4 +138,57 @@ x86_fma_mix_buffers_with_gain(
 	} while (0);
 }
 
+/**
+ * @brief x86-64 AVX/FMA optimized routine for mixing buffer with a per-sample gain.
+ *
+ * @param[in,out] dst Pointer to destination buffer, which gets updated
+ * @param[in] src Pointer to source buffer (not updated)
+ * @param[in] gain Pointer to gain coefficients
+ * @param nframes Number of samples to process
+ */
+void
+x86_fma_mix_buffers_with_gain_vector(
+    float       *dst,
+    const float *src,
+    const float *gain,
+    uint32_t     nframes)
+{
+	// Use AVX registers to process 16 samples in parallel
+	while (nframes >= 16) {
+		__m256 d0 = _mm256_loadu_ps(dst + 0);
+		__m256 d1 = _mm256_loadu_ps(dst + 8);
+
+		// dst = dst + (src * gain)
+		d0 = _mm256_fmadd_ps(_mm256_loadu_ps(src + 0), _mm256_loadu_ps(gain + 0), d0);
+		d1 = _mm256_fmadd_ps(_mm256_loadu_ps(src + 8), _mm256_loadu_ps(gain + 8), d1);
+
+		_mm256_storeu_ps(dst + 0, d0);
+		_mm256_storeu_ps(dst + 8, d1);
+
+		src += 16;
+		dst += 16;
+		gain += 16;
+		nframes -= 16;
+	}
+
+	while (nframes >= 8) {
+		__m256 d0 = _mm256_loadu_ps(dst);
+		d0 = _mm256_fmadd_ps(_mm256_loadu_ps(src), _mm256_loadu_ps(gain), d0);
+		_mm256_storeu_ps(dst, d0);
+
+		src += 8;
+		dst += 8;
+		gain += 8;
+		nframes -= 8;
+	}
+
+	_mm256_zeroupper(); // zeros the upper portion of YMM register
+
+	// Process the remaining samples, one sample at a time.
+	while (nframes > 0) {
+		*dst++ += *src++ * *gain++;
+		--nframes;
+	}
+}
+
 #endif // FPU_AVX_FMA_SUPPORT
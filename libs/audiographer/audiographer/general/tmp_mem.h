@@ -0,0 +1,105 @@
+#ifndef AUDIOGRAPHER_TMP_MEM_H
+#define AUDIOGRAPHER_TMP_MEM_H
+
+#include <algorithm>
+#include <vector>
+
+#include "pbd/compose.h"
+#include "pbd/signals.h"
+
+#include "audiographer/exception.h"
+#include "audiographer/flag_debuggable.h"
+#include "audiographer/sink.h"
+#include "audiographer/throwing.h"
+#include "audiographer/type_utils.h"
+#include "audiographer/types.h"
+#include "audiographer/utils/listed_source.h"
+
+namespace AudioGrapher
+{
+
+/** An in-memory replacement for \a TmpFile, holding interleaved data.
+ *  It is written once, and then read back (possibly several times) from the
+ *  beginning, like a temporary file, without any disk I/O.
+ */
+template<typename T = DefaultSampleType>
+class TmpMem
+	: public ListedSource<T>
+	, public Sink<T>
+	, public Throwing<>
+	, public FlagDebuggable<>
+{
+  public:
+	/** Constructor, not RT safe
+	 *  \a reserve is the expected number of samples (of all channels),
+	 *  process() is RT safe as long as this is not exceeded.
+	 */
+	TmpMem (ChannelCount channels, samplecnt_t reserve = 0)
+		: _channels (channels)
+		, _read_pos (0)
+	{
+		_data.reserve (reserve);
+		add_supported_flag (ProcessContext<T>::EndOfInput);
+	}
+
+	/// Appends data, emits \a Written at the end of input
+	void process (ProcessContext<T> const & c)
+	{
+		check_flags (*this, c);
+
+		if (throw_level (ThrowStrict) && c.channels() != _channels) {
+			throw Exception (*this, string_compose
+					("Wrong number of channels given to process(), %1 instead of %2",
+					 c.channels(), _channels));
+		}
+
+		_data.insert (_data.end (), c.data (), c.data () + c.samples ());
+
+		if (c.has_flag (ProcessContext<T>::EndOfInput)) {
+			Written ();
+		}
+	}
+
+	using Sink<T>::process;
+
+	/** Read data into buffer in \a context, only the data is modified (not sample count)
+	 *  Like SndfileReader::read() the data is also passed on to the outputs.
+	 *  \return number of samples read
+	 */
+	samplecnt_t read (ProcessContext<T> & context)
+	{
+		if (throw_level (ThrowStrict) && context.channels() != _channels) {
+			throw Exception (*this, string_compose
+					("Wrong number of channels given to read(), %1 instead of %2",
+					 context.channels(), _channels));
+		}
+
+		samplecnt_t const samples_read = std::min (context.samples (), (samplecnt_t) _data.size () - _read_pos);
+		TypeUtils<T>::copy (_data.data () + _read_pos, context.data (), samples_read);
+		_read_pos += samples_read;
+
+		ProcessContext<T> c_out = context.beginning (samples_read);
+		if (samples_read < context.samples()) {
+			c_out.set_flag (ProcessContext<T>::EndOfInput);
+		}
+		this->output (c_out);
+		return samples_read;
+	}
+
+	/// Rewind, to read the data again
+	void rewind () { _read_pos = 0; }
+
+	samplecnt_t get_samples_written () const { return _data.size (); }
+
+	/// Emitted when all data has been written
+	PBD::Signal<void()> Written;
+
+  private:
+	ChannelCount   _channels;
+	std::vector<T> _data;
+	samplecnt_t    _read_pos;
+};
+
+} // namespace
+
+#endif // AUDIOGRAPHER_TMP_MEM_H
@@ -0,0 +1,66 @@
+#include "tests/utils.h"
+#include "audiographer/general/tmp_mem.h"
+
+using namespace AudioGrapher;
+
+class TmpMemTest : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE (TmpMemTest);
+  CPPUNIT_TEST (testProcess);
+  CPPUNIT_TEST (testReadTwice);
+  CPPUNIT_TEST_SUITE_END ();
+
+  public:
+	void setUp()
+	{
+		samples = 128;
+		random_data = TestUtils::init_random_data(samples);
+	}
+
+	void tearDown()
+	{
+		delete [] random_data;
+	}
+
+	void testProcess()
+	{
+		uint32_t channels = 2;
+		mem.reset (new TmpMem<float>(channels, samples));
+		AllocatingProcessContext<float> c (random_data, samples, channels);
+		c.set_flag (ProcessContext<float>::EndOfInput);
+		mem->process (c);
+		CPPUNIT_ASSERT_EQUAL (samples, mem->get_samples_written ());
+
+		TypeUtils<float>::zero_fill (c.data (), c.samples());
+
+		CPPUNIT_ASSERT_EQUAL (samples, mem->read (c));
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, c.data(), c.samples()));
+	}
+
+	void testReadTwice()
+	{
+		uint32_t channels = 2;
+		mem.reset (new TmpMem<float>(channels));
+		ProcessContext<float> c (random_data, samples, channels);
+		mem->process (c);
+
+		AllocatingProcessContext<float> out (samples / 2, channels);
+		CPPUNIT_ASSERT_EQUAL (samples / 2, mem->read (out));
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, out.data(), samples / 2));
+		CPPUNIT_ASSERT_EQUAL (samples / 2, mem->read (out));
+		CPPUNIT_ASSERT (TestUtils::array_equals (&random_data[samples / 2], out.data(), samples / 2));
+		CPPUNIT_ASSERT_EQUAL ((samplecnt_t) 0, mem->read (out));
+
+		mem->rewind ();
+		CPPUNIT_ASSERT_EQUAL (samples / 2, mem->read (out));
+		CPPUNIT_ASSERT (TestUtils::array_equals (random_data, out.data(), samples / 2));
+	}
+
+  private:
+	std::shared_ptr<TmpMem<float> > mem;
+
+	float * random_data;
+	samplecnt_t samples;
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TmpMemTest);
@@ -36,6 +36,7 @@
 #include "ardour/debug.h"
 #include "ardour/filesystem_paths.h"
 #include "ardour/port_manager.h"
+#include "ardour/runtime_functions.h"
 #include "ardouralsautil/devicelist.h"
 #include "pbd/i18n.h"
 
@@ -1889,10 +1890,6 @@ AlsaAudioBackend::main_process_thread ()
 				}
 				pthread_mutex_unlock (&_device_port_mutex);
 
-				for (std::vector<BackendPortPtr>::const_iterator it = _system_outputs.begin (); it != _system_outputs.end (); ++it) {
-					memset ((*it)->get_buffer (_samples_per_period), 0, _samples_per_period * sizeof (Sample));
-				}
-
 				/* call engine process callback */
 				_last_process_start = g_get_monotonic_time ();
 				if (engine.process_callback (_samples_per_period)) {
@@ -2258,22 +2255,20 @@ void*
 AlsaAudioPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		std::set<BackendPortPtr>::const_iterator it = connections.begin ();
-		if (it == connections.end ()) {
+		std::shared_ptr<ConnectionList const> sources = connection_list ();
+		ConnectionList::const_iterator it = sources->begin ();
+		if (it == sources->end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
+		} else if (sources->size () == 1) {
+			/* use the buffer of a single source directly, as JACK does */
+			assert ((*it)->is_output ());
+			return static_cast<AlsaAudioPort*> (*it)->buffer ();
 		} else {
-			std::shared_ptr<const AlsaAudioPort> source = std::dynamic_pointer_cast<const AlsaAudioPort> (*it);
-			assert (source && source->is_output ());
-			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
-			while (++it != connections.end ()) {
-				source = std::dynamic_pointer_cast<const AlsaAudioPort> (*it);
-				assert (source && source->is_output ());
-				Sample*       dst = buffer ();
-				const Sample* src = source->const_buffer ();
-				for (uint32_t s = 0; s < n_samples; ++s, ++dst, ++src) {
-					*dst += *src;
-				}
+			assert ((*it)->is_output ());
+			copy_vector (_buffer, static_cast<const AlsaAudioPort*> (*it)->const_buffer (), n_samples);
+			while (++it != sources->end ()) {
+				assert ((*it)->is_output ());
+				mix_buffers_no_gain (_buffer, static_cast<const AlsaAudioPort*> (*it)->const_buffer (), n_samples);
 			}
 		}
 	}
@@ -2309,11 +2304,9 @@ void* AlsaMidiPort::get_buffer (pframes_t /* nframes */)
 {
 	if (is_input ()) {
 		(_buffer[_bufperiod]).clear ();
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		for (std::set<BackendPortPtr>::const_iterator i = connections.begin ();
-		     i != connections.end ();
-		     ++i) {
-			const AlsaMidiBuffer* src = std::dynamic_pointer_cast<const AlsaMidiPort> (*i)->const_buffer ();
+		std::shared_ptr<ConnectionList const> sources = connection_list ();
+		for (ConnectionList::const_iterator i = sources->begin (); i != sources->end (); ++i) {
+			const AlsaMidiBuffer* src = static_cast<const AlsaMidiPort*> (*i)->const_buffer ();
 			for (AlsaMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
 				(_buffer[_bufperiod]).push_back (*it);
 			}
@@ -21,6 +21,7 @@
 
 #include <cmath>
 #include <cstdlib>
+#include <ctime>
 
 #include <glibmm.h>
 
@@ -31,6 +32,8 @@
 #ifdef PLATFORM_WINDOWS
 #include <windows.h>
 #include <pbd/windows_timer_utils.h>
+#else
+#include <unistd.h>
 #endif
 
 #include "dummy_audiobackend.h"
@@ -42,6 +45,7 @@
 
 #include "ardour/debug.h"
 #include "ardour/port_manager.h"
+#include "ardour/runtime_functions.h"
 
 #include "pbd/i18n.h"
 
@@ -61,6 +65,18 @@ static int64_t _x_get_monotonic_usec() {
 	return g_get_monotonic_time();
 }
 
+/* CPU time consumed by the given thread, or -1 if not available */
+static int64_t _x_thread_cpu_usec (pthread_t thread) {
+#if !defined PLATFORM_WINDOWS && defined _POSIX_THREAD_CPUTIME && _POSIX_THREAD_CPUTIME >= 0
+	clockid_t       cid;
+	struct timespec ts;
+	if (0 == pthread_getcpuclockid (thread, &cid) && 0 == clock_gettime (cid, &ts)) {
+		return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	}
+#endif
+	return -1;
+}
+
 DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 	: AudioBackend (e, info)
 	, PortEngineSharedImpl (e, s_instance_name)
@@ -68,6 +84,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 	, _freewheel (false)
 	, _freewheeling (false)
 	, _realtime (false)
+	, _benchmark (false)
 	, _speedup (1.0)
 	, _device ("")
 	, _samplerate (48000)
@@ -81,6 +98,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 	, _systemic_input_latency (0)
 	, _systemic_output_latency (0)
 	, _processed_samples (0)
+	, _bench_cycles (0)
 {
 	_instance_name = s_instance_name;
 	_device = _("Silence");
@@ -95,6 +113,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 		_driver_speed.push_back (DriverSpeed (_("15x Speed"),    0.06666f));
 		_driver_speed.push_back (DriverSpeed (_("20x Speed"),    0.05f));
 		_driver_speed.push_back (DriverSpeed (_("50x Speed"),    0.02f));
+		_driver_speed.push_back (DriverSpeed (_("Benchmark"),    0.f, false, true));
 	}
 
 }
@@ -222,6 +241,7 @@ DummyAudioBackend::set_driver (const std::string& d)
 		if (d == it->name) {
 			_speedup = it->speedup;
 			_realtime = it->realtime;
+			_benchmark = it->benchmark;
 			return 0;
 		}
 	}
@@ -432,6 +452,14 @@ DummyAudioBackend::_start (bool /*for_latency_measurement*/)
 	engine.reconnect_ports ();
 	_port_change_flag.store (0);
 
+	_bench_cycles = 0;
+	if (_benchmark) {
+		const char* cycles = g_getenv ("ARDOUR_DUMMY_BENCHMARK_CYCLES");
+		if (cycles) {
+			_bench_cycles = strtoull (cycles, NULL, 10);
+		}
+	}
+
 	bool ok = _realtime;
 	if (_realtime && pbd_realtime_pthread_create ("Dummy Main", PBD_SCHED_FIFO, PBD_RT_PRI_MAIN, PBD_RT_STACKSIZE_PROC, &_main_thread, pthread_process, this)) {
 		PBD::warning << _("DummyAudioBackend: failed to acquire realtime permissions.") << endmsg;
@@ -912,6 +940,10 @@ DummyAudioBackend::main_process_thread ()
 	PBD::MMTIMERS::set_min_resolution();
 #endif
 
+	if (_benchmark) {
+		bench_start ();
+	}
+
 	int64_t clock1;
 	clock1 = -1;
 	while (_running) {
@@ -971,7 +1003,12 @@ DummyAudioBackend::main_process_thread ()
 
 			const int64_t elapsed_time = _dsp_load_calc.elapsed_time_us ();
 			const int64_t nominal_time = _dsp_load_calc.get_max_time_us ();
-			if (elapsed_time < nominal_time) {
+			if (_benchmark) {
+				/* no sleep, continue with the next cycle right away */
+				if (clock1 >= 0) {
+					_bench.add (elapsed_time, nominal_time);
+				}
+			} else if (elapsed_time < nominal_time) {
 				const int64_t sleepy = _speedup * (nominal_time - elapsed_time);
 				Glib::usleep (std::max ((int64_t) 10, sleepy));
 			} else {
@@ -979,7 +1016,15 @@ DummyAudioBackend::main_process_thread ()
 			}
 		} else {
 			_dsp_load = 1.0f;
-			Glib::usleep (10); // don't hog cpu
+			if (!_benchmark) {
+				Glib::usleep (10); // don't hog cpu
+			}
+		}
+
+		if (_benchmark && ++_bench.cycles == _bench_cycles) {
+			bench_report ();
+			engine.halted_callback (_("Dummy benchmark completed."));
+			return 0;
 		}
 
 		/* beginning of next cycle */
@@ -1011,6 +1056,11 @@ DummyAudioBackend::main_process_thread ()
 		}
 
 	}
+
+	if (_benchmark) {
+		bench_report ();
+	}
+
 #ifdef PLATFORM_WINDOWS
 	PBD::MMTIMERS::reset_resolution();
 #endif
@@ -1018,6 +1068,106 @@ DummyAudioBackend::main_process_thread ()
 	return 0;
 }
 
+void
+DummyAudioBackend::BenchStats::reset ()
+{
+	cycles = 0;
+	timed  = 0;
+	xruns  = 0;
+	min    = INT64_MAX;
+	max    = 0;
+	sum    = 0;
+	start  = 0;
+	for (int i = 0; i < n_bins; ++i) {
+		hist[i] = 0;
+	}
+	thread_cpu.clear ();
+}
+
+void
+DummyAudioBackend::BenchStats::add (int64_t elapsed, int64_t nominal)
+{
+	/* the monotonic clock may be off by a bit on some systems */
+	elapsed = std::max ((int64_t)0, elapsed);
+
+	++timed;
+	sum += elapsed;
+	min = std::min (min, elapsed);
+	max = std::max (max, elapsed);
+
+	int bin;
+	if (elapsed <= nominal) {
+		bin = std::min (9, (int) (10 * elapsed / nominal));
+	} else if (2 * elapsed <= 3 * nominal) {
+		bin = 10;
+	} else if (elapsed <= 2 * nominal) {
+		bin = 11;
+	} else {
+		bin = 12;
+	}
+	++hist[bin];
+
+	if (elapsed > nominal) {
+		++xruns;
+	}
+}
+
+void
+DummyAudioBackend::bench_start ()
+{
+	_bench.reset ();
+	_bench.start = _x_get_monotonic_usec ();
+	for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i) {
+		_bench.thread_cpu.push_back (_x_thread_cpu_usec (*i));
+	}
+}
+
+void
+DummyAudioBackend::bench_report ()
+{
+	const int64_t wall = _x_get_monotonic_usec () - _bench.start;
+
+	if (_bench.timed == 0 || wall <= 0) {
+		_bench.reset ();
+		return;
+	}
+
+	const double period = 1e6 * _samples_per_period / _samplerate;
+
+	PBD::info << string_compose (_("DummyAudioBackend: benchmark processed %1 cycles of %2 samples in %3 sec (%4 x realtime)"),
+			_bench.cycles, _samples_per_period, wall * 1e-6, rint (10. * _bench.cycles * period / wall) / 10.) << endmsg;
+
+	PBD::info << string_compose (_("DummyAudioBackend: DSP time per cycle min: %1 avg: %2 max: %3 [us], period: %4 [us]"),
+			_bench.min, rint ((double)_bench.sum / _bench.timed), _bench.max, rint (period)) << endmsg;
+
+	PBD::info << string_compose (_("DummyAudioBackend: %1 cycles took longer than the period (xruns in realtime)"), _bench.xruns) << endmsg;
+
+	static const char* bin_name[BenchStats::n_bins] = {
+		"  0 -  10%", " 10 -  20%", " 20 -  30%", " 30 -  40%", " 40 -  50%",
+		" 50 -  60%", " 60 -  70%", " 70 -  80%", " 80 -  90%", " 90 - 100%",
+		"100 - 150%", "150 - 200%", "     >200%"
+	};
+
+	for (int i = 0; i < BenchStats::n_bins; ++i) {
+		PBD::info << string_compose (X_("DummyAudioBackend:   %1 of period: %2 cycles (%3%%)"),
+				bin_name[i], _bench.hist[i], rint (1000. * _bench.hist[i] / _bench.timed) / 10.) << endmsg;
+	}
+
+	/* threads that were created after the benchmark started are accounted from zero */
+	size_t n = 0;
+	for (std::vector<pthread_t>::const_iterator i = _threads.begin (); i != _threads.end (); ++i, ++n) {
+		const int64_t cpu0 = n < _bench.thread_cpu.size () ? _bench.thread_cpu[n] : 0;
+		const int64_t cpu1 = _x_thread_cpu_usec (*i);
+		if (cpu0 < 0 || cpu1 < 0) {
+			continue;
+		}
+		PBD::info << string_compose (_("DummyAudioBackend: process thread %1 utilization: %2%%"),
+				n + 1, rint (1000. * (cpu1 - cpu0) / wall) / 10.) << endmsg;
+	}
+
+	_bench.reset ();
+}
+
 
 /******************************************************************************/
 
@@ -1108,6 +1258,15 @@ void DummyPort::setup_random_number_generator ()
 	_rseed = g_get_monotonic_time();
 	}
 	_rseed = (_rseed + (uint64_t)this) % INT_MAX;
+
+	if (_engine.is_benchmark ()) {
+		/* reproducible input: seed from the port-name */
+		const std::string n = name ();
+		_rseed = 5381;
+		for (std::string::const_iterator i = n.begin (); i != n.end (); ++i) {
+			_rseed = ((_rseed << 5) + _rseed + (uint8_t)*i) % INT_MAX;
+		}
+	}
 	if (_rseed == 0) _rseed = 1;
 }
 
@@ -1593,28 +1752,28 @@ void*
 DummyAudioPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		std::set<BackendPortPtr>::const_iterator it = connections.begin ();
-		if (it == connections.end ()) {
+		std::shared_ptr<ConnectionList const> sources = connection_list ();
+		ConnectionList::const_iterator it = sources->begin ();
+		if (it == sources->end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
 		} else {
-			std::shared_ptr<DummyAudioPort> source = std::dynamic_pointer_cast<DummyAudioPort>(*it);
-			assert (source && source->is_output ());
+			DummyAudioPort* source = static_cast<DummyAudioPort*> (*it);
+			assert (source->is_output ());
 			if (source->is_physical() && source->is_terminal()) {
 				source->get_buffer(n_samples); // generate signal.
 			}
-			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
-			while (++it != connections.end ()) {
-				source = std::dynamic_pointer_cast<DummyAudioPort>(*it);
-				assert (source && source->is_output ());
-				Sample* dst = buffer ();
+			if (sources->size () == 1) {
+				/* use the buffer of a single source directly, as JACK does */
+				return source->buffer ();
+			}
+			copy_vector (_buffer, source->const_buffer (), n_samples);
+			while (++it != sources->end ()) {
+				source = static_cast<DummyAudioPort*> (*it);
+				assert (source->is_output ());
 				if (source->is_physical() && source->is_terminal()) {
 					source->get_buffer(n_samples); // generate signal.
 				}
-				const Sample* src = source->const_buffer ();
-				for (uint32_t s = 0; s < n_samples; ++s, ++dst, ++src) {
-					*dst += *src;
-				}
+				mix_buffers_no_gain (_buffer, source->const_buffer (), n_samples);
 			}
 		}
 	} else if (is_output () && is_physical () && is_terminal()) {
@@ -1871,11 +2030,9 @@ void* DummyMidiPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
 		_buffer.clear ();
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		for (std::set<BackendPortPtr>::const_iterator i = connections.begin ();
-				i != connections.end ();
-				++i) {
-			std::shared_ptr<DummyMidiPort> source = std::dynamic_pointer_cast<DummyMidiPort>(*i);
+		std::shared_ptr<ConnectionList const> sources = connection_list ();
+		for (ConnectionList::const_iterator i = sources->begin (); i != sources->end (); ++i) {
+			DummyMidiPort* source = static_cast<DummyMidiPort*>(*i);
 			if (source->is_physical() && source->is_terminal()) {
 				source->get_buffer(n_samples); // generate signal.
 			}
@@ -89,7 +89,7 @@ class DummyPort : public BackendPort {
 		PBD::Mutex generator_lock;
 
         private:
-		AudioBackend& _engine;
+		DummyAudioBackend& _engine;
 
 }; // class DummyPort
 
@@ -190,6 +190,7 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl
 		~DummyAudioBackend ();
 
 		bool is_running () const { return _running; }
+		bool is_benchmark () const { return _benchmark; }
 
 		/* AUDIOBACKEND API */
 
@@ -350,7 +351,27 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl
 			std::string name;
 			float speedup;
 			bool realtime;
-			DriverSpeed (const std::string& n, float s, bool r = false) : name (n), speedup (s), realtime (r) {}
+			bool benchmark;
+			DriverSpeed (const std::string& n, float s, bool r = false, bool b = false) : name (n), speedup (s), realtime (r), benchmark (b) {}
+		};
+
+		/* per cycle timing, collected in benchmark mode */
+		struct BenchStats {
+			BenchStats () { reset (); }
+			void reset ();
+			void add (int64_t elapsed, int64_t nominal);
+
+			static const int n_bins = 13; // 10% steps up to the nominal period, then 150%, 200%, more
+
+			uint64_t cycles;
+			uint64_t timed;
+			uint64_t xruns;
+			int64_t  min;
+			int64_t  max;
+			int64_t  sum;
+			uint64_t hist[n_bins];
+			int64_t  start;
+			std::vector<int64_t> thread_cpu;
 		};
 
 		std::string _instance_name;
@@ -362,6 +383,7 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl
 		bool  _freewheel;
 		bool  _freewheeling;
 		bool  _realtime;
+		bool  _benchmark;
 		float _speedup;
 
 		std::string _device;
@@ -384,6 +406,12 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl
 
 		samplecnt_t _processed_samples;
 
+		uint64_t   _bench_cycles; // cycles to run in benchmark mode, 0: until stopped
+		BenchStats _bench;
+
+		void bench_start ();
+		void bench_report ();
+
 		pthread_t _main_thread;
 
 		/* process threads */
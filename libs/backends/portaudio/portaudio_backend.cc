@@ -48,6 +48,7 @@
 
 #include "ardour/filesystem_paths.h"
 #include "ardour/port_manager.h"
+#include "ardour/runtime_functions.h"
 #include "pbd/i18n.h"
 
 #include "audio_utils.h"
@@ -1632,15 +1633,6 @@ PortAudioBackend::blocking_process_main(const float* interleaved_input_data,
 
 	process_incoming_midi ();
 
-	/* clear output buffers */
-	for (std::vector<BackendPortPtr>::const_iterator it = _system_outputs.begin();
-	     it != _system_outputs.end();
-	     ++it) {
-		memset((*it)->get_buffer(_samples_per_period),
-		       0,
-		       _samples_per_period * sizeof(Sample));
-	}
-
 	_last_cycle_start = _cycle_timer.get_start();
 	_cycle_timer.reset_start(PBD::get_microseconds());
 	_cycle_count++;
@@ -1914,21 +1906,20 @@ PortAudioPort::~PortAudioPort () { }
 void* PortAudioPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
-		std::set<BackendPortPtr>::const_iterator it = get_connections ().begin ();
-		if (it == get_connections ().end ()) {
+		std::shared_ptr<ConnectionList const> sources = connection_list ();
+		ConnectionList::const_iterator it = sources->begin ();
+		if (it == sources->end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
+		} else if (sources->size () == 1) {
+			/* use the buffer of a single source directly, as JACK does */
+			assert ((*it)->is_output ());
+			return static_cast<PortAudioPort*> (*it)->buffer ();
 		} else {
-			std::shared_ptr<const PortAudioPort> source = std::dynamic_pointer_cast<const PortAudioPort>(*it);
-			assert (source && source->is_output ());
-			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
-			while (++it != get_connections ().end ()) {
-				source = std::dynamic_pointer_cast<const PortAudioPort>(*it);
-				assert (source && source->is_output ());
-				Sample* dst = buffer ();
-				const Sample* src = source->const_buffer ();
-				for (uint32_t s = 0; s < n_samples; ++s, ++dst, ++src) {
-					*dst += *src;
-				}
+			assert ((*it)->is_output ());
+			copy_vector (_buffer, static_cast<const PortAudioPort*> (*it)->const_buffer (), n_samples);
+			while (++it != sources->end ()) {
+				assert ((*it)->is_output ());
+				mix_buffers_no_gain (_buffer, static_cast<const PortAudioPort*> (*it)->const_buffer (), n_samples);
 			}
 		}
 	}
@@ -1960,10 +1951,9 @@ void* PortMidiPort::get_buffer (pframes_t /* nframes */)
 {
 	if (is_input ()) {
 		(_buffer[_bufperiod]).clear ();
-		for (std::set<BackendPortPtr>::const_iterator i = get_connections ().begin ();
-				i != get_connections ().end ();
-				++i) {
-			const PortMidiBuffer * src = std::dynamic_pointer_cast<const PortMidiPort>(*i)->const_buffer ();
+		std::shared_ptr<ConnectionList const> sources = connection_list ();
+		for (ConnectionList::const_iterator i = sources->begin (); i != sources->end (); ++i) {
+			const PortMidiBuffer * src = static_cast<const PortMidiPort*>(*i)->const_buffer ();
 			for (PortMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
 				(_buffer[_bufperiod]).push_back (*it);
 			}
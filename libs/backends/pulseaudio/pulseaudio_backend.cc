@@ -31,6 +31,7 @@
 #include "pbd/pthread_utils.h"
 
 #include "ardour/port_manager.h"
+#include "ardour/runtime_functions.h"
 
 #include "pulseaudio_backend.h"
 
@@ -1162,23 +1163,20 @@ void*
 PulseAudioPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
-		const std::set<BackendPortPtr>&          connections = get_connections ();
-		std::set<BackendPortPtr>::const_iterator it          = connections.begin ();
-
-		if (it == connections.end ()) {
+		std::shared_ptr<ConnectionList const> sources = connection_list ();
+		ConnectionList::const_iterator it = sources->begin ();
+		if (it == sources->end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
+		} else if (sources->size () == 1) {
+			/* use the buffer of a single source directly, as JACK does */
+			assert ((*it)->is_output ());
+			return static_cast<PulseAudioPort*> (*it)->buffer ();
 		} else {
-			std::shared_ptr<PulseAudioPort> source = std::dynamic_pointer_cast<PulseAudioPort> (*it);
-			assert (source && source->is_output ());
-			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
-			while (++it != connections.end ()) {
-				source = std::dynamic_pointer_cast<PulseAudioPort> (*it);
-				assert (source && source->is_output ());
-				Sample*       dst = _buffer;
-				const Sample* src = source->const_buffer ();
-				for (uint32_t s = 0; s < n_samples; ++s, ++dst, ++src) {
-					*dst += *src;
-				}
+			assert ((*it)->is_output ());
+			copy_vector (_buffer, static_cast<const PulseAudioPort*> (*it)->const_buffer (), n_samples);
+			while (++it != sources->end ()) {
+				assert ((*it)->is_output ());
+				mix_buffers_no_gain (_buffer, static_cast<const PulseAudioPort*> (*it)->const_buffer (), n_samples);
 			}
 		}
 	}
@@ -1208,11 +1206,9 @@ void* PulseMidiPort::get_buffer (pframes_t /*n_samples*/)
 {
 	if (is_input ()) {
 		_buffer.clear ();
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		for (std::set<BackendPortPtr>::const_iterator i = connections.begin ();
-		     i != connections.end ();
-		     ++i) {
-			const PulseMidiBuffer* src = std::dynamic_pointer_cast<PulseMidiPort> (*i)->const_buffer ();
+		std::shared_ptr<ConnectionList const> sources = connection_list ();
+		for (ConnectionList::const_iterator i = sources->begin (); i != sources->end (); ++i) {
+			const PulseMidiBuffer* src = static_cast<const PulseMidiPort*> (*i)->const_buffer ();
 			for (PulseMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
 				_buffer.push_back (*it);
 			}
@@ -1,6 +1,10 @@
-#include "pbd/compose.h"
+#include <glib.h>
 #include "canvas/types.h"
 #include "canvas/canvas.h"
+#include "canvas/container.h"
+#include "canvas/line.h"
+#include "canvas/rectangle.h"
+#include "canvas/utils.h"
 #include "benchmark.h"
 
 using namespace std;
@@ -22,11 +26,140 @@ rect_random (double rough_size)
 	return Rect (x, y, x + w, y + h);
 }
 
-Benchmark::Benchmark (string const & session)
+BenchmarkCanvas::BenchmarkCanvas (int width, int height)
+	: _width (width)
+	, _height (height)
+{
+	_image = Cairo::ImageSurface::create (Cairo::FORMAT_ARGB32, _width, _height);
+	_context = Cairo::Context::create (_image);
+}
+
+void
+BenchmarkCanvas::request_redraw (Rect const & area)
+{
+	Rect r = area.intersection (visible_area ());
+	if (r) {
+		_damage.push_back (r);
+	}
+}
+
+void
+BenchmarkCanvas::render_area (Rect const & r)
+{
+	_context->set_identity_matrix ();
+	_context->rectangle (r.x0, r.y0, r.width (), r.height ());
+	_context->set_source_rgb (0, 0, 0);
+	_context->fill ();
+
+	render (r, _context);
+}
+
+void
+BenchmarkCanvas::render_all ()
+{
+	_damage.clear ();
+	render_area (visible_area ());
+	_image->flush ();
+}
+
+void
+BenchmarkCanvas::render_damage (bool coalesce)
+{
+	if (coalesce) {
+		coalesce_damage (_damage);
+	}
+
+	for (auto const & r : _damage) {
+		render_area (r);
+	}
+
+	_damage.clear ();
+	_image->flush ();
+}
+
+void
+BenchmarkCanvas::write_to_png (string const & path)
+{
+	_image->write_to_png (path);
+}
+
+EditorScene::EditorScene (BenchmarkCanvas& canvas, bool cache_layers)
+	: _frame (0)
+{
+	int const n_tracks = 32;
+	int const n_regions = 64;
+	double const track_height = 64;
+	double const ruler_height = 80;
+	double const width = canvas.width ();
+
+	srand (1);
+
+	_grid = new Container (canvas.root ());
+	for (double x = 0; x < width; x += 8) {
+		Line* l = new Line (_grid);
+		l->set (Duple (x, ruler_height), Duple (x, canvas.height ()));
+		l->set_outline_color (0x404040ff);
+	}
+
+	_tracks = new Container (canvas.root ());
+	for (int t = 0; t < n_tracks; ++t) {
+		double const y = ruler_height + t * track_height;
+		for (int r = 0; r < n_regions; ++r) {
+			double const x = double_random () * width;
+			Rectangle* region = new Rectangle (_tracks, Rect (x, y, x + 10 + double_random () * 200, y + track_height - 2));
+			region->set_fill_color (0x7080a0ff);
+			region->set_outline_color (0xffffffff);
+		}
+	}
+
+	_rulers = new Container (canvas.root ());
+	for (int i = 0; i < 4; ++i) {
+		Rectangle* ruler = new Rectangle (_rulers, Rect (0, i * ruler_height / 4, width, (i + 1) * ruler_height / 4));
+		ruler->set_fill_color (0x303030ff);
+		ruler->set_outline_color (0x808080ff);
+		for (double x = 0; x < width; x += 4) {
+			Line* tick = new Line (_rulers);
+			double const h = (int (x) % 64) == 0 ? ruler_height / 4 : ruler_height / 16;
+			tick->set (Duple (x, (i + 1) * ruler_height / 4 - h), Duple (x, (i + 1) * ruler_height / 4));
+			tick->set_outline_color (0xc0c0c0ff);
+		}
+	}
+
+	_meter = new Rectangle (canvas.root (), Rect (width - 16, ruler_height, width - 8, canvas.height ()));
+	_meter->set_fill_color (0x00ff00ff);
+
+	_playhead = new Line (canvas.root ());
+	_playhead->set (Duple (0, 0), Duple (0, canvas.height ()));
+	_playhead->set_outline_color (0xff0000ff);
+
+	_rulers->set_render_cached (cache_layers);
+	_grid->set_render_cached (cache_layers);
+	_tracks->set_render_cached (cache_layers);
+}
+
+void
+EditorScene::step ()
+{
+	++_frame;
+	_playhead->set_x (_frame % 1900, _frame % 1900);
+	Rect r = _meter->get ();
+	r.y0 = r.y1 - (_frame * 37 % 1000);
+	_meter->set (r);
+}
+
+Benchmark::Benchmark (bool cache_layers)
 	: _iterations (1)
 {
-	string path = string_compose ("../../libs/canvas/benchmark/sessions/%1.xml", session);
-	_canvas = new ImageCanvas (new XMLTree (path), Duple (4096, 4096));
+	_canvas = new BenchmarkCanvas;
+	_scene = new EditorScene (*_canvas, cache_layers);
+	/* populate the caches, if any */
+	_canvas->render_all ();
+}
+
+Benchmark::~Benchmark ()
+{
+	delete _scene;
+	delete _canvas;
 }
 
 void
@@ -35,7 +168,6 @@ Benchmark::set_iterations (int n)
 	_iterations = n;
 }
 
-/** @return wallclock time in seconds */
 double
 Benchmark::run ()
 {
@@ -44,12 +176,12 @@ Benchmark::run ()
 	start = g_get_monotonic_time ();
 
 	for (int i = 0; i < _iterations; ++i) {
-		do_run (*_canvas);
+		do_run (*_canvas, *_scene);
 	}
 
 	stop = g_get_monotonic_time ();
 
 	finish (*_canvas);
 
-	return (start - stop) / 1e6;
+	return (stop - start) / 1e3 / _iterations;
 }
@@ -1,26 +1,100 @@
-#include "pbd/xml++.h"
+#include <vector>
+#include <cairomm/surface.h>
+#include "canvas/canvas.h"
 #include "canvas/types.h"
 
 extern double double_random ();
 extern ArdourCanvas::Rect rect_random (double);
 
 namespace ArdourCanvas {
-	class ImageCanvas;
+	class Container;
+	class Line;
+	class Rectangle;
 }
 
+/** A canvas without a window. It renders into an image and collects
+ *  redraw requests, like a window system would.
+ */
+class BenchmarkCanvas : public ArdourCanvas::Canvas
+{
+public:
+	BenchmarkCanvas (int width = 1920, int height = 1080);
+
+	void request_redraw (ArdourCanvas::Rect const &);
+	void request_size (ArdourCanvas::Duple) {}
+	void grab (ArdourCanvas::Item *) {}
+	void ungrab () {}
+	void queue_resize () {}
+	void focus (ArdourCanvas::Item *) {}
+	void unfocus (ArdourCanvas::Item*) {}
+	ArdourCanvas::Rect visible_area () const { return ArdourCanvas::Rect (0, 0, _width, _height); }
+	ArdourCanvas::Coord width () const { return _width; }
+	ArdourCanvas::Coord height () const { return _height; }
+	bool get_mouse_position (ArdourCanvas::Duple&) const { return false; }
+	void re_enter () {}
+	Glib::RefPtr<Pango::Context> get_pango_context () { return Glib::RefPtr<Pango::Context> (); }
+
+	/** Render the whole visible area */
+	void render_all ();
+	/** Render the areas requested since the last call, as an expose handler would.
+	 *  @param coalesce true to merge them using ArdourCanvas::coalesce_damage()
+	 */
+	void render_damage (bool coalesce);
+
+	std::vector<ArdourCanvas::Rect> const & damage () const { return _damage; }
+	void write_to_png (std::string const &);
+
+protected:
+	void pick_current_item (int) {}
+	void pick_current_item (ArdourCanvas::Duple const &, int) {}
+
+private:
+	void render_area (ArdourCanvas::Rect const &);
+
+	int _width;
+	int _height;
+	Cairo::RefPtr<Cairo::ImageSurface> _image;
+	Cairo::RefPtr<Cairo::Context> _context;
+	std::vector<ArdourCanvas::Rect> _damage;
+};
+
+/** An editor-like scene: rulers, grid lines and many tracks with regions,
+ *  a playhead and a meter, which change in every frame.
+ */
+class EditorScene
+{
+public:
+	EditorScene (BenchmarkCanvas&, bool cache_layers);
+
+	/** Advance the playhead and the meter by one frame */
+	void step ();
+
+private:
+	ArdourCanvas::Container* _rulers;
+	ArdourCanvas::Container* _grid;
+	ArdourCanvas::Container* _tracks;
+	ArdourCanvas::Line*      _playhead;
+	ArdourCanvas::Rectangle* _meter;
+	int                      _frame;
+};
+
 class Benchmark
 {
 public:
-	Benchmark (std::string const &);
-	virtual ~Benchmark () {}
+	Benchmark (bool cache_layers);
+	virtual ~Benchmark ();
 
 	void set_iterations (int);
+	/** @return wallclock time per iteration in milliseconds */
 	double run ();
 
-	virtual void do_run (ArdourCanvas::ImageCanvas &) = 0;
-	virtual void finish (ArdourCanvas::ImageCanvas &) {}
+	virtual void do_run (BenchmarkCanvas &, EditorScene &) = 0;
+	virtual void finish (BenchmarkCanvas &) {}
+
+protected:
+	BenchmarkCanvas* _canvas;
+	EditorScene* _scene;
 
 private:
-	ArdourCanvas::ImageCanvas* _canvas;
 	int _iterations;
 };
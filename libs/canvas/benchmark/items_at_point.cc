@@ -1,53 +1,122 @@
-#include "canvas/group.h"
-#include "canvas/canvas.h"
-#include "canvas/root_group.h"
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+
+#include <glib.h>
+
+#include "canvas/container.h"
+#include "canvas/lookup_table.h"
 #include "canvas/rectangle.h"
 #include "benchmark.h"
 
 using namespace std;
 using namespace ArdourCanvas;
 
+int const n_notes = 100000;
+int const n_tests = 10000;
+int const n_moves = 1000;
+/* a long MIDI region: 128 note rows, notes along 100k pixels */
+double const region_width = 100000;
+double const note_height = 8;
+
+struct Result {
+	double build;
+	double query;
+	double move;
+	vector<vector<int> > found;
+};
+
+static double
+elapsed (int64_t start)
+{
+	return (g_get_monotonic_time () - start) / 1e6;
+}
+
 static void
-test (int items_per_cell)
+query (Item* root, map<Item const *, int> const & index, vector<Duple> const & points, vector<vector<int> >& found)
 {
-	Group::default_items_per_cell = items_per_cell;
+	for (auto const & p : points) {
+		vector<Item const *> items;
+		root->add_items_at_point (p, items);
 
-	int const n_rectangles = 10000;
-	int const n_tests = 1000;
-	double const rough_size = 1000;
-	srand (1);
+		vector<int> f;
+		for (auto const & i : items) {
+			map<Item const *, int>::const_iterator x = index.find (i);
+			f.push_back (x == index.end () ? -1 : x->second);
+		}
+		found.push_back (f);
+	}
+}
+
+static Result
+test (size_t min_items)
+{
+	QuadTreeLookupTable::min_items = min_items;
+
+	Result r;
+	BenchmarkCanvas canvas;
+	Container* notes = new Container (canvas.root ());
+	vector<Rectangle*> rectangles;
+	map<Item const *, int> index;
 
-	ImageCanvas canvas;
+	srand (1);
 
-	list<Item*> rectangles;
+	int64_t start = g_get_monotonic_time ();
 
-	for (int i = 0; i < n_rectangles; ++i) {
-		rectangles.push_back (new Rectangle (canvas.root(), rect_random (rough_size)));
+	for (int i = 0; i < n_notes; ++i) {
+		double const x = double_random () * region_width;
+		double const y = (rand () % 128) * note_height;
+		Rectangle* rect = new Rectangle (notes, Rect (x, y, x + 10 + double_random () * 200, y + note_height));
+		rectangles.push_back (rect);
+		index[rect] = i;
 	}
 
+	vector<Duple> points;
 	for (int i = 0; i < n_tests; ++i) {
-		Duple test (double_random() * rough_size, double_random() * rough_size);
+		points.push_back (Duple (double_random () * region_width, double_random () * 128 * note_height));
+	}
+
+	/* first lookup creates the lookup table */
+	vector<Item const *> items;
+	canvas.root ()->add_items_at_point (points.front (), items);
+
+	r.build = elapsed (start);
 
-		/* ask the group what's at this point */
+	start = g_get_monotonic_time ();
+	query (canvas.root (), index, points, r.found);
+	r.query = elapsed (start);
+
+	/* move some notes around, as when editing, and look them up again */
+	start = g_get_monotonic_time ();
+	for (int i = 0; i < n_moves; ++i) {
+		Rectangle* rect = rectangles[rand () % n_notes];
+		rect->set_position (Duple (double_random () * region_width / 2, (rand () % 16) * note_height));
 		vector<Item const *> items;
-		canvas.root()->add_items_at_point (test, items);
+		canvas.root ()->add_items_at_point (points[i], items);
 	}
+	r.move = elapsed (start);
+
+	query (canvas.root (), index, points, r.found);
+
+	return r;
 }
 
 int main ()
 {
-	int tests[] = { 1, 2, 4, 8, 16, 32, 64, 128, 256 };
+	size_t const min_items = QuadTreeLookupTable::min_items;
 
-	for (unsigned int i = 0; i < sizeof (tests) / sizeof (int); ++i) {
-		int64_t start, stop;
+	Result linear = test (INT_MAX);
+	Result indexed = test (min_items);
 
-		start = g_get_monotonic_time ();
-		test (tests[i]);
-		stop = g_get_monotonic_time ();
+	cout << n_notes << " items, " << n_tests << " lookups, " << n_moves << " moves\n";
+	cout << "linear:   build " << linear.build << "s lookups " << linear.query << "s moves " << linear.move << "s\n";
+	cout << "quadtree: build " << indexed.build << "s lookups " << indexed.query << "s moves " << indexed.move << "s\n";
 
-		double seconds = (start - stop) / 1e6;
-
-		cout << "Test " << tests[i] << ": " << seconds << "\n";
+	if (linear.found != indexed.found) {
+		cerr << "Results differ\n";
+		return 1;
 	}
-}
 
+	return 0;
+}
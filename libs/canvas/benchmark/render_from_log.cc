@@ -1,62 +1,51 @@
-#include <sys/time.h>
-#include <pangomm/init.h>
-#include "pbd/compose.h"
-#include "pbd/xml++.h"
-#include "canvas/group.h"
+#include <iostream>
+#include <cstdlib>
 #include "canvas/canvas.h"
-#include "canvas/root_group.h"
-#include "canvas/rectangle.h"
+#include "canvas/types.h"
 #include "benchmark.h"
 
 using namespace std;
 using namespace ArdourCanvas;
 
+/** Record the areas invalidated by a number of frames, then replay
+ *  them without changing the scene.
+ */
 class RenderFromLog : public Benchmark
 {
 public:
-	RenderFromLog (string const & session) : Benchmark (session) {}
-
-	void set_items_per_cell (int items)
+	RenderFromLog (bool cache_layers, int frames)
+		: Benchmark (cache_layers)
 	{
-		_items_per_cell = items;
+		for (int i = 0; i < frames; ++i) {
+			_scene->step ();
+			_log.push_back (_canvas->damage ());
+			_canvas->render_damage (false);
+		}
 	}
 
-	void do_run (ImageCanvas& canvas)
+	void do_run (BenchmarkCanvas& canvas, EditorScene&)
 	{
-		Group::default_items_per_cell = _items_per_cell;
-		canvas.set_log_renders (false);
-
-		list<Rect> const & renders = canvas.renders ();
-
-		for (list<Rect>::const_iterator i = renders.begin(); i != renders.end(); ++i) {
-			canvas.render_to_image (*i);
+		for (auto const & frame : _log) {
+			for (auto const & r : frame) {
+				canvas.request_redraw (r);
+			}
+			canvas.render_damage (true);
 		}
 	}
 
 private:
-	int _items_per_cell;
+	vector<vector<Rect> > _log;
 };
 
 int main (int argc, char* argv[])
 {
-	if (argc < 2) {
-		cerr << "Syntax: render_parts <session>\n";
-		exit (EXIT_FAILURE);
-	}
+	int frames = argc > 1 ? atoi (argv[1]) : 1000;
 
-	Pango::init ();
+	RenderFromLog uncached (false, frames);
+	cout << "uncached: " << uncached.run () / frames << " ms/frame\n";
 
-	RenderFromLog render_from_log (argv[1]);
-
-//	int tests[] = { 16, 32, 64, 128, 256, 512, 1024, 1e4, 1e5, 1e6 };
-	int tests[] = { 16 };
-
-	for (unsigned int i = 0; i < sizeof (tests) / sizeof (int); ++i) {
-		render_from_log.set_items_per_cell (tests[i]);
-		cout << tests[i] << " " << render_from_log.run () << "\n";
-	}
+	RenderFromLog cached (true, frames);
+	cout << "cached:   " << cached.run () / frames << " ms/frame\n";
 
 	return 0;
 }
-
-
@@ -1,58 +1,52 @@
-#include <sys/time.h>
-#include <pangomm/init.h>
-#include "pbd/compose.h"
-#include "pbd/xml++.h"
-#include "canvas/group.h"
+#include <iostream>
+#include <cstdlib>
 #include "canvas/canvas.h"
-#include "canvas/root_group.h"
-#include "canvas/rectangle.h"
+#include "canvas/types.h"
 #include "benchmark.h"
 
 using namespace std;
 using namespace ArdourCanvas;
 
+/** Move the playhead and a meter in every frame, and render only the
+ *  areas that they invalidate, as an expose handler would.
+ */
 class RenderParts : public Benchmark
 {
 public:
-	RenderParts (string const & session) : Benchmark (session) {}
+	RenderParts (bool cache_layers, bool coalesce)
+		: Benchmark (cache_layers)
+		, _coalesce (coalesce)
+	{}
 
-	void set_items_per_cell (int items)
+	void do_run (BenchmarkCanvas& canvas, EditorScene& scene)
 	{
-		_items_per_cell = items;
-	}
-
-	void do_run (ImageCanvas& canvas)
-	{
-		Group::default_items_per_cell = _items_per_cell;
-
-		for (int i = 0; i < 1e4; i += 50) {
-			canvas.render_to_image (Rect (i, 0, i + 50, 1024));
-		}
+		scene.step ();
+		canvas.render_damage (_coalesce);
 	}
 
 private:
-	int _items_per_cell;
+	bool _coalesce;
 };
 
 int main (int argc, char* argv[])
 {
-	if (argc < 2) {
-		cerr << "Syntax: render_parts <session>\n";
-		exit (EXIT_FAILURE);
-	}
-
-	Pango::init ();
-
-	RenderParts render_parts (argv[1]);
-
-	int tests[] = { 16, 32, 64, 128, 256, 512, 1024, 1e4, 1e5, 1e6 };
-
-	for (unsigned int i = 0; i < sizeof (tests) / sizeof (int); ++i) {
-		render_parts.set_items_per_cell (tests[i]);
-		cout << tests[i] << " " << render_parts.run () << "\n";
+	int iterations = argc > 1 ? atoi (argv[1]) : 1000;
+
+	struct {
+		char const * name;
+		bool cache_layers;
+		bool coalesce;
+	} tests[] = {
+		{ "uncached:            ", false, false },
+		{ "uncached, coalesced: ", false, true },
+		{ "cached, coalesced:   ", true, true },
+	};
+
+	for (unsigned int i = 0; i < sizeof (tests) / sizeof (tests[0]); ++i) {
+		RenderParts render_parts (tests[i].cache_layers, tests[i].coalesce);
+		render_parts.set_iterations (iterations);
+		cout << tests[i].name << render_parts.run () << " ms/frame\n";
 	}
 
 	return 0;
 }
-
-
@@ -1,7 +1,5 @@
-#include <sys/time.h>
-#include <pangomm/init.h>
-#include "pbd/xml++.h"
-#include "pbd/compose.h"
+#include <iostream>
+#include <cstdlib>
 #include "canvas/canvas.h"
 #include "canvas/types.h"
 #include "benchmark.h"
@@ -9,17 +7,21 @@
 using namespace std;
 using namespace ArdourCanvas;
 
+/** Re-render the whole visible area, e.g. after the editor is scrolled or
+ *  exposed; with cached layers this mostly blits the cached surfaces.
+ */
 class RenderWhole : public Benchmark
 {
 public:
-	RenderWhole (string const & session) : Benchmark (session) {}
+	RenderWhole (bool cache_layers) : Benchmark (cache_layers) {}
 
-	void do_run (ImageCanvas& canvas)
+	void do_run (BenchmarkCanvas& canvas, EditorScene& scene)
 	{
-		canvas.render_to_image (Rect (0, 0, 4096, 1024));
+		scene.step ();
+		canvas.render_all ();
 	}
 
-	void finish (ImageCanvas& canvas)
+	void finish (BenchmarkCanvas& canvas)
 	{
 		canvas.write_to_png ("session.png");
 	}
@@ -27,20 +29,15 @@ public:
 
 int main (int argc, char* argv[])
 {
-	if (argc < 2) {
-		cerr << "Syntax: render_whole <session-name> [<number-of-iterations>]\n";
-		exit (EXIT_FAILURE);
-	}
-
-	Pango::init ();
+	int iterations = argc > 1 ? atoi (argv[1]) : 100;
 
-	RenderWhole render_whole (argv[1]);
-
-	if (argc > 2) {
-		render_whole.set_iterations (atoi (argv[2]));
-	}
+	RenderWhole uncached (false);
+	uncached.set_iterations (iterations);
+	cout << "uncached: " << uncached.run () << " ms/frame\n";
 
-	cout << render_whole.run () << "\n";
+	RenderWhole cached (true);
+	cached.set_iterations (iterations);
+	cout << "cached:   " << cached.run () << " ms/frame\n";
 
 	return 0;
 }
@@ -43,6 +43,7 @@
 #include "canvas/debug.h"
 #include "canvas/line.h"
 #include "canvas/scroll_group.h"
+#include "canvas/utils.h"
 
 #ifdef __APPLE__
 #include <ydk/gdk.h>
@@ -283,7 +284,9 @@ Canvas::item_shown_or_hidden (Item* item)
 	Rect bbox = item->bounding_box ();
 	if (bbox) {
 		if (_queue_draw_frozen) {
-			frozen_area = frozen_area.extend (compute_draw_item_area (item, bbox));
+			Rect const r = compute_draw_item_area (item, bbox);
+			item->damage_render_caches (r);
+			frozen_area = frozen_area.extend (r);
 			return;
 		}
 
@@ -465,7 +468,9 @@ Canvas::item_moved (Item* item, Rect pre_change_parent_bounding_box)
 void
 Canvas::queue_draw_item_area (Item* item, Rect area)
 {
-	request_redraw (compute_draw_item_area (item, area));
+	Rect const r = compute_draw_item_area (item, area);
+	item->damage_render_caches (r);
+	request_redraw (r);
 }
 
 Rect
@@ -1119,18 +1124,29 @@ GtkCanvas::on_expose_event (GdkEventExpose* ev)
 
 		gdk_region_get_rectangles (ev->region, &rects, &nrects);
 
+		/* a region is made of many small bands, e.g. for a playhead
+		 * crossing a meter. Merge them into fewer render passes.
+		 */
+		std::vector<Rect> damage;
+
 		for (gint n = 0; n < nrects; ++n) {
+			damage.push_back (Rect (rects[n].x, rects[n].y, rects[n].x + rects[n].width, rects[n].y + rects[n].height));
+		}
+
+		g_free (rects);
+
+		coalesce_damage (damage);
+
+		for (auto const & r : damage) {
 			draw_context->set_identity_matrix();  //reset the cairo matrix, just in case someone left it transformed after drawing ( cough )
 
 			/* draw background color */
-			draw_context->rectangle (rects[n].x, rects[n].y, rects[n].width, rects[n].height);
+			draw_context->rectangle (r.x0, r.y0, r.width (), r.height ());
 			Gtkmm2ext::set_source_rgba (draw_context, _bg_color);
 			draw_context->fill ();
 
-			Canvas::render (Rect (rects[n].x, rects[n].y, rects[n].x + rects[n].width, rects[n].y + rects[n].height), draw_context);
+			Canvas::render (r, draw_context);
 		}
-
-		g_free (rects);
 	}
 
 	if (_use_image_surface) {
@@ -20,6 +20,8 @@
 #ifndef __CANVAS_CONTAINER_H__
 #define __CANVAS_CONTAINER_H__
 
+#include <cairomm/surface.h>
+
 #include "canvas/item.h"
 
 namespace ArdourCanvas
@@ -76,8 +78,30 @@ public:
 		return _render_with_alpha;
 	}
 
+	/** Keep the rendered children of this container in a surface, which
+	 * is only re-rendered where the children change. Redrawing other items
+	 * on top of the container (e.g. a playhead) then merely blits the
+	 * cached pixels. This is useful for layers that rarely change, such as
+	 * rulers or the grid, but costs memory: the size of the visible part of
+	 * the container.
+	 */
+	void set_render_cached (bool);
+
+	bool render_cached () const {
+		return _render_cached;
+	}
+
+	void render_cache_damaged (Rect const & area) const;
+
 private:
+	void render_from_cache (Rect const & area, Cairo::RefPtr<Cairo::Context> const & context) const;
+
 	double _render_with_alpha;
+	bool   _render_cached;
+
+	mutable Cairo::RefPtr<Cairo::Surface> _render_cache;
+	mutable Rect _render_cache_area;   ///< in item coordinates
+	mutable Rect _render_cache_damage; ///< in item coordinates
 };
 
 }
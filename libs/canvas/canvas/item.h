@@ -63,6 +63,17 @@ public:
 
 	void redraw () const;
 
+	/** Tell this item and its ancestors that \p area needs to be redrawn.
+	 *  @param area Area in **window** coordinates
+	 */
+	void damage_render_caches (Rect const & area) const;
+
+	/** Called when \p area (in window coordinates) of this item or one of
+	 * its children needs to be redrawn. Items which cache their rendering
+	 * must discard that part of the cache.
+	 */
+	virtual void render_cache_damaged (Rect const & area) const {}
+
 	/** Render this item to a Cairo context.
 	 *  @param area Area to draw, in **window** coordinates
 	 *
@@ -348,6 +359,7 @@ public:
 	/* nesting ("grouping") API */
 
 	void invalidate_lut () const;
+	void child_added (Item*);
 	void clear_items (bool with_delete);
 
 	void ensure_lut () const;
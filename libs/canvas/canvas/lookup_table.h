@@ -20,6 +20,7 @@
 #ifndef __CANVAS_LOOKUP_TABLE_H__
 #define __CANVAS_LOOKUP_TABLE_H__
 
+#include <unordered_map>
 #include <vector>
 #include <boost/multi_array.hpp>
 
@@ -42,6 +43,16 @@ public:
     virtual std::vector<Item*> items_at_point (Duple const &) const = 0;
     virtual bool has_item_at_point (Duple const & point) const = 0;
 
+    /* notifications from our item about its children, for tables that
+     * are maintained incrementally.
+     */
+    virtual void item_added (Item*) {}
+    virtual void item_removed (Item*) {}
+    /** bounding box or position of the item may have changed */
+    virtual void item_changed (Item const *) {}
+    /** the stacking order of the items was changed */
+    virtual void order_changed () {}
+
 protected:
 
     Item const & _item;
@@ -84,6 +95,65 @@ public:
     bool _added;
 };
 
+/** Loose quadtree of the bounding boxes of an item's children, in the
+ * item's coordinates. It is updated incrementally when children are added,
+ * removed or changed, which makes it suitable for items with many children
+ * (e.g. MIDI notes).
+ *
+ * Results are in stacking order, as for DumbLookupTable.
+ */
+class LIBCANVAS_API QuadTreeLookupTable : public LookupTable
+{
+public:
+	QuadTreeLookupTable (Item const &);
+	~QuadTreeLookupTable ();
+
+	std::vector<Item*> get (Rect const &);
+	std::vector<Item*> items_at_point (Duple const &) const;
+	bool has_item_at_point (Duple const & point) const;
+
+	void item_added (Item*);
+	void item_removed (Item*);
+	void item_changed (Item const *);
+	void order_changed ();
+
+	/** containers with at least this many children use a QuadTreeLookupTable */
+	static size_t min_items;
+
+private:
+	struct Node;
+
+	struct Entry {
+		Entry () : item (0), node (0), slot (0), order (0), linked (false), outside (false), dirty (false) {}
+
+		Item*   item;
+		Rect    rect;    ///< bounding box in our item's coordinates
+		Node*   node;    ///< 0 if in _unbounded
+		size_t  slot;    ///< index in node->entries or _unbounded
+		int64_t order;   ///< stacking order
+		bool    linked;  ///< in a node or _unbounded
+		bool    outside; ///< in _unbounded because it is outside of the root node
+		bool    dirty;   ///< in _dirty
+	};
+
+	typedef std::unordered_map<Item const *, Entry> Entries;
+
+	void build () const;
+	void update () const;
+	void insert (Entry&) const;
+	void erase (Entry&) const;
+	void candidates (Rect const &, std::vector<Entry*>&) const;
+	Rect window_to_parent (Rect const &) const;
+
+	mutable Entries _entries;
+	mutable std::vector<Entry*> _dirty;
+	mutable std::vector<Entry*> _unbounded;
+	mutable Node* _root;
+	mutable size_t _n_outside;
+	mutable int64_t _first_order;
+	mutable int64_t _last_order;
+};
+
 }
 
 #endif
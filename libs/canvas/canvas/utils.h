@@ -20,6 +20,8 @@
 #ifndef __CANVAS_UTILS_H__
 #define __CANVAS_UTILS_H__
 
+#include <vector>
+
 #include <cairomm/context.h>
 
 #include "canvas/visibility.h"
@@ -28,6 +30,12 @@
 namespace ArdourCanvas {
 
 	Distance LIBCANVAS_API distance_to_segment_squared (Duple const & p, Duple const & p1, Duple const & p2, double& t, Duple& at);
+
+	/** Merge damaged areas whose union is not much larger than the areas
+	 * themselves, to reduce the number of render passes, while not
+	 * re-rendering large undamaged areas between them.
+	 */
+	void LIBCANVAS_API coalesce_damage (std::vector<Rect>& rects);
 }
 
 #endif // __CANVAS_UTILS_H__
@@ -17,6 +17,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <cmath>
+
+#include "canvas/canvas.h"
 #include "canvas/container.h"
 
 using namespace ArdourCanvas;
@@ -24,12 +27,14 @@ using namespace ArdourCanvas;
 Container::Container (Canvas* canvas)
 	: Item (canvas)
 	, _render_with_alpha (-1)
+	, _render_cached (false)
 {
 }
 
 Container::Container (Item* parent)
 	: Item (parent)
 	, _render_with_alpha (-1)
+	, _render_cached (false)
 {
 }
 
@@ -37,6 +42,7 @@ Container::Container (Item* parent)
 Container::Container (Item* parent, Duple const & p)
 	: Item (parent, p)
 	, _render_with_alpha (-1)
+	, _render_cached (false)
 {
 }
 
@@ -51,7 +57,14 @@ Container::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) con
 {
 	if (_render_with_alpha == 0) {
 		return;
-	} else if (_render_with_alpha > 0) {
+	}
+
+	if (_render_cached) {
+		render_from_cache (area, context);
+		return;
+	}
+
+	if (_render_with_alpha > 0) {
 		context->push_group ();
 	}
 
@@ -86,3 +99,101 @@ Container::set_render_with_alpha (double alpha)
 	_render_with_alpha = alpha;
 	redraw ();
 }
+
+void
+Container::set_render_cached (bool yn)
+{
+	if (_render_cached == yn) {
+		return;
+	}
+	_render_cached = yn;
+	_render_cache.clear ();
+	_render_cache_damage = Rect ();
+	redraw ();
+}
+
+void
+Container::render_cache_damaged (Rect const & area) const
+{
+	if (!_render_cache) {
+		return;
+	}
+
+	Rect const r = window_to_item (area);
+
+	if (_render_cache_damage) {
+		_render_cache_damage = _render_cache_damage.extend (r);
+	} else {
+		_render_cache_damage = r;
+	}
+}
+
+void
+Container::render_from_cache (Rect const & area, Cairo::RefPtr<Cairo::Context> const & context) const
+{
+	Rect const bbox = bounding_box ();
+
+	if (!bbox) {
+		return;
+	}
+
+	/* the visible part of this container, in whole window pixels */
+	Rect visible = item_to_window (bbox, false).intersection (_canvas->visible_area ());
+
+	if (!visible) {
+		return;
+	}
+
+	visible.x0 = floor (visible.x0);
+	visible.y0 = floor (visible.y0);
+	visible.x1 = ceil (visible.x1);
+	visible.y1 = ceil (visible.y1);
+
+	/* The cache is only valid for the area it was rendered for. Parts of
+	 * it that have been scrolled out of view are not kept up to date.
+	 */
+	Rect const cache_area = window_to_item (visible);
+
+	if (!_render_cache || cache_area != _render_cache_area) {
+		_render_cache = Cairo::Surface::create (context->get_target (), Cairo::CONTENT_COLOR_ALPHA, visible.width (), visible.height ());
+		_render_cache_area = cache_area;
+		_render_cache_damage = cache_area;
+	}
+
+	if (_render_cache_damage) {
+		Rect damage = item_to_window (_render_cache_damage.intersection (cache_area), false);
+
+		damage.x0 = floor (damage.x0);
+		damage.y0 = floor (damage.y0);
+		damage.x1 = ceil (damage.x1);
+		damage.y1 = ceil (damage.y1);
+		damage = damage.intersection (visible);
+
+		_render_cache_damage = Rect ();
+
+		if (damage) {
+			Cairo::RefPtr<Cairo::Context> cache_context = Cairo::Context::create (_render_cache);
+			cache_context->translate (-visible.x0, -visible.y0);
+			cache_context->rectangle (damage.x0, damage.y0, damage.width (), damage.height ());
+			cache_context->clip ();
+			cache_context->set_operator (Cairo::OPERATOR_CLEAR);
+			cache_context->paint ();
+			cache_context->set_operator (Cairo::OPERATOR_OVER);
+
+			Item::render_children (damage, cache_context);
+		}
+	}
+
+	context->save ();
+	context->rectangle (area.x0, area.y0, area.width (), area.height ());
+	context->clip ();
+	context->set_source (_render_cache, visible.x0, visible.y0);
+
+	if (_render_with_alpha > 0 && _render_with_alpha < 1.0) {
+		context->paint_with_alpha (_render_with_alpha);
+	} else {
+		context->paint ();
+	}
+
+	context->restore ();
+}
@@ -295,6 +295,10 @@ Item::set_position (Duple p)
 
 	_position = p;
 
+	if (_parent && _parent->_lut) {
+		_parent->_lut->item_changed (this);
+	}
+
 	/* only update canvas and parent if visible. Otherwise, this
 	   will be done when ::show() is called.
 	*/
@@ -619,6 +623,9 @@ Item::_size_allocate (Rect const & r)
 	if (_layout_sensitive) {
 		/* this definitely affects the item */
 		_position = Duple (r.x0, r.y0);
+		if (_parent && _parent->_lut) {
+			_parent->_lut->item_changed (this);
+		}
 		/* this may have no effect on the item */
 		_allocation = r;
 	}
@@ -747,11 +754,21 @@ void
 Item::redraw () const
 {
 	if (visible() && _bounding_box && _canvas) {
-		_canvas->request_redraw (item_to_window (_bounding_box, false));
+		Rect const r = item_to_window (_bounding_box, false);
+		damage_render_caches (r);
+		_canvas->request_redraw (r);
 	}
 
 }
 
+void
+Item::damage_render_caches (Rect const & area) const
+{
+	for (Item const * i = this; i; i = i->parent ()) {
+		i->render_cache_damaged (area);
+	}
+}
+
 void
 Item::begin_change ()
 {
@@ -767,6 +784,10 @@ Item::end_change ()
 		return;
 	}
 
+	if (_parent && _parent->_lut) {
+		_parent->_lut->item_changed (this);
+	}
+
 	if (visible()) {
 		_canvas->item_changed (this, _pre_change_bounding_box);
 
@@ -1065,7 +1086,7 @@ Item::add (Item* i)
 
 	_items.push_back (i);
 	i->reparent (this, true);
-	invalidate_lut ();
+	child_added (i);
 	set_bbox_dirty ();
 }
 
@@ -1076,7 +1097,7 @@ Item::add_front (Item* i)
 
 	_items.push_front (i);
 	i->reparent (this, true);
-	invalidate_lut ();
+	child_added (i);
 	set_bbox_dirty();
 }
 
@@ -1103,7 +1124,9 @@ Item::remove (Item* i)
 	i->unparent ();
 	i->set_layout_sensitive (false);
 	_items.remove (i);
-	invalidate_lut ();
+	if (_lut) {
+		_lut->item_removed (i);
+	}
 	set_bbox_dirty ();
 
 	end_change ();
@@ -1124,6 +1147,8 @@ Item::clear (bool with_delete)
 void
 Item::clear_items (bool with_delete)
 {
+	invalidate_lut ();
+
 	for (list<Item*>::iterator i = _items.begin(); i != _items.end(); ) {
 
 		list<Item*>::iterator tmp = i;
@@ -1159,7 +1184,9 @@ Item::raise_child_to_top (Item* i)
 	_items.remove (i);
 	_items.push_back (i);
 
-	invalidate_lut ();
+	if (_lut) {
+		_lut->order_changed ();
+	}
         redraw ();
 }
 
@@ -1178,7 +1205,9 @@ Item::raise_child (Item* i, int levels)
 	}
 
 	_items.insert (j, i);
-	invalidate_lut ();
+	if (_lut) {
+		_lut->order_changed ();
+	}
         redraw ();
 }
 
@@ -1192,7 +1221,9 @@ Item::lower_child_to_bottom (Item* i)
 	}
 	_items.remove (i);
 	_items.push_front (i);
-	invalidate_lut ();
+	if (_lut) {
+		_lut->order_changed ();
+	}
         redraw ();
 }
 
@@ -1200,7 +1231,26 @@ void
 Item::ensure_lut () const
 {
 	if (!_lut) {
-		_lut = new DumbLookupTable (*this);
+		if (_items.size () >= QuadTreeLookupTable::min_items) {
+			_lut = new QuadTreeLookupTable (*this);
+		} else {
+			_lut = new DumbLookupTable (*this);
+		}
+	}
+}
+
+void
+Item::child_added (Item* i)
+{
+	if (!_lut) {
+		return;
+	}
+
+	if (_items.size () == QuadTreeLookupTable::min_items) {
+		/* switch to a spatial index */
+		invalidate_lut ();
+	} else {
+		_lut->item_added (i);
 	}
 }
 
@@ -1214,8 +1264,6 @@ Item::invalidate_lut () const
 void
 Item::child_changed (bool bbox_changed)
 {
-	invalidate_lut ();
-
 	if (bbox_changed) {
 		set_bbox_dirty ();
 	}
@@ -1353,6 +1401,11 @@ void
 Item::set_bbox_dirty () const
 {
 	_bounding_box_dirty = true;
+
+	if (_parent && _parent->_lut) {
+		_parent->_lut->item_changed (this);
+	}
+
 	Item* i = _parent;
 	while (i) {
 		i->set_bbox_dirty ();
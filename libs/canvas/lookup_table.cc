@@ -18,6 +18,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <cassert>
+
 #include "canvas/item.h"
 #include "canvas/lookup_table.h"
 
@@ -321,3 +324,425 @@ OptimizingLookupTable::get (Rect const & area)
 	return vitems;
 }
 
+
+/*-------------------------------------------------*/
+
+size_t QuadTreeLookupTable::min_items = 64;
+
+static const size_t   node_capacity = 16;
+static const int      max_depth     = 16;
+/* items may cover points slightly outside of their bounding box, e.g. lines */
+static const Distance covers_margin = 8.0;
+/* items beyond this are never put into the tree */
+static const Coord    max_coord     = 1e9;
+
+static inline bool
+overlaps (Rect const & a, Rect const & b)
+{
+	return a.x0 <= b.x1 && b.x0 <= a.x1 && a.y0 <= b.y1 && b.y0 <= a.y1;
+}
+
+static inline bool
+encloses (Rect const & a, Rect const & b)
+{
+	return a.x0 <= b.x0 && b.x1 <= a.x1 && a.y0 <= b.y0 && b.y1 <= a.y1;
+}
+
+static Rect
+rect_in_parent (Item const * item)
+{
+	Rect const bbox = item->bounding_box ();
+	if (!bbox) {
+		return Rect ();
+	}
+	return item->item_to_parent (bbox);
+}
+
+/** A node of the tree. Its entries are contained in its loose bounds, which
+ * are the nominal bounds extended by half their size in each direction. So
+ * an entry can always be stored in a child, if it is no larger than the child
+ * and its center is within the child's nominal bounds.
+ */
+struct QuadTreeLookupTable::Node
+{
+	Node (Rect const & b, int d)
+		: bounds (b)
+		, loose (b.x0 - b.width () / 2, b.y0 - b.height () / 2, b.x1 + b.width () / 2, b.y1 + b.height () / 2)
+		, depth (d)
+	{
+		child[0] = child[1] = child[2] = child[3] = 0;
+	}
+
+	~Node ()
+	{
+		for (int i = 0; i < 4; ++i) {
+			delete child[i];
+		}
+	}
+
+	bool leaf () const { return child[0] == 0; }
+
+	/** @return index of the child that \p r can be stored in, or -1 */
+	int child_for (Rect const & r) const
+	{
+		Distance const w = bounds.width () / 2;
+		Distance const h = bounds.height () / 2;
+
+		if (r.width () > w || r.height () > h) {
+			return -1;
+		}
+
+		int const ix = (r.x0 + r.x1) / 2 < bounds.x0 + w ? 0 : 1;
+		int const iy = (r.y0 + r.y1) / 2 < bounds.y0 + h ? 0 : 1;
+		return iy * 2 + ix;
+	}
+
+	void split ()
+	{
+		Distance const w = bounds.width () / 2;
+		Distance const h = bounds.height () / 2;
+
+		for (int i = 0; i < 4; ++i) {
+			Coord const x = bounds.x0 + (i & 1) * w;
+			Coord const y = bounds.y0 + (i >> 1) * h;
+			child[i] = new Node (Rect (x, y, x + w, y + h), depth + 1);
+		}
+
+		std::vector<Entry*> keep;
+
+		for (auto const & e : entries) {
+			int const c = child_for (e->rect);
+			Node* n = c < 0 ? this : child[c];
+			std::vector<Entry*>& v = c < 0 ? keep : n->entries;
+			e->node = n;
+			e->slot = v.size ();
+			v.push_back (e);
+		}
+
+		entries.swap (keep);
+	}
+
+	Rect bounds;
+	Rect loose;
+	int  depth;
+
+	std::vector<Entry*> entries;
+	Node* child[4];
+};
+
+QuadTreeLookupTable::QuadTreeLookupTable (Item const & item)
+	: LookupTable (item)
+	, _root (0)
+	, _n_outside (0)
+	, _first_order (0)
+	, _last_order (-1)
+{
+	for (auto const & i : _item.items ()) {
+		Entry& e = _entries[i];
+		e.item  = i;
+		e.order = ++_last_order;
+	}
+
+	build ();
+}
+
+QuadTreeLookupTable::~QuadTreeLookupTable ()
+{
+	delete _root;
+}
+
+/** (Re)build the tree, with the root covering all current entries */
+void
+QuadTreeLookupTable::build () const
+{
+	delete _root;
+	_root = 0;
+	_unbounded.clear ();
+	_dirty.clear ();
+	_n_outside = 0;
+
+	Rect bounds;
+	bool have_one = false;
+
+	for (auto & i : _entries) {
+		Entry& e = i.second;
+		e.rect   = rect_in_parent (e.item);
+		e.linked = false;
+		e.dirty  = false;
+
+		if (!e.rect || !encloses (Rect (-max_coord, -max_coord, max_coord, max_coord), e.rect)) {
+			continue;
+		}
+
+		bounds   = have_one ? bounds.extend (e.rect) : e.rect;
+		have_one = true;
+	}
+
+	if (have_one) {
+		/* leave some room to grow */
+		_root = new Node (bounds.expand (std::max (bounds.width (), bounds.height ()) / 8 + 1), 0);
+	}
+
+	for (auto & i : _entries) {
+		insert (i.second);
+	}
+}
+
+void
+QuadTreeLookupTable::insert (Entry& e) const
+{
+	assert (!e.linked);
+
+	Rect const & r = e.rect;
+
+	e.linked  = true;
+	e.outside = false;
+
+	if (!r || !_root || !encloses (_root->bounds, r)) {
+		/* no bounding box, or outside of the tree */
+		if (r && _root && encloses (Rect (-max_coord, -max_coord, max_coord, max_coord), r)) {
+			e.outside = true;
+			++_n_outside;
+		}
+		e.node = 0;
+		e.slot = _unbounded.size ();
+		_unbounded.push_back (&e);
+		return;
+	}
+
+	Node* n = _root;
+
+	while (true) {
+		if (n->leaf ()) {
+			if (n->entries.size () < node_capacity || n->depth >= max_depth) {
+				break;
+			}
+			n->split ();
+		}
+		int const c = n->child_for (r);
+		if (c < 0) {
+			break;
+		}
+		n = n->child[c];
+	}
+
+	e.node = n;
+	e.slot = n->entries.size ();
+	n->entries.push_back (&e);
+}
+
+void
+QuadTreeLookupTable::erase (Entry& e) const
+{
+	assert (e.linked);
+
+	std::vector<Entry*>& v = e.node ? e.node->entries : _unbounded;
+
+	assert (v[e.slot] == &e);
+
+	Entry* last = v.back ();
+	v[e.slot]   = last;
+	last->slot  = e.slot;
+	v.pop_back ();
+
+	if (e.outside) {
+		--_n_outside;
+	}
+
+	e.linked = false;
+	e.node   = 0;
+}
+
+/** Re-insert entries whose bounding box may have changed */
+void
+QuadTreeLookupTable::update () const
+{
+	if (_dirty.empty ()) {
+		return;
+	}
+
+	for (auto const & e : _dirty) {
+		if (e->linked) {
+			erase (*e);
+		}
+		e->rect  = rect_in_parent (e->item);
+		e->dirty = false;
+		insert (*e);
+	}
+
+	_dirty.clear ();
+
+	if (_n_outside > node_capacity && _n_outside > _entries.size () / 8) {
+		/* items have moved away from the tree */
+		build ();
+	}
+}
+
+void
+QuadTreeLookupTable::candidates (Rect const & area, std::vector<Entry*>& rv) const
+{
+	update ();
+
+	rv.insert (rv.end (), _unbounded.begin (), _unbounded.end ());
+
+	if (_root) {
+		std::vector<Node const *> stack;
+		stack.push_back (_root);
+
+		while (!stack.empty ()) {
+			Node const * n = stack.back ();
+			stack.pop_back ();
+
+			for (auto const & e : n->entries) {
+				if (overlaps (e->rect, area)) {
+					rv.push_back (e);
+				}
+			}
+
+			if (!n->leaf ()) {
+				for (int i = 0; i < 4; ++i) {
+					if (overlaps (n->child[i]->loose, area)) {
+						stack.push_back (n->child[i]);
+					}
+				}
+			}
+		}
+	}
+
+	std::sort (rv.begin (), rv.end (), [] (Entry const * a, Entry const * b) { return a->order < b->order; });
+}
+
+/** Convert a rect in window coordinates into our item's coordinates,
+ * which the children's bounding boxes are stored in. All children share the
+ * same scroll offset.
+ */
+Rect
+QuadTreeLookupTable::window_to_parent (Rect const & r) const
+{
+	if (_item.items ().empty ()) {
+		return Rect ();
+	}
+	Item const * child = _item.items ().front ();
+	return child->item_to_parent (child->window_to_item (r));
+}
+
+vector<Item*>
+QuadTreeLookupTable::get (Rect const & area)
+{
+	/* area is in window coordinates, allow for rounding, see Item::item_to_window */
+	std::vector<Entry*> c;
+	candidates (window_to_parent (area).expand (1.0), c);
+
+	vector<Item*> vitems;
+
+	for (auto const & e : c) {
+		Rect const item_bbox = e->item->bounding_box ();
+		if (!item_bbox) {
+			continue;
+		}
+		if (e->item->item_to_window (item_bbox).intersection (area)) {
+			vitems.push_back (e->item);
+		}
+	}
+
+	return vitems;
+}
+
+vector<Item*>
+QuadTreeLookupTable::items_at_point (Duple const & point) const
+{
+	/* Point is in window coordinate system */
+
+	std::vector<Entry*> c;
+	candidates (window_to_parent (Rect (point.x, point.y, point.x, point.y)).expand (covers_margin), c);
+
+	vector<Item*> vitems;
+
+	for (auto const & e : c) {
+		if (e->item->covers (point)) {
+			vitems.push_back (e->item);
+		}
+	}
+
+	return vitems;
+}
+
+bool
+QuadTreeLookupTable::has_item_at_point (Duple const & point) const
+{
+	/* Point is in window coordinate system */
+
+	std::vector<Entry*> c;
+	candidates (window_to_parent (Rect (point.x, point.y, point.x, point.y)).expand (covers_margin), c);
+
+	for (auto const & e : c) {
+		if (e->item->visible () && e->item->covers (point)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void
+QuadTreeLookupTable::item_added (Item* item)
+{
+	Entry& e = _entries[item];
+
+	e.item  = item;
+	e.order = (_item.items ().front () == item) ? --_first_order : ++_last_order;
+
+	if (!e.dirty) {
+		e.dirty = true;
+		_dirty.push_back (&e);
+	}
+}
+
+void
+QuadTreeLookupTable::item_removed (Item* item)
+{
+	Entries::iterator i = _entries.find (item);
+
+	if (i == _entries.end ()) {
+		return;
+	}
+
+	Entry& e = i->second;
+
+	if (e.linked) {
+		erase (e);
+	}
+
+	if (e.dirty) {
+		_dirty.erase (std::find (_dirty.begin (), _dirty.end (), &e));
+	}
+
+	_entries.erase (i);
+}
+
+void
+QuadTreeLookupTable::item_changed (Item const * item)
+{
+	Entries::iterator i = _entries.find (item);
+
+	if (i == _entries.end () || i->second.dirty) {
+		return;
+	}
+
+	i->second.dirty = true;
+	_dirty.push_back (&i->second);
+}
+
+void
+QuadTreeLookupTable::order_changed ()
+{
+	_first_order = 0;
+	_last_order  = -1;
+
+	for (auto const & i : _item.items ()) {
+		Entries::iterator e = _entries.find (i);
+		if (e != _entries.end ()) {
+			e->second.order = ++_last_order;
+		}
+	}
+}
@@ -93,3 +93,32 @@ ArdourCanvas::distance_to_segment_squared (Duple const & p, Duple const & p1, Du
 
 	return ((dpqx * dpqx) + (dpqy * dpqy));
 }
+
+void
+ArdourCanvas::coalesce_damage (std::vector<Rect>& rects)
+{
+	/* every render pass traverses the item tree, which is worth about
+	 * this many pixels of rendering.
+	 */
+	static const Distance pass_cost = 64 * 64;
+
+	bool merged = true;
+
+	while (merged && rects.size () > 1) {
+		merged = false;
+
+		for (size_t i = 0; i < rects.size () && !merged; ++i) {
+			for (size_t j = i + 1; j < rects.size (); ++j) {
+				Rect const u = rects[i].extend (rects[j]);
+				Distance const a = rects[i].width () * rects[i].height () + rects[j].width () * rects[j].height ();
+
+				if (u.width () * u.height () <= a + pass_cost) {
+					rects[i] = u;
+					rects.erase (rects.begin () + j);
+					merged = true;
+					break;
+				}
+			}
+		}
+	}
+}
@@ -35,6 +35,7 @@
 
 #define GUARD_POINT_DELTA(foo) ((foo).time_domain () == Temporal::AudioTime ? Temporal::timecnt_t (64) : Temporal::timecnt_t (Beats (0, 1)))
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -64,6 +65,38 @@ event_time_less_than (ControlEvent* a, ControlEvent* b)
 	return a->when < b->when;
 }
 
+inline bool
+event_equal (ControlEvent* a, ControlEvent* b)
+{
+	return a->when == b->when && a->value == b->value;
+}
+
+/** Find the first event at or after \a when, starting at \a hint.
+ *
+ * This is equivalent to lower_bound (hint, last, when), but first probes
+ * exponentially increasing distances from \a hint. Sequential reads
+ * usually only advance by one or two events, and this avoids a binary
+ * search over the remainder of the list.
+ */
+template <typename Iter>
+static Iter
+seek_forward (Iter hint, Iter last, timepos_t const& when)
+{
+	typename std::iterator_traits<Iter>::difference_type step = 1;
+	Iter lo = hint;
+
+	while (lo != last && (*lo)->when < when) {
+		Iter hi = (last - lo > step) ? lo + step : last;
+		if (hi == last || !((*hi)->when < when)) {
+			const ControlEvent cp (when, 0);
+			return lower_bound (lo + 1, hi, &cp, ControlList::time_comparator);
+		}
+		lo = hi;
+		step <<= 1;
+	}
+	return lo;
+}
+
 ControlList::ControlList (const Parameter& id, const ParameterDescriptor& desc, TimeDomainProvider const & tds)
 	: TimeDomainProvider (tds)
 	, _parameter (id)
@@ -199,6 +232,7 @@ ControlList::copy_events (const ControlList& other)
 		}
 		_events.clear ();
 		PBD::RWLock::ReaderLock olm (other._lock);
+		_events.reserve (other._events.size ());
 		for (const_iterator i = other.begin (); i != other.end (); ++i) {
 			_events.push_back (new ControlEvent ((*i)->when, (*i)->value));
 		}
@@ -328,6 +362,7 @@ ControlList::list_merge (ControlList const& other, std::function<double (double,
 		 * for new events only present in the master list.
 		 */
 		EventList nel;
+		nel.reserve (_events.size () + other._events.size ());
 		for (iterator i = _events.begin (); i != _events.end (); ++i) {
 			float val = callback ((*i)->value, other.eval ((*i)->when));
 			nel.push_back (new ControlEvent ((*i)->when, val));
@@ -335,22 +370,15 @@ ControlList::list_merge (ControlList const& other, std::function<double (double,
 		/* Now add events which are only present in the master-list. */
 		const EventList& evl (other.events ());
 		for (const_iterator i = evl.begin (); i != evl.end (); ++i) {
-			bool found = false;
-			// TODO: optimize, remember last matching iterator (lists are sorted)
-			for (iterator j = _events.begin (); j != _events.end (); ++j) {
-				if ((*i)->when == (*j)->when) {
-					found = true;
-					break;
-				}
-			}
+			iterator j = lower_bound (_events.begin (), _events.end (), *i, time_comparator);
 			/* skip events that have already been merge in the first pass */
-			if (found) {
+			if (j != _events.end () && (*j)->when == (*i)->when) {
 				continue;
 			}
 			float val = callback (unlocked_eval ((*i)->when), (*i)->value);
 			nel.push_back (new ControlEvent ((*i)->when, val));
 		}
-		nel.sort (event_time_less_than);
+		std::stable_sort (nel.begin (), nel.end (), event_time_less_than);
 
 		for (EventList::iterator x = _events.begin (); x != _events.end (); ++x) {
 			delete (*x);
@@ -404,11 +432,11 @@ ControlList::thin (double thinning_factor)
 	{
 		PBD::RWLock::WriterLock lm (_lock);
 
-		ControlEvent* prevprev = 0;
-		ControlEvent* cur      = 0;
-		ControlEvent* prev     = 0;
-		iterator      pprev;
-		int           counter = 0;
+		ControlEvent*        prevprev = 0;
+		ControlEvent*        cur      = 0;
+		ControlEvent*        prev     = 0;
+		EventList::size_type n_kept   = 0;
+		int                  counter  = 0;
 
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 thin from %2 events\n", this, _events.size ()));
 
@@ -432,26 +460,27 @@ ControlList::thin (double thinning_factor)
 				                    (cw * (ppv - pv)));
 
 				if (area < thinning_factor) {
-					iterator tmp = pprev;
-
-					/* pprev will change to current
+					/* drop prev, cur takes its place
 					 * i is incremented to the next event
 					 * as we loop.
 					 */
 
-					pprev = i;
-					prev  = cur;
-					_events.erase (tmp);
+					_events[n_kept - 1] = cur;
+					prev    = cur;
 					changed = true;
 					continue;
 				}
 			}
 
+			/* compact in place, n_kept <= index of i */
+			_events[n_kept++] = cur;
+
 			prevprev = prev;
 			prev     = cur;
-			pprev    = i;
 		}
 
+		_events.resize (n_kept);
+
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 thin => %2 events\n", this, _events.size ()));
 
 		if (changed) {
@@ -498,16 +527,7 @@ ControlList::unlocked_remove_duplicates ()
 	if (_events.size () < 2) {
 		return;
 	}
-	iterator i    = _events.begin ();
-	iterator prev = i++;
-	while (i != _events.end ()) {
-		if ((*prev)->when == (*i)->when && (*prev)->value == (*i)->value) {
-			i = _events.erase (i);
-		} else {
-			++prev;
-			++i;
-		}
-	}
+	_events.erase (std::unique (_events.begin (), _events.end (), event_equal), _events.end ());
 }
 
 void
@@ -622,6 +642,11 @@ ControlList::add_guard_point (timepos_t const& time, timecnt_t const& offset)
 
 	when += offset;
 
+	/* the caller may have added events, the lookup cache is no
+	 * longer valid.
+	 */
+	mark_dirty ();
+
 	ControlEvent cp (when, 0.0);
 	most_recent_insert_iterator = lower_bound (_events.begin (), _events.end (), &cp, time_comparator);
 
@@ -631,6 +656,7 @@ ControlList::add_guard_point (timepos_t const& time, timecnt_t const& offset)
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 insert iterator at end, adding eval-value there %2\n", this, eval_value));
 		_events.push_back (new ControlEvent (when, eval_value));
 		/* leave insert iterator at the end */
+		most_recent_insert_iterator = _events.end ();
 
 	} else if ((*most_recent_insert_iterator)->when == when) {
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 insert iterator at existing point, setting eval-value there %2\n", this, eval_value));
@@ -697,6 +723,7 @@ ControlList::editor_add (timepos_t const& time, double value, bool with_guard)
 				_events.insert (_events.end (), new ControlEvent (timepos_t (time_domain()), value));
 				DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added value %2 at zero\n", this, value));
 			}
+			i = _events.end ();
 		}
 
 		insert_position = when;
@@ -706,14 +733,10 @@ ControlList::editor_add (timepos_t const& time, double value, bool with_guard)
 			i = lower_bound (_events.begin (), _events.end (), &cp, time_comparator);
 		}
 
-		iterator result;
 		DEBUG_TRACE (DEBUG::ControlList, string_compose ("editor_add: actually add when= %1 value= %2\n", when, value));
-		result = _events.insert (i, new ControlEvent (when, value));
-
-		if (i == result) {
-			return false;
-		}
+		_events.insert (i, new ControlEvent (when, value));
 
+		unlocked_invalidate_insert_iterator ();
 		mark_dirty ();
 	}
 	maybe_signal_changed ();
@@ -781,6 +804,7 @@ ControlList::editor_add_ordered (OrderedPoints const & points, bool with_guard)
 		if (_events.empty () && when > timecnt_t (time_domain())) {
 			_events.insert (_events.end (), new ControlEvent (timepos_t (time_domain()), value));
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added value %2 at zero\n", this, value));
+			i = _events.end ();
 		}
 
 		for (auto const & p : points) {
@@ -794,9 +818,11 @@ ControlList::editor_add_ordered (OrderedPoints const & points, bool with_guard)
 			insert_position = when;
 
 			DEBUG_TRACE (DEBUG::ControlList, string_compose ("editor_add: actually add when= %1 value= %2\n", when, value));
-			_events.insert (i, new ControlEvent (when, value));
+			i = _events.insert (i, new ControlEvent (when, value));
+			++i;
 		}
 
+		unlocked_invalidate_insert_iterator ();
 		mark_dirty ();
 	}
 
@@ -864,18 +890,13 @@ ControlList::erase_from_iterator_to (iterator iter, timepos_t const& time)
 	timepos_t when = ensure_time_domain (time);
 
 	// caller needs to hold writer-lock
-	while (iter != _events.end ()) {
-		if ((*iter)->when < when) {
-			DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 erase existing @ %2\n", this, (*iter)->when));
-			delete *iter;
-			iter = _events.erase (iter);
-			continue;
-		} else if ((*iter)->when >= when) {
-			break;
-		}
-		++iter;
+	iterator e = iter;
+	while (e != _events.end () && (*e)->when < when) {
+		DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 erase existing @ %2\n", this, (*e)->when));
+		delete *e;
+		++e;
 	}
-	return iter;
+	return _events.erase (iter, e);
 }
 
 /* this is for making changes from some kind of user interface or
@@ -912,6 +933,8 @@ ControlList::add (timepos_t const& time, double value, bool with_guards, bool wi
 					_events.insert (_events.end (), new ControlEvent (timepos_t (time_domain()), value));
 					DEBUG_TRACE (DEBUG::ControlList, string_compose ("@%1 added default value %2 at zero\n", this, _desc.normal));
 				}
+				/* the list was empty, so the insert iterator was at the end */
+				unlocked_invalidate_insert_iterator ();
 			}
 		}
 
@@ -1039,15 +1062,33 @@ ControlList::erase (iterator i)
 {
 	{
 		PBD::RWLock::WriterLock lm (_lock);
-		if (most_recent_insert_iterator == i) {
-			unlocked_invalidate_insert_iterator ();
-		}
-		_events.erase (i);
+		unlocked_erase (i);
 		mark_dirty ();
 	}
 	maybe_signal_changed ();
 }
 
+/** Remove a single event, keeping the insert iterator pointing to
+ * the same event, unless that is the one being removed.
+ * Caller must hold writer-lock.
+ */
+void
+ControlList::unlocked_erase (iterator i)
+{
+	if (most_recent_insert_iterator == _events.end () || most_recent_insert_iterator == i) {
+		_events.erase (i);
+		unlocked_invalidate_insert_iterator ();
+		return;
+	}
+
+	EventList::difference_type mri = most_recent_insert_iterator - _events.begin ();
+	if (i < most_recent_insert_iterator) {
+		--mri;
+	}
+	_events.erase (i);
+	most_recent_insert_iterator = _events.begin () + mri;
+}
+
 void
 ControlList::erase (iterator start, iterator end)
 {
@@ -1075,10 +1116,7 @@ ControlList::erase (timepos_t const& time, double value)
 		}
 
 		if (i != end ()) {
-			_events.erase (i);
-			if (most_recent_insert_iterator == i) {
-				unlocked_invalidate_insert_iterator ();
-			}
+			unlocked_erase (i);
 		}
 
 		mark_dirty ();
@@ -1086,6 +1124,30 @@ ControlList::erase (timepos_t const& time, double value)
 	maybe_signal_changed ();
 }
 
+void
+ControlList::erase (EventList const& events)
+{
+	if (events.empty ()) {
+		return;
+	}
+
+	EventList sorted (events);
+	std::sort (sorted.begin (), sorted.end ());
+
+	{
+		PBD::RWLock::WriterLock lm (_lock);
+		iterator e = std::remove_if (_events.begin (), _events.end (),
+		                             [&sorted] (ControlEvent* ev) { return std::binary_search (sorted.begin (), sorted.end (), ev); });
+		if (e == _events.end ()) {
+			return;
+		}
+		_events.erase (e, _events.end ());
+		unlocked_invalidate_insert_iterator ();
+		mark_dirty ();
+	}
+	maybe_signal_changed ();
+}
+
 void
 ControlList::erase_range (timepos_t const& start, timepos_t const& endt)
 {
@@ -1133,9 +1195,9 @@ ControlList::erase_range_internal (timepos_t const& start, timepos_t const& endt
 	iterator e;
 	if ((s = lower_bound (events.begin (), events.end (), &cp, time_comparator)) != events.end ()) {
 		cp.when = endt;
-		e       = upper_bound (events.begin (), events.end (), &cp, time_comparator);
-		events.erase (s, e);
+		e       = upper_bound (s, events.end (), &cp, time_comparator);
 		if (s != e) {
+			events.erase (s, e);
 			unlocked_invalidate_insert_iterator ();
 			erased = true;
 		}
@@ -1220,6 +1282,7 @@ ControlList::shift (timepos_t const& time, timecnt_t const& distance)
 			_events.insert (s, new ControlEvent (pos, s == _events.end () ? v0 : v1));
 		}
 
+		unlocked_invalidate_insert_iterator ();
 		mark_dirty ();
 	}
 	maybe_signal_changed ();
@@ -1265,7 +1328,7 @@ ControlList::modify (iterator iter, timepos_t const& time, double val)
 		}
 
 		if (!_frozen) {
-			_events.sort (event_time_less_than);
+			std::stable_sort (_events.begin (), _events.end (), event_time_less_than);
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
 		} else {
@@ -1330,7 +1393,7 @@ ControlList::thaw ()
 		PBD::RWLock::WriterLock lm (_lock);
 
 		if (_sort_pending) {
-			_events.sort (event_time_less_than);
+			std::stable_sort (_events.begin (), _events.end (), event_time_less_than);
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
 			_sort_pending = false;
@@ -1492,7 +1555,7 @@ ControlList::truncate_start (timecnt_t const& overall)
 
 			if (np < 2) {
 				/* less than 2 points: add a new point */
-				_events.push_front (new ControlEvent (timepos_t (time_domain()), _events.front ()->value));
+				_events.insert (_events.begin (), new ControlEvent (timepos_t (time_domain()), _events.front ()->value));
 
 			} else {
 				/* more than 2 points: check to see if the first 2 values
@@ -1508,7 +1571,7 @@ ControlList::truncate_start (timecnt_t const& overall)
 					_events.front ()->when = timepos_t (time_domain());
 				} else {
 					/* leave non-flat segment in place, add a new leading point. */
-					_events.push_front (new ControlEvent (timepos_t (time_domain()), _events.front ()->value));
+					_events.insert (_events.begin (), new ControlEvent (timepos_t (time_domain()), _events.front ()->value));
 				}
 			}
 
@@ -1522,22 +1585,8 @@ ControlList::truncate_start (timecnt_t const& overall)
 
 			/* remove all events earlier than the new "front" */
 
-			i = _events.begin ();
-
-			while (i != _events.end () && !_events.empty ()) {
-				ControlList::iterator tmp;
-
-				tmp = i;
-				++tmp;
-
-				if ((*i)->when > first_legal_coordinate) {
-					break;
-				}
-
-				_events.erase (i);
-
-				i = tmp;
-			}
+			ControlEvent cp (first_legal_coordinate, 0);
+			_events.erase (_events.begin (), upper_bound (_events.begin (), _events.end (), &cp, time_comparator));
 
 			/* shift all remaining points left to keep their same
 			   relative position
@@ -1549,7 +1598,7 @@ ControlList::truncate_start (timecnt_t const& overall)
 
 			/* add a new point for the interpolated new value */
 
-			_events.push_front (new ControlEvent (timepos_t (time_domain()), first_legal_value));
+			_events.insert (_events.begin (), new ControlEvent (timepos_t (time_domain()), first_legal_value));
 		}
 
 		unlocked_invalidate_insert_iterator ();
@@ -1568,12 +1617,7 @@ ControlList::unlocked_eval (timepos_t const& xtime) const
 	double    xx;
 	double    ll;
 
-	const_iterator length_check_iter = _events.begin ();
-	for (npoints = 0; npoints < 4; ++npoints, ++length_check_iter) {
-		if (length_check_iter == _events.end ()) {
-			break;
-		}
-	}
+	npoints = std::min<EventList::size_type> (_events.size (), 3);
 
 	switch (npoints) {
 		case 0:
@@ -1652,12 +1696,20 @@ ControlList::multipoint_eval (timepos_t const& xtime) const
 	/* Only do the range lookup if xtime is in a different range than last time
 	 * this was called (or if the lookup cache has been marked "dirty" (left<0) */
 	if ((_lookup_cache.left == timepos_t::max (time_domain())) ||
-	    ((_lookup_cache.left > xtime) ||
-	     (_lookup_cache.range.first == _events.end ()) ||
-	     ((*_lookup_cache.range.second)->when < xtime))) {
+	    (_lookup_cache.left > xtime) ||
+	    (_lookup_cache.range.first == _events.end ())) {
 		const ControlEvent cp (xtime, 0);
 
 		_lookup_cache.range = equal_range (_events.begin (), _events.end (), &cp, time_comparator);
+
+	} else if (_lookup_cache.range.second != _events.end () && (*_lookup_cache.range.second)->when < xtime) {
+		/* moving forward (playback), continue from the cached position */
+		const_iterator i = seek_forward (_lookup_cache.range.second, _events.end (), xtime);
+		const_iterator e = i;
+		while (e != _events.end () && (*e)->when == xtime) {
+			++e;
+		}
+		_lookup_cache.range = std::make_pair (i, e);
 	}
 
 	pair<const_iterator, const_iterator> range = _lookup_cache.range;
@@ -1732,10 +1784,8 @@ ControlList::build_search_cache_if_necessary (timepos_t const& start_time) const
 	/* We now have a search cache that is not too far right, but it may be too
 	   far left and need to be advanced. */
 
-	while (_search_cache.first != end () && (*_search_cache.first)->when < start) {
-		++_search_cache.first;
-	}
-	_search_cache.left = start;
+	_search_cache.first = seek_forward (_search_cache.first, _events.end (), start);
+	_search_cache.left  = start;
 }
 
 /** Get the earliest event after \a start without interpolation.
@@ -1819,8 +1869,8 @@ ControlList::rt_safe_earliest_event_linear_unlocked (Temporal::timepos_t const&
 		/* if there is an event between [start ... start + min_x_delta], use it,
 		 */
 		build_search_cache_if_necessary (start);
-		const ControlEvent* first = *_search_cache.first;
 		if (_search_cache.first != _events.end ()) {
+			const ControlEvent* first = *_search_cache.first;
 			if (((first->when > start) || (inclusive && first->when == start)) && ((first->when < start + min_x_delta) || (!inclusive && first->when == start + min_x_delta))) {
 				x = first->when;
 				y = first->value;
@@ -2007,7 +2057,10 @@ ControlList::cut_copy_clear (timepos_t const& start_time, timepos_t const& end_t
 
 			if (op != 1) { // cut/clear
 				if (start > _events.front ()->when) {
-					_events.insert (s, (new ControlEvent (start, val)));
+					/* insertion invalidates iterators, re-locate the range */
+					s = _events.insert (s, (new ControlEvent (start, val)));
+					++s;
+					e = upper_bound (s, _events.end (), &cp, time_comparator);
 				}
 			}
 
@@ -2016,18 +2069,15 @@ ControlList::cut_copy_clear (timepos_t const& start_time, timepos_t const& end_t
 			}
 		}
 
-		for (iterator x = s; x != e;) {
+		if (op != 2) {
 			/* adjust new points to be relative to start, which has been set to zero.  */
-
-			if (op != 2) {
+			for (iterator x = s; x != e; ++x) {
 				nal->_events.push_back (new ControlEvent (timepos_t (start.distance ((*x)->when)), (*x)->value));
 			}
+		}
 
-			if (op != 1) {
-				x = _events.erase (x);
-			} else {
-				++x;
-			}
+		if (op != 1) {
+			e = _events.erase (s, e);
 		}
 
 		if (e == _events.end () || (*e)->when != end) {
@@ -2128,7 +2178,8 @@ ControlList::paste (const ControlList& alist, timepos_t const& time)
 				}
 			}
 
-			_events.insert (where, new ControlEvent (adj_pos, value));
+			where = _events.insert (where, new ControlEvent (adj_pos, value));
+			++where;
 			end = (*i)->when + pos;
 		}
 
@@ -2136,18 +2187,11 @@ ControlList::paste (const ControlList& alist, timepos_t const& time)
 		 * the correct amount.
 		 */
 
-		while (where != _events.end ()) {
-			iterator tmp;
-			if ((*where)->when <= end) {
-				tmp = where;
-				++tmp;
-				_events.erase (where);
-				where = tmp;
-
-			} else {
-				break;
-			}
+		iterator last_moved = where;
+		while (last_moved != _events.end () && (*last_moved)->when <= end) {
+			++last_moved;
 		}
+		_events.erase (where, last_moved);
 
 		unlocked_invalidate_insert_iterator ();
 		mark_dirty ();
@@ -2242,7 +2286,7 @@ ControlList::move_ranges (const list<RangeMove>& movements)
 		}
 
 		if (!_frozen) {
-			_events.sort (event_time_less_than);
+			std::stable_sort (_events.begin (), _events.end (), event_time_less_than);
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
 		} else {
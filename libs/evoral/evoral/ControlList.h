@@ -25,6 +25,7 @@
 
 #include <cassert>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 #include <boost/pool/pool.hpp>
@@ -84,11 +85,15 @@ public:
 
 
 /** A list (sequence) of time-stamped values for a control
+ *
+ * Events are kept in a contiguous array sorted by time, which allows
+ * O(log N) lookup. Note that unlike std::list, inserting or removing
+ * events invalidates iterators at or after the modified position.
  */
 class LIBEVORAL_API ControlList : public Temporal::TimeDomainProvider, public Temporal::TimeDomainSwapper
 {
 public:
-	typedef std::list<ControlEvent*> EventList;
+	typedef std::vector<ControlEvent*> EventList;
 	typedef EventList::iterator iterator;
 	typedef EventList::reverse_iterator reverse_iterator;
 	typedef EventList::const_iterator const_iterator;
@@ -186,6 +191,11 @@ public:
 	void erase (iterator);
 	void erase (iterator, iterator);
 	void erase (Temporal::timepos_t const &, double);
+	/** Erase all given events in a single pass. Unlike erasing one
+	 * iterator after another, this does not depend on iterators that
+	 * are invalidated by the previous erase.
+	 */
+	void erase (EventList const &);
 	bool move_ranges (std::list<Temporal::RangeMove> const &);
 	void modify (iterator, Temporal::timepos_t const &, double);
 
@@ -419,6 +429,7 @@ public:
 
 	void unlocked_remove_duplicates ();
 	void unlocked_invalidate_insert_iterator ();
+	void unlocked_erase (iterator);
 	void add_guard_point (Temporal::timepos_t const & when, Temporal::timecnt_t const & offset);
 
 	bool is_sorted () const;
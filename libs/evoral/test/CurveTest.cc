@@ -523,3 +523,56 @@ CurveTest::constrainedCubic ()
 		CPPUNIT_ASSERT_DOUBLES_EQUAL(v, g[x], 0.000008);
 	}
 }
+
+void
+CurveTest::ctrlListSequentialEval ()
+{
+	std::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+
+	/* saw-tooth, 0..9 repeating, one point every 10 samples */
+	for (int i = 0; i < 1000; ++i) {
+		cl->fast_simple_add (timepos_t (i * 10), i % 10);
+	}
+	cl->set_interpolation (ControlList::Linear);
+
+	/* moving forward (as during playback) continues from the cached position */
+	for (int i = 0; i < 9990; i += 3) {
+		const double v0 = (i / 10) % 10;
+		const double v1 = (i / 10 + 1) % 10;
+		const double expected = v0 + (v1 - v0) * (i % 10) / 10.0;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (expected, cl->unlocked_eval (timepos_t (i)), 1e-9);
+	}
+
+	/* large jumps and moving backwards */
+	for (int i = 9989; i >= 0; i -= 997) {
+		const double v0 = (i / 10) % 10;
+		const double v1 = (i / 10 + 1) % 10;
+		const double expected = v0 + (v1 - v0) * (i % 10) / 10.0;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (expected, cl->unlocked_eval (timepos_t (i)), 1e-9);
+	}
+
+	/* exact hits on control points */
+	for (int i = 0; i < 1000; i += 7) {
+		CPPUNIT_ASSERT_EQUAL ((double)(i % 10), cl->unlocked_eval (timepos_t (i * 10)));
+	}
+
+	/* erase the points in [5000, 5995], lookup must be re-computed */
+	cl->erase_range (timepos_t (5000), timepos_t (5995));
+	CPPUNIT_ASSERT_EQUAL ((Evoral::ControlList::EventList::size_type) 900, cl->size ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (9.0 - 9.0 * 500 / 1010, cl->unlocked_eval (timepos_t (5490)), 1e-9);
+
+	/* erase every other point at once */
+	Evoral::ControlList::EventList to_erase;
+	int n = 0;
+	for (Evoral::ControlList::const_iterator i = cl->begin (); i != cl->end (); ++i, ++n) {
+		if (n % 2 == 0) {
+			to_erase.push_back (*i);
+		}
+	}
+	cl->erase (to_erase);
+	CPPUNIT_ASSERT_EQUAL ((Evoral::ControlList::EventList::size_type) 450, cl->size ());
+	for (Evoral::ControlList::const_iterator i = cl->begin (); i != cl->end (); ++i) {
+		CPPUNIT_ASSERT_EQUAL (1, (int) (*i)->value % 2);
+	}
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (2.0, cl->unlocked_eval (timepos_t (20)), 1e-9);
+}
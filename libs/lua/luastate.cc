@@ -82,9 +82,10 @@ LuaState::collect_garbage () const {
 	lua_gc (L, LUA_GCCOLLECT, 0);
 }
 
-void
+bool
 LuaState::collect_garbage_step (int debt) {
-	lua_gc (L, LUA_GCSTEP, debt);
+	/* returns 1 if the step finished a collection cycle */
+	return 1 == lua_gc (L, LUA_GCSTEP, debt);
 }
 
 void
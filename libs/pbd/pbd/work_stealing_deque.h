@@ -0,0 +1,166 @@
+/*
+ * Copyright (C) 2026 Ardour Developers
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _pbd_work_stealing_deque_h_
+#define _pbd_work_stealing_deque_h_
+
+#include <atomic>
+#include <cassert>
+#include <stdint.h>
+#include <stdlib.h>
+
+namespace PBD {
+
+/* Bounded lock-free single-owner, multiple-thief deque.
+ *
+ * The owner thread pushes and pops at the bottom (LIFO), other threads
+ * steal from the top (FIFO).
+ *
+ * Chase, Lev "Dynamic Circular Work-Stealing Deque" (SPAA 2005),
+ * using the C11 memory-model mapping from Lê, Pop, Cohen, Zappa Nardelli
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ *
+ * Unlike the original, the buffer does not grow. push_back() fails
+ * when the deque is full, and the caller is expected to fall back to
+ * a shared queue. T must be trivially copyable (usually a pointer).
+ */
+template <typename T>
+class /*LIBPBD_API*/ WorkStealingDeque
+{
+public:
+	WorkStealingDeque (size_t buffer_size = 8)
+		: _buffer (0)
+		, _buffer_mask (0)
+	{
+		reserve (buffer_size);
+	}
+
+	~WorkStealingDeque ()
+	{
+		delete[] _buffer;
+	}
+
+	size_t capacity () const {
+		return _buffer_mask + 1;
+	}
+
+	/** Re-allocate the buffer, not thread-safe.
+	 * Must only be called while no other thread accesses the deque.
+	 */
+	void
+	reserve (size_t buffer_size)
+	{
+		size_t sz;
+		for (sz = 2; sz < buffer_size; sz <<= 1) ;
+		if (_buffer_mask >= sz - 1) {
+			return;
+		}
+		delete[] _buffer;
+		_buffer      = new std::atomic<T>[sz];
+		_buffer_mask = sz - 1;
+		clear ();
+	}
+
+	/** Drop all entries, not thread-safe. */
+	void
+	clear ()
+	{
+		_top.store (0, std::memory_order_relaxed);
+		_bottom.store (0, std::memory_order_relaxed);
+	}
+
+	/** Approximate number of entries, may be used by any thread */
+	size_t
+	size () const
+	{
+		int64_t b = _bottom.load (std::memory_order_relaxed);
+		int64_t t = _top.load (std::memory_order_relaxed);
+		return b > t ? b - t : 0;
+	}
+
+	/** Add an entry at the bottom, must only be called by the owner */
+	bool
+	push_back (T const& data)
+	{
+		int64_t b = _bottom.load (std::memory_order_relaxed);
+		int64_t t = _top.load (std::memory_order_acquire);
+		if (b - t > (int64_t)_buffer_mask) {
+			return false;
+		}
+		_buffer[b & _buffer_mask].store (data, std::memory_order_relaxed);
+		std::atomic_thread_fence (std::memory_order_release);
+		_bottom.store (b + 1, std::memory_order_relaxed);
+		return true;
+	}
+
+	/** Take the most recently pushed entry, must only be called by the owner */
+	bool
+	pop_back (T& data)
+	{
+		int64_t b = _bottom.load (std::memory_order_relaxed) - 1;
+		_bottom.store (b, std::memory_order_relaxed);
+		std::atomic_thread_fence (std::memory_order_seq_cst);
+		int64_t t = _top.load (std::memory_order_relaxed);
+
+		if (t > b) {
+			/* empty */
+			_bottom.store (b + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		data = _buffer[b & _buffer_mask].load (std::memory_order_relaxed);
+
+		if (t == b) {
+			/* last entry, race against thieves */
+			bool rv = _top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			_bottom.store (b + 1, std::memory_order_relaxed);
+			return rv;
+		}
+		return true;
+	}
+
+	/** Take the oldest entry, may be called by any thread */
+	bool
+	steal (T& data)
+	{
+		int64_t t = _top.load (std::memory_order_acquire);
+		std::atomic_thread_fence (std::memory_order_seq_cst);
+		int64_t b = _bottom.load (std::memory_order_acquire);
+
+		if (t >= b) {
+			return false;
+		}
+
+		data = _buffer[t & _buffer_mask].load (std::memory_order_relaxed);
+		return _top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+private:
+	char                 _pad0[64];
+	std::atomic<T>*      _buffer;
+	size_t               _buffer_mask;
+	char                 _pad1[64 - sizeof (std::atomic<T>*) - sizeof (size_t)];
+	std::atomic<int64_t> _top;
+	char                 _pad2[64 - sizeof (int64_t)];
+	std::atomic<int64_t> _bottom;
+	char                 _pad3[64 - sizeof (int64_t)];
+};
+
+} // namespace PBD
+
+#endif
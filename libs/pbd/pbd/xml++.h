@@ -87,6 +87,15 @@ public:
 	int compression() const { return _compression; }
 	int set_compression(int);
 
+	/** Use a compact binary encoding of the same tree instead of XML.
+	 * read() detects the encoding of the file and updates this flag.
+	 */
+	bool binary() const { return _binary; }
+	void set_binary(bool yn) { _binary = yn; }
+
+	/** @return true if the file at \p fn uses the binary encoding */
+	static bool is_binary_file (const std::string& fn);
+
 	bool read() { return read_internal(false); }
 	bool read(const std::string& fn) { set_filename(fn); return read_internal(false); }
 	bool read_and_validate() { return read_internal(true); }
@@ -104,11 +113,15 @@ public:
 
 private:
 	bool read_internal(bool validate);
+	bool read_stream();
+	bool read_binary();
+	bool write_binary() const;
 
 	std::string _filename;
 	XMLNode*    _root;
 	xmlDocPtr   _doc;
 	int         _compression;
+	bool        _binary;
 };
 
 class LIBPBD_API XMLNode {
@@ -197,6 +210,11 @@ public:
 	void dump (std::ostream &, std::string p = "") const;
 
 private:
+	friend class XMLTree;
+
+	/* used when reading, where the number of properties is known */
+	XMLNode(const std::string& name, size_t n_properties);
+
 	std::string         _name;
 	bool                _is_content;
 	std::string         _content;
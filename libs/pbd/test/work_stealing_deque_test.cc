@@ -0,0 +1,125 @@
+#include "work_stealing_deque_test.h"
+
+using namespace std;
+
+CPPUNIT_TEST_SUITE_REGISTRATION (WorkStealingDequeTest);
+
+WorkStealingDequeTest::WorkStealingDequeTest ()
+	: CppUnit::TestFixture ()
+	, _deque (1024)
+{
+}
+
+void
+WorkStealingDequeTest::setUp ()
+{
+	_deque.clear ();
+	_sum.store (0);
+	_cnt.store (0);
+	_done.store (0);
+}
+
+void
+WorkStealingDequeTest::order ()
+{
+	intptr_t v;
+
+	CPPUNIT_ASSERT (!_deque.pop_back (v));
+	CPPUNIT_ASSERT (!_deque.steal (v));
+
+	for (intptr_t i = 1; i <= 4; ++i) {
+		CPPUNIT_ASSERT (_deque.push_back (i));
+	}
+	CPPUNIT_ASSERT_EQUAL ((size_t)4, _deque.size ());
+
+	/* owner is LIFO, thieves are FIFO */
+	CPPUNIT_ASSERT (_deque.pop_back (v));
+	CPPUNIT_ASSERT_EQUAL ((intptr_t)4, v);
+	CPPUNIT_ASSERT (_deque.steal (v));
+	CPPUNIT_ASSERT_EQUAL ((intptr_t)1, v);
+	CPPUNIT_ASSERT (_deque.pop_back (v));
+	CPPUNIT_ASSERT_EQUAL ((intptr_t)3, v);
+	CPPUNIT_ASSERT (_deque.steal (v));
+	CPPUNIT_ASSERT_EQUAL ((intptr_t)2, v);
+
+	CPPUNIT_ASSERT (!_deque.pop_back (v));
+	CPPUNIT_ASSERT (!_deque.steal (v));
+	CPPUNIT_ASSERT_EQUAL ((size_t)0, _deque.size ());
+}
+
+void
+WorkStealingDequeTest::overflow ()
+{
+	size_t cap = _deque.capacity ();
+	for (size_t i = 0; i < cap; ++i) {
+		CPPUNIT_ASSERT (_deque.push_back (i));
+	}
+	CPPUNIT_ASSERT (!_deque.push_back (cap));
+
+	intptr_t v;
+	CPPUNIT_ASSERT (_deque.steal (v));
+	CPPUNIT_ASSERT (_deque.push_back (cap));
+}
+
+static void*
+launch_thief (void* self)
+{
+	WorkStealingDequeTest* t = static_cast<WorkStealingDequeTest *>(self);
+	t->thief_thread ();
+	return NULL;
+}
+
+void
+WorkStealingDequeTest::thief_thread ()
+{
+	while (!_done.load ()) {
+		intptr_t v;
+		if (_deque.steal (v)) {
+			_sum.fetch_add (v);
+			_cnt.fetch_add (1);
+		}
+	}
+}
+
+void
+WorkStealingDequeTest::race ()
+{
+	const int n_items   = 100000;
+	const int n_thieves = 3;
+
+	pthread_t thieves[n_thieves];
+	for (int i = 0; i < n_thieves; ++i) {
+		CPPUNIT_ASSERT (pthread_create (&thieves[i], NULL, launch_thief, this) == 0);
+	}
+
+	/* push all items, and pop some of them in the owner thread */
+	for (intptr_t i = 1; i <= n_items;) {
+		intptr_t v;
+		if (_deque.push_back (i)) {
+			++i;
+		}
+		if ((i & 3) == 0 && _deque.pop_back (v)) {
+			_sum.fetch_add (v);
+			_cnt.fetch_add (1);
+		}
+	}
+
+	while (_cnt.load () < n_items) {
+		intptr_t v;
+		if (_deque.pop_back (v)) {
+			_sum.fetch_add (v);
+			_cnt.fetch_add (1);
+		}
+	}
+
+	_done.store (1);
+
+	void* return_value;
+	for (int i = 0; i < n_thieves; ++i) {
+		CPPUNIT_ASSERT (pthread_join (thieves[i], &return_value) == 0);
+	}
+
+	/* every item was taken exactly once */
+	CPPUNIT_ASSERT_EQUAL (n_items, _cnt.load ());
+	CPPUNIT_ASSERT_EQUAL ((int64_t)n_items * (n_items + 1) / 2, _sum.load ());
+}
@@ -0,0 +1,31 @@
+#include <atomic>
+#include <pthread.h>
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "pbd/work_stealing_deque.h"
+
+class WorkStealingDequeTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (WorkStealingDequeTest);
+	CPPUNIT_TEST (order);
+	CPPUNIT_TEST (overflow);
+	CPPUNIT_TEST (race);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	WorkStealingDequeTest ();
+	void setUp ();
+	void order ();
+	void overflow ();
+	void race ();
+
+	void thief_thread ();
+
+private:
+	PBD::WorkStealingDeque<intptr_t> _deque;
+
+	std::atomic<int64_t> _sum;
+	std::atomic<int>     _cnt;
+	std::atomic<int>     _done;
+};
@@ -83,6 +83,34 @@ XMLTest::testXMLFilenameEncoding ()
 	}
 }
 
+void
+XMLTest::testStreamRead ()
+{
+	/* reading a file must give the same tree as parsing it in memory */
+	static const char* const doc =
+		"<?xml version=\"1.0\"?>\n"
+		"<!DOCTYPE Session>\n"
+		"<!-- before the root -->\n"
+		"<Session xmlns:x=\"urn:x\" version=\"7000\">\n"
+		"  <!-- a comment -->\n"
+		"  <Empty/>\n"
+		"  <Blank>  </Blank>\n"
+		"  <Route id=\"1\" x:name=\"a &amp; b\"><events>0 1\n2 3\n</events></Route>\n"
+		"  <Mixed>text<![CDATA[<cdata>]]><Child/>tail</Mixed>\n"
+		"</Session>\n";
+
+	const string output_path = Glib::build_filename (test_output_directory ("StreamRead"), "stream.xml");
+	CPPUNIT_ASSERT (g_file_set_contents (output_path.c_str (), doc, -1, NULL));
+
+	XMLTree from_buffer;
+	CPPUNIT_ASSERT (from_buffer.read_buffer (doc));
+
+	XMLTree from_file;
+	CPPUNIT_ASSERT (from_file.read (output_path));
+	CPPUNIT_ASSERT (*from_file.root () == *from_buffer.root ());
+
+	CPPUNIT_ASSERT (g_remove (output_path.c_str ()) == 0);
+}
 
 static const char * const root_node_name = "Session";
 static const char * const child_node_name = "Child";
@@ -225,6 +253,7 @@ test_xml_document (const std::string& test_name,
 	const std::string output_file_basename = Glib::build_filename (test_output_dir, test_name);
 
 	TimingData create_timing_data, write_timing_data, read_timing_data;
+	TimingData write_binary_timing_data, read_binary_timing_data;
 
 	for (uint32_t iter = 0; iter < test_iterations; ++iter) {
 
@@ -260,12 +289,38 @@ test_xml_document (const std::string& test_name,
 
 		// These files are too big to keep around
 		CPPUNIT_ASSERT (g_remove (output_file_path.c_str ()) == 0);
+
+		// same for the binary encoding
+		const std::string binary_file_path = output_file_basename + buf + ".bin";
+
+		test_xml.set_binary (true);
+
+		write_binary_timing_data.start_timing ();
+
+		CPPUNIT_ASSERT (test_xml.write (binary_file_path));
+
+		write_binary_timing_data.add_elapsed ();
+
+		CPPUNIT_ASSERT (XMLTree::is_binary_file (binary_file_path));
+
+		read_binary_timing_data.start_timing ();
+
+		XMLTree read_binary_doc (binary_file_path);
+
+		read_binary_timing_data.add_elapsed ();
+
+		CPPUNIT_ASSERT (read_binary_doc.binary ());
+		CPPUNIT_ASSERT (*read_binary_doc.root() == *test_xml.root());
+
+		CPPUNIT_ASSERT (g_remove (binary_file_path.c_str ()) == 0);
 	}
 
 	std::cerr << std::endl;
 	std::cerr << "   Create : " << create_timing_data.summary ();
 	std::cerr << "   Write : " << write_timing_data.summary ();
 	std::cerr << "   Read : " << read_timing_data.summary ();
+	std::cerr << "   Write (binary) : " << write_binary_timing_data.summary ();
+	std::cerr << "   Read (binary) : " << read_binary_timing_data.summary ();
 }
 
 void
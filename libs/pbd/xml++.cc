@@ -8,11 +8,16 @@
 #include <cassert>
 #include <string.h>
 #include <iostream>
+#include <unordered_map>
 
+#include <glib.h>
+
+#include "pbd/gstdio_compat.h"
 #include "pbd/utf8_utils.h"
 #include "pbd/xml++.h"
 
 #include <libxml/debugXML.h>
+#include <libxml/xmlreader.h>
 #include <libxml/xpath.h>
 #include <libxml/xpathInternals.h>
 
@@ -29,6 +34,7 @@ XMLTree::XMLTree()
 	, _root(0)
 	, _doc (0)
 	, _compression(0)
+	, _binary (false)
 {
 }
 
@@ -37,6 +43,7 @@ XMLTree::XMLTree(const string& fn, bool validate)
 	, _root(0)
 	, _doc (0)
 	, _compression(0)
+	, _binary (false)
 {
 	read_internal(validate);
 }
@@ -44,8 +51,9 @@ XMLTree::XMLTree(const string& fn, bool validate)
 XMLTree::XMLTree(const XMLTree* from)
 	: _filename(from->filename())
 	, _root(new XMLNode(*from->root()))
-	, _doc (xmlCopyDoc (from->_doc, 1))
+	, _doc (from->_doc ? xmlCopyDoc (from->_doc, 1) : 0)
 	, _compression(from->compression())
+	, _binary (from->binary())
 {
 
 }
@@ -87,6 +95,15 @@ XMLTree::read_internal(bool validate)
 		_doc = 0;
 	}
 
+	_binary = is_binary_file (_filename);
+	if (_binary) {
+		return read_binary ();
+	}
+
+	if (!validate) {
+		return read_stream ();
+	}
+
 	/* Calling this prevents libxml2 from treating whitespace as active
 	   nodes. It needs to be called before we create a parser context.
 	*/
@@ -125,6 +142,90 @@ XMLTree::read_internal(bool validate)
 	return true;
 }
 
+/** Parse the file directly into XMLNodes, without building a libxml2
+ * document first (which read_internal() used to keep for the lifetime of
+ * the tree). This roughly halves the peak memory use when loading large
+ * session or history files, and avoids a second pass over the document.
+ * The resulting tree is identical to what readnode() creates.
+ */
+bool
+XMLTree::read_stream ()
+{
+	xmlKeepBlanksDefault(0);
+
+	xmlTextReaderPtr reader = xmlReaderForFile (_filename.c_str(), NULL, XML_PARSE_HUGE | XML_PARSE_NOBLANKS);
+	if (!reader) {
+		return false;
+	}
+
+	vector<XMLNode*> parents;
+	int rv;
+
+	while ((rv = xmlTextReaderRead (reader)) == 1) {
+		XMLNode* node;
+		int const type = xmlTextReaderNodeType (reader);
+
+		switch (type) {
+		case XML_READER_TYPE_ELEMENT:
+			node = new XMLNode ((const char*) xmlTextReaderConstLocalName (reader), xmlTextReaderAttributeCount (reader));
+			while (xmlTextReaderMoveToNextAttribute (reader) == 1) {
+				if (!xmlTextReaderIsNamespaceDecl (reader)) {
+					node->set_property ((const char*) xmlTextReaderConstLocalName (reader), string ((const char*) xmlTextReaderConstValue (reader)));
+				}
+			}
+			xmlTextReaderMoveToElement (reader);
+			break;
+		case XML_READER_TYPE_TEXT:
+		case XML_READER_TYPE_WHITESPACE:
+		case XML_READER_TYPE_SIGNIFICANT_WHITESPACE:
+			/* blanks that libxml2 ignores are not reported */
+			node = new XMLNode ("text", 0);
+			node->set_content ((const char*) xmlTextReaderConstValue (reader));
+			break;
+		case XML_READER_TYPE_CDATA:
+			/* libxml2 CDATA section nodes have no name, see readnode() */
+			node = new XMLNode ("", 0);
+			node->set_content ((const char*) xmlTextReaderConstValue (reader));
+			break;
+		case XML_READER_TYPE_COMMENT:
+			node = new XMLNode ("comment", 0);
+			node->set_content ((const char*) xmlTextReaderConstValue (reader));
+			break;
+		case XML_READER_TYPE_END_ELEMENT:
+			if (!parents.empty ()) {
+				parents.pop_back ();
+			}
+			continue;
+		default:
+			continue;
+		}
+
+		if (!parents.empty ()) {
+			parents.back ()->add_child_nocopy (*node);
+		} else if (!_root && type == XML_READER_TYPE_ELEMENT) {
+			_root = node;
+		} else {
+			/* outside of the root element */
+			delete node;
+			continue;
+		}
+
+		if (type == XML_READER_TYPE_ELEMENT && !xmlTextReaderIsEmptyElement (reader)) {
+			parents.push_back (node);
+		}
+	}
+
+	xmlFreeTextReader (reader);
+
+	if (rv != 0 || !_root) {
+		delete _root;
+		_root = 0;
+		return false;
+	}
+
+	return true;
+}
+
 bool
 XMLTree::read_buffer (char const* buffer, bool to_tree_doc)
 {
@@ -163,6 +264,10 @@ XMLTree::write() const
 	XMLNodeList children;
 	int result;
 
+	if (_binary) {
+		return write_binary ();
+	}
+
 	xmlKeepBlanksDefault(0);
 	doc = xmlNewDoc(xml_version);
 	xmlSetDocCompressMode(doc, _compression);
@@ -247,6 +352,13 @@ XMLNode::XMLNode(const string& n, const string& c)
 	_proplist.reserve (PROPERTY_RESERVE_COUNT);
 }
 
+XMLNode::XMLNode(const string& n, size_t n_properties)
+	: _name(n)
+	, _is_content(false)
+{
+	_proplist.reserve (n_properties);
+}
+
 XMLNode::XMLNode(const XMLNode& from)
 {
 	_proplist.reserve (PROPERTY_RESERVE_COUNT);
@@ -471,6 +583,11 @@ XMLTree::find(const string xpath, XMLNode* node) const
 	xmlXPathContext* ctxt;
 	xmlDocPtr doc = 0;
 
+	if (!node && !_doc) {
+		/* read from a binary file */
+		node = _root;
+	}
+
 	if (node) {
 		doc = xmlNewDoc(xml_version);
 		writenode(doc, node, doc->children, 1);
@@ -846,3 +963,213 @@ XMLNode::dump (ostream& s, string p) const
 		s << p << "</" << _name << ">\n";
 	}
 }
+
+/* Binary encoding
+ *
+ * The file starts with a magic string, followed by a table of all
+ * distinct strings (names, values and content) and the node tree.
+ * Nodes refer to strings by their index in the table. All integers
+ * are unsigned LEB128.
+ *
+ *  node := name, flags, [content,] n_properties, (name, value)*, n_children, node*
+ */
+
+static const char   binary_magic[] = "PBDXMLB1";
+static const size_t binary_magic_len = sizeof (binary_magic) - 1;
+
+namespace {
+
+struct BinaryWriter {
+	std::unordered_map<std::string, uint32_t> ids;
+	std::vector<std::string const*> strings;
+	std::string nodes;
+
+	void put (std::string& out, uint64_t v) {
+		while (v >= 0x80) {
+			out.push_back ((char)((v & 0x7f) | 0x80));
+			v >>= 7;
+		}
+		out.push_back ((char) v);
+	}
+
+	void put_string (std::string const& s) {
+		std::pair<std::unordered_map<std::string, uint32_t>::iterator, bool> r = ids.insert (std::make_pair (s, (uint32_t) strings.size ()));
+		if (r.second) {
+			strings.push_back (&r.first->first);
+		}
+		put (nodes, r.first->second);
+	}
+
+	void put_node (XMLNode const& n) {
+		put_string (n.name ());
+		nodes.push_back (n.is_content () ? 1 : 0);
+		if (n.is_content ()) {
+			put_string (n.content ());
+		}
+
+		XMLPropertyList const& props = n.properties ();
+		put (nodes, props.size ());
+		for (XMLPropertyConstIterator i = props.begin (); i != props.end (); ++i) {
+			put_string ((*i)->name ());
+			put_string ((*i)->value ());
+		}
+
+		XMLNodeList const& children = n.children ();
+		put (nodes, children.size ());
+		for (XMLNodeConstIterator i = children.begin (); i != children.end (); ++i) {
+			put_node (**i);
+		}
+	}
+};
+
+struct BinaryReader {
+	char const* p;
+	char const* end;
+	std::vector<std::string> strings;
+
+	bool get (uint64_t& v) {
+		v = 0;
+		for (int shift = 0; p < end && shift < 64; shift += 7) {
+			uint8_t const b = *p++;
+			v |= (uint64_t)(b & 0x7f) << shift;
+			if (!(b & 0x80)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	std::string const* get_string () {
+		uint64_t id;
+		if (!get (id) || id >= strings.size ()) {
+			return 0;
+		}
+		return &strings[id];
+	}
+
+	XMLNode* get_node (int depth) {
+		std::string const* name = get_string ();
+		if (!name || p >= end || depth > 1024) {
+			return 0;
+		}
+
+		XMLNode* node = new XMLNode (*name);
+
+		if (*p++) {
+			std::string const* content = get_string ();
+			if (!content) {
+				delete node;
+				return 0;
+			}
+			node->set_content (*content);
+		}
+
+		uint64_t n;
+		if (!get (n)) {
+			delete node;
+			return 0;
+		}
+		for (uint64_t i = 0; i < n; ++i) {
+			std::string const* pname = get_string ();
+			std::string const* value = get_string ();
+			if (!pname || !value) {
+				delete node;
+				return 0;
+			}
+			node->set_property (pname->c_str (), *value);
+		}
+
+		if (!get (n)) {
+			delete node;
+			return 0;
+		}
+		for (uint64_t i = 0; i < n; ++i) {
+			XMLNode* child = get_node (depth + 1);
+			if (!child) {
+				delete node;
+				return 0;
+			}
+			node->add_child_nocopy (*child);
+		}
+		return node;
+	}
+};
+
+}
+
+bool
+XMLTree::is_binary_file (const string& fn)
+{
+	char buf[binary_magic_len];
+	FILE* f = g_fopen (fn.c_str (), "rb");
+	if (!f) {
+		return false;
+	}
+	bool rv = fread (buf, 1, binary_magic_len, f) == binary_magic_len && memcmp (buf, binary_magic, binary_magic_len) == 0;
+	fclose (f);
+	return rv;
+}
+
+bool
+XMLTree::write_binary () const
+{
+	if (!_root) {
+		return false;
+	}
+
+	BinaryWriter w;
+	w.put_node (*_root);
+
+	std::string head (binary_magic, binary_magic_len);
+	w.put (head, w.strings.size ());
+	for (std::vector<std::string const*>::const_iterator i = w.strings.begin (); i != w.strings.end (); ++i) {
+		w.put (head, (*i)->size ());
+		head.append (**i);
+	}
+
+	FILE* f = g_fopen (_filename.c_str (), "wb");
+	if (!f) {
+		return false;
+	}
+	bool rv = fwrite (head.data (), 1, head.size (), f) == head.size ()
+	          && fwrite (w.nodes.data (), 1, w.nodes.size (), f) == w.nodes.size ();
+	rv = (fclose (f) == 0) && rv;
+	return rv;
+}
+
+bool
+XMLTree::read_binary ()
+{
+	gchar*  data;
+	gsize   len;
+
+	if (!g_file_get_contents (_filename.c_str (), &data, &len, NULL)) {
+		return false;
+	}
+
+	BinaryReader r;
+	r.p = data + binary_magic_len;
+	r.end = data + len;
+
+	uint64_t n_strings;
+	bool ok = len >= binary_magic_len && r.get (n_strings) && n_strings <= len;
+	if (ok) {
+		r.strings.reserve (n_strings);
+	}
+	for (uint64_t i = 0; ok && i < n_strings; ++i) {
+		uint64_t l;
+		ok = r.get (l) && l <= (uint64_t)(r.end - r.p);
+		if (ok) {
+			r.strings.push_back (std::string (r.p, l));
+			r.p += l;
+		}
+	}
+
+	if (ok) {
+		_root = r.get_node (0);
+		ok = _root != 0;
+	}
+
+	g_free (data);
+	return ok;
+}
@@ -241,6 +241,8 @@ WaveView::create_draw_request (WaveViewProperties const& props) const
 	std::shared_ptr<WaveViewDrawRequest> request (new WaveViewDrawRequest);
 
 	request->image = std::shared_ptr<WaveViewImage> (new WaveViewImage (_region, props));
+	/* props cover the visible part of the waveview */
+	request->priority = props.get_width_pixels () * props.height;
 	return request;
 }
 
@@ -358,18 +360,23 @@ WaveView::queue_draw_request (std::shared_ptr<WaveViewDrawRequest> const& reques
 		return;
 	}
 
-	if (current_request) {
-		current_request->cancel ();
-	}
-
 	std::shared_ptr<WaveViewImage> cached_image =
 	    get_cache_group ()->lookup_image (request->image->props);
 
+	if (current_request && (!cached_image || current_request->image != cached_image)) {
+		current_request->cancel ();
+	}
+
 	if (cached_image) {
 		// The image may not be finished at this point but that is fine, great in
 		// fact as it means it should only need to be drawn once.
 		request->image = cached_image;
 		current_request = request;
+
+		if (!cached_image->finished () && !WaveViewThreads::renew_draw_request (cached_image, request->priority)) {
+			// The request for the image was cancelled or dropped
+			WaveViewThreads::enqueue_draw_request (current_request);
+		}
 	} else {
 		// now we can finally set an optimal image now that we are not using the
 		// properties for comparisons.
@@ -1042,6 +1049,7 @@ WaveView::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) cons
 		if (_image->props.is_equivalent (required_props)) {
 			// Image contains required properties
 			image_to_draw = _image;
+			get_cache_group ()->use_image (_image);
 		} else {
 			// Image does not contain properties required
 		}
@@ -1087,6 +1095,7 @@ WaveView::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) cons
 				image_to_draw = request->image;
 			} else {
 				// Waiting for current request to finish
+				draw_scaled_image (context, self, draw, required_props);
 				redraw ();
 				return;
 			}
@@ -1094,6 +1103,7 @@ WaveView::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) cons
 			// Defer the rendering to another thread or perhaps render pass if
 			// a thread cannot generate it in time.
 			queue_draw_request (request);
+			draw_scaled_image (context, self, draw, required_props);
 			redraw ();
 			return;
 		}
@@ -1165,6 +1175,39 @@ WaveView::render (Rect const & area, Cairo::RefPtr<Cairo::Context> context) cons
 	context->fill ();
 }
 
+/** Draw a cached image of a different zoom-level, scaled to the current
+ * zoom-level, while the image for the current zoom-level is being drawn.
+ */
+bool
+WaveView::draw_scaled_image (Cairo::RefPtr<Cairo::Context> const& context, Rect const& self,
+                             Rect const& draw, WaveViewProperties const& required_props) const
+{
+	std::shared_ptr<WaveViewImage> image = get_cache_group ()->lookup_scalable_image (required_props);
+
+	if (!image) {
+		return false;
+	}
+
+	double const           samples_per_pixel = _props->samples_per_pixel;
+	samplepos_t const      region_position   = _region->position().samples();
+	samplepos_t const      region_view_x     = round (round (region_position / samples_per_pixel) * samples_per_pixel);
+	ARDOUR::sampleoffset_t region_view_dx    = region_position - region_view_x;
+
+	double const x     = self.x0 + (image->props.get_sample_start () - _props->region_start + region_view_dx) / samples_per_pixel;
+	double const scale = image->props.samples_per_pixel / samples_per_pixel;
+
+	context->save ();
+	/* the path is not affected by the following transformation */
+	context->rectangle (draw.x0, draw.y0, draw.width (), draw.height ());
+	context->translate (x, self.y0);
+	context->scale (scale, 1.0);
+	context->set_source (image->cairo_image, 0, 0);
+	context->fill ();
+	context->restore ();
+
+	return true;
+}
+
 void
 WaveView::compute_bounding_box () const
 {
@@ -1408,6 +1451,24 @@ WaveView::set_image_cache_size (uint64_t sz)
 	WaveViewCache::get_instance()->set_image_cache_threshold (sz);
 }
 
+void
+WaveView::start_draw_generation ()
+{
+	WaveViewThreads::next_generation ();
+}
+
+WaveView::DrawStats
+WaveView::draw_stats (bool reset)
+{
+	return WaveViewThreads::draw_stats (reset);
+}
+
+WaveView::ImageCacheStats
+WaveView::image_cache_stats ()
+{
+	return WaveViewCache::get_instance()->stats ();
+}
+
 std::shared_ptr<WaveViewCacheGroup>
 WaveView::get_cache_group () const
 {
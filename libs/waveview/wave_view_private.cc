@@ -17,16 +17,19 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
 #include "ardour/lmath.h"
 
 #include "pbd/assert.h"
+#include "pbd/compose.h"
 #include "pbd/cpus.h"
 #include "pbd/pthread_utils.h"
 
 #include "ardour/audioregion.h"
 #include "ardour/audiosource.h"
 
+#include "waveview/debug.h"
 #include "waveview/wave_view_private.h"
 
 namespace ArdourWaveView {
@@ -61,6 +64,8 @@ WaveViewImage::WaveViewImage (std::shared_ptr<const ARDOUR::AudioRegion> const&
 	: region (region_ptr)
 	, props (properties)
 	, timestamp (0)
+	, cache_group (0)
+	, cache_size (0)
 {
 
 }
@@ -91,54 +96,39 @@ WaveViewCacheGroup::add_image (std::shared_ptr<WaveViewImage> image)
 		return;
 	}
 
-	ImageCache::iterator oldest_image_it = _cached_images.begin();
-	ImageCache::iterator second_oldest_image_it = _cached_images.end();
+	if (image->cache_group == this) {
+		// Must never be more than one instance of the image in the cache
+		use_image (image);
+		return;
+	}
 
 	for (ImageCache::iterator it = _cached_images.begin (); it != _cached_images.end (); ++it) {
-		if ((*it) == image) {
-			// Must never be more than one instance of the image in the cache
-			(*it)->timestamp = g_get_monotonic_time ();
-			return;
-		} else if ((*it)->props.is_equivalent (image->props)) {
-			// Equivalent Image already in cache, updating timestamp
-			(*it)->timestamp = g_get_monotonic_time ();
+		if ((*it)->props.is_equivalent (image->props)) {
+			// Equivalent Image already in cache, mark it as used
+			use_image (*it);
 			return;
 		}
-
-		if ((*it)->timestamp < (*oldest_image_it)->timestamp) {
-			second_oldest_image_it = oldest_image_it;
-			oldest_image_it = it;
-		}
 	}
 
 	// no duplicate or equivalent image so we are definitely adding it to cache
-	image->timestamp = g_get_monotonic_time ();
+	_cached_images.push_back (image);
+	_parent_cache.insert (this, image);
+}
 
-	if (_parent_cache.full () || full ()) {
-		if (oldest_image_it != _cached_images.end()) {
-			// Replacing oldest Image in cache
-			_parent_cache.decrease_size ((*oldest_image_it)->size_in_bytes ());
-			*oldest_image_it = image;
-			_parent_cache.increase_size (image->size_in_bytes ());
-
-			if (second_oldest_image_it != _cached_images.end ()) {
-				// Removing second oldest Image in cache
-				_parent_cache.decrease_size ((*second_oldest_image_it)->size_in_bytes ());
-				_cached_images.erase (second_oldest_image_it);
-			}
-			return;
-		} else {
-			/**
-			 * Add the image to the cache even if the threshold is exceeded so that
-			 * new WaveViews can still cache images with a full cache, the size of
-			 * the cache will quickly equalize back to the threshold as new images
-			 * are added and the size of the cache is reduced.
-			 */
-		}
+void
+WaveViewCacheGroup::use_image (std::shared_ptr<WaveViewImage> const& image)
+{
+	if (image && image->cache_group == this) {
+		_parent_cache.use (image);
 	}
+}
 
-	_cached_images.push_back (image);
-	_parent_cache.increase_size (image->size_in_bytes ());
+void
+WaveViewCacheGroup::remove_image (std::shared_ptr<WaveViewImage> const& image)
+{
+	ImageCache::iterator it = std::find (_cached_images.begin (), _cached_images.end (), image);
+	assert (it != _cached_images.end ());
+	_cached_images.erase (it);
 }
 
 std::shared_ptr<WaveViewImage>
@@ -146,18 +136,45 @@ WaveViewCacheGroup::lookup_image (WaveViewProperties const& props)
 {
 	for (ImageCache::iterator i = _cached_images.begin (); i != _cached_images.end (); ++i) {
 		if ((*i)->props.is_equivalent (props)) {
+			++_parent_cache._hits;
+			use_image (*i);
 			return (*i);
 		}
 	}
+	++_parent_cache._misses;
 	return std::shared_ptr<WaveViewImage>();
 }
 
+std::shared_ptr<WaveViewImage>
+WaveViewCacheGroup::lookup_scalable_image (WaveViewProperties const& props)
+{
+	std::shared_ptr<WaveViewImage> rv;
+	double best = 0;
+
+	for (ImageCache::iterator i = _cached_images.begin (); i != _cached_images.end (); ++i) {
+		if (!(*i)->finished () || !(*i)->props.is_scalable_to (props)) {
+			continue;
+		}
+		/* prefer the image closest to the requested zoom-level */
+		double const d = fabs (log ((*i)->props.samples_per_pixel / props.samples_per_pixel));
+		if (!rv || d < best) {
+			rv   = *i;
+			best = d;
+		}
+	}
+
+	if (rv) {
+		++_parent_cache._scaled_hits;
+	}
+	return rv;
+}
+
 void
 WaveViewCacheGroup::clear_cache ()
 {
 	// Tell the parent cache about the images we are about to drop references to
 	for (ImageCache::iterator it = _cached_images.begin (); it != _cached_images.end (); ++it) {
-		_parent_cache.decrease_size ((*it)->size_in_bytes ());
+		_parent_cache.remove (*it);
 	}
 	_cached_images.clear ();
 }
@@ -167,6 +184,10 @@ WaveViewCacheGroup::clear_cache ()
 WaveViewCache::WaveViewCache ()
 	: image_cache_size (0)
 	, _image_cache_threshold (100 * 1048576) /* bytes */
+	, _hits (0)
+	, _scaled_hits (0)
+	, _misses (0)
+	, _evictions (0)
 {
 
 }
@@ -183,17 +204,69 @@ WaveViewCache::get_instance ()
 }
 
 void
-WaveViewCache::increase_size (uint64_t bytes)
+WaveViewCache::insert (WaveViewCacheGroup* group, std::shared_ptr<WaveViewImage> const& image)
+{
+	assert (!image->cache_group);
+
+	image->cache_group  = group;
+	image->cache_size   = image->size_in_bytes ();
+	image->timestamp    = g_get_monotonic_time ();
+	image->lru_position = _lru.insert (_lru.end (), image);
+
+	image_cache_size += image->cache_size;
+
+	if (full ()) {
+		evict (image);
+	}
+}
+
+void
+WaveViewCache::remove (std::shared_ptr<WaveViewImage> const& image)
 {
-	image_cache_size += bytes;
+	assert (image->cache_group);
+	assert (image->cache_size <= image_cache_size);
+
+	image_cache_size -= image->cache_size;
+	image->cache_group = 0;
+	_lru.erase (image->lru_position);
 }
 
 void
-WaveViewCache::decrease_size (uint64_t bytes)
+WaveViewCache::use (std::shared_ptr<WaveViewImage> const& image)
+{
+	image->timestamp = g_get_monotonic_time ();
+	_lru.splice (_lru.end (), _lru, image->lru_position);
+}
+
+/** Drop least recently used images of all groups until the cache size is
+ * below the threshold. The image that was just added is always kept, so
+ * that new WaveViews can still cache images with a full cache.
+ */
+void
+WaveViewCache::evict (std::shared_ptr<WaveViewImage> const& keep)
+{
+	while (full () && !_lru.empty () && _lru.front () != keep) {
+		std::shared_ptr<WaveViewImage> image = _lru.front ();
+		image->cache_group->remove_image (image);
+		remove (image);
+		++_evictions;
+	}
+
+	DEBUG_TRACE (PBD::DEBUG::WaveView, string_compose ("WaveViewCache: %1 images, %2 bytes, %3 evictions\n", _lru.size (), image_cache_size, _evictions));
+}
+
+WaveView::ImageCacheStats
+WaveViewCache::stats () const
 {
-	assert (bytes > 0);
-	assert (bytes <= image_cache_size);
-	image_cache_size -= bytes;
+	WaveView::ImageCacheStats s;
+	s.size        = image_cache_size;
+	s.threshold   = _image_cache_threshold;
+	s.n_images    = _lru.size ();
+	s.hits        = _hits;
+	s.scaled_hits = _scaled_hits;
+	s.misses      = _misses;
+	s.evictions   = _evictions;
+	return s;
 }
 
 std::shared_ptr<WaveViewCacheGroup>
@@ -245,18 +318,28 @@ WaveViewCache::clear_cache ()
 	for (CacheGroups::iterator it = cache_group_map.begin (); it != cache_group_map.end (); ++it) {
 		(*it).second->clear_cache ();
 	}
+	assert (_lru.empty ());
 }
 
 void
 WaveViewCache::set_image_cache_threshold (uint64_t sz)
 {
 	_image_cache_threshold = sz;
+
+	if (full () && !_lru.empty ()) {
+		evict (_lru.back ());
+	}
 }
 
 /*-------------------------------------------------*/
 
 WaveViewThreads::WaveViewThreads ()
 	: _quit (false)
+	, _generation (0)
+	, _max_queue_depth (0)
+	, _n_drawn (0)
+	, _n_dropped (0)
+	, _draw_time (0)
 {
 }
 
@@ -300,11 +383,82 @@ void
 WaveViewThreads::_enqueue_draw_request (std::shared_ptr<WaveViewDrawRequest>& request)
 {
 	PBD::Mutex::Lock lm (_queue_mutex);
+	request->generation = _generation.load ();
+	request->image->pending_request = request;
 	_queue.push_back (request);
+	_max_queue_depth = std::max (_max_queue_depth, _queue.size ());
 	/* wake one (random) thread */
 	_cond.signal ();
 }
 
+bool
+WaveViewThreads::renew_draw_request (std::shared_ptr<WaveViewImage> const& image, double priority)
+{
+	assert (instance);
+
+	PBD::Mutex::Lock lm (instance->_queue_mutex);
+
+	std::shared_ptr<WaveViewDrawRequest> req = image->pending_request.lock ();
+
+	if (!req || req->stopped ()) {
+		return false;
+	}
+
+	req->generation = instance->_generation.load ();
+	req->priority   = std::max (req->priority, priority);
+	return true;
+}
+
+uint64_t
+WaveViewThreads::generation ()
+{
+	return instance ? instance->_generation.load () : 0;
+}
+
+void
+WaveViewThreads::next_generation ()
+{
+	if (!instance) {
+		return;
+	}
+
+	if (DEBUG_ENABLED (PBD::DEBUG::WaveView)) {
+		WaveView::DrawStats s = draw_stats (true);
+		DEBUG_TRACE (PBD::DEBUG::WaveView, string_compose ("WaveView generation %1: queue %2 (max %3) drawn %4 dropped %5 in %6 ms\n",
+		                                                   instance->_generation.load (), s.queue_depth, s.max_queue_depth,
+		                                                   s.n_drawn, s.n_dropped, s.draw_time / 1000.0));
+	}
+
+	instance->_generation.fetch_add (1);
+}
+
+WaveView::DrawStats
+WaveViewThreads::draw_stats (bool reset)
+{
+	WaveView::DrawStats s = { 0, 0, 0, 0, 0 };
+
+	if (!instance) {
+		return s;
+	}
+
+	PBD::Mutex::Lock lm (instance->_queue_mutex);
+
+	s.queue_depth     = instance->_queue.size ();
+	s.max_queue_depth = instance->_max_queue_depth;
+	s.n_drawn         = instance->_n_drawn;
+	s.n_dropped       = instance->_n_dropped;
+	s.draw_time       = instance->_draw_time;
+
+	if (reset) {
+		instance->_max_queue_depth = s.queue_depth;
+		instance->_n_drawn         = 0;
+		instance->_n_dropped       = 0;
+		instance->_draw_time       = 0;
+	}
+
+	return s;
+}
+
 std::shared_ptr<WaveViewDrawRequest>
 WaveViewThreads::dequeue_draw_request ()
 {
@@ -327,11 +481,32 @@ WaveViewThreads::_dequeue_draw_request ()
 
 	/* queue could be empty at this point because an already running thread
 	 * pulled the request before we were fully awake and reacquired the mutex.
+	 *
+	 * Drop requests that were cancelled or have not been renewed since the
+	 * visible area changed, and pick the most visible of the remaining ones.
 	 */
 
-	if (!_queue.empty()) {
-		req = _queue.front ();
-		_queue.pop_front ();
+	uint64_t const generation = _generation.load ();
+
+	DrawRequestQueueType::iterator best = _queue.end ();
+
+	for (DrawRequestQueueType::iterator i = _queue.begin (); i != _queue.end (); ) {
+		if ((*i)->stopped () || (*i)->generation < generation || (*i)->finished ()) {
+			/* mark as stopped, so that it is not renewed */
+			(*i)->cancel ();
+			i = _queue.erase (i);
+			++_n_dropped;
+			continue;
+		}
+		if (best == _queue.end () || (*i)->priority > (*best)->priority) {
+			best = i;
+		}
+		++i;
+	}
+
+	if (best != _queue.end ()) {
+		req = *best;
+		_queue.erase (best);
 	}
 
 	return req;
@@ -344,12 +519,12 @@ WaveViewThreads::start_threads ()
 
 	const int num_cpus = PBD::hardware_concurrency ();
 
-	/* the upper limit of 8 here is entirely arbitrary. It just doesn't
-	 * seem worthwhile having "ncpus" of low priority threads for
-	 * rendering waveforms into the cache.
+	/* use about half of the available cores, leaving room for the GUI
+	 * and realtime threads. The upper limit is entirely arbitrary, at
+	 * some point reading peak-data from disk is the bottleneck.
 	 */
 
-	uint32_t num_threads = std::min (8, std::max (1, num_cpus - 1));
+	uint32_t num_threads = std::min (16, std::max (1, num_cpus / 2));
 
 	for (uint32_t i = 0; i != num_threads; ++i) {
 		std::shared_ptr<WaveViewDrawingThread> new_thread (new WaveViewDrawingThread ());
@@ -378,6 +553,8 @@ WaveViewThreads::stop_threads ()
 
 /*-------------------------------------------------*/
 WaveViewDrawRequest::WaveViewDrawRequest ()
+	: generation (0)
+	, priority (0)
 {
 	_stop.store (0);
 }
@@ -501,12 +678,18 @@ WaveViewThreads::_thread_proc ()
 		_queue_mutex.unlock ();
 
 		if (req && !req->stopped()) {
+			int64_t const start = g_get_monotonic_time ();
 			try {
 				WaveView::process_draw_request (req);
 			} catch (...) {
 				/* just in case it was set before the exception, whatever it was */
 				req->image->cairo_image.clear ();
 			}
+			int64_t const elapsed = g_get_monotonic_time () - start;
+
+			PBD::Mutex::Lock lm (_queue_mutex);
+			++_n_drawn;
+			_draw_time += elapsed;
 		}
 	}
 }
@@ -145,6 +145,34 @@ public:
 
 	static void set_image_cache_size (uint64_t);
 
+	struct ImageCacheStats {
+		uint64_t size;        ///< bytes
+		uint64_t threshold;   ///< bytes
+		uint64_t n_images;
+		uint64_t hits;
+		uint64_t scaled_hits; ///< images of a different zoom-level drawn while waiting for a new one
+		uint64_t misses;
+		uint64_t evictions;
+	};
+
+	static ImageCacheStats image_cache_stats ();
+
+	/** Start a new generation of draw requests. Queued requests of
+	 * previous generations are dropped, unless they are requested
+	 * again. Call this before updating the visible area of the canvas.
+	 */
+	static void start_draw_generation ();
+
+	struct DrawStats {
+		size_t   queue_depth;
+		size_t   max_queue_depth;
+		uint64_t n_drawn;
+		uint64_t n_dropped;     ///< cancelled or stale requests
+		int64_t  draw_time;     ///< microseconds spent drawing in worker threads
+	};
+
+	static DrawStats draw_stats (bool reset = false);
+
 private:
 	friend class WaveViewThreadClient;
 	friend class WaveViewThreads;
@@ -239,6 +267,9 @@ private:
 
 	void queue_draw_request (std::shared_ptr<WaveViewDrawRequest> const&) const;
 
+	bool draw_scaled_image (Cairo::RefPtr<Cairo::Context> const&, ArdourCanvas::Rect const& self,
+	                        ArdourCanvas::Rect const& draw, WaveViewProperties const&) const;
+
 	static void process_draw_request (std::shared_ptr<WaveViewDrawRequest>);
 
 	std::shared_ptr<WaveViewCacheGroup> get_cache_group () const;
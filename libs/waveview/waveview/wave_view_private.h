@@ -20,6 +20,7 @@
 #define _WAVEVIEW_WAVE_VIEW_PRIVATE_H_
 
 #include <deque>
+#include <list>
 
 #include "pbd/mutex.h"
 #include "pbd/pthread_utils.h"
@@ -159,12 +160,30 @@ public: // methods
 		// region_start && start_shift??
 	}
 
+	/** @return true if an image with these properties can be scaled to
+	 * replace an image with \p other properties (same except for zoom).
+	 */
+	bool is_scalable_to (WaveViewProperties const& other)
+	{
+		return (samples_per_pixel != 0 && other.samples_per_pixel != 0 &&
+		        contains (other.sample_start, other.sample_end) && channel == other.channel &&
+		        height == other.height && amplitude == other.amplitude &&
+		        amplitude_above_axis == other.amplitude_above_axis && fill_color == other.fill_color &&
+		        outline_color == other.outline_color && zero_color == other.zero_color &&
+		        clip_color == other.clip_color && show_zero == other.show_zero &&
+		        logscaled == other.logscaled && shape == other.shape &&
+		        gradient_depth == other.gradient_depth);
+	}
+
 	bool contains (samplepos_t start, samplepos_t end)
 	{
 		return (sample_start <= start && end <= sample_end);
 	}
 };
 
+class WaveViewCacheGroup;
+struct WaveViewDrawRequest;
+
 struct WaveViewImage {
 public: // ctors
 	WaveViewImage (std::shared_ptr<const ARDOUR::AudioRegion> const& region_ptr,
@@ -178,6 +197,14 @@ public: // member variables
 	Cairo::RefPtr<Cairo::ImageSurface> cairo_image;
 	uint64_t timestamp;
 
+	/* WaveViewCache state, only used in the GUI thread */
+	WaveViewCacheGroup* cache_group;
+	uint64_t cache_size;
+	std::list<std::shared_ptr<WaveViewImage> >::iterator lru_position;
+
+	/* the last request that was queued to draw this image */
+	std::weak_ptr<WaveViewDrawRequest> pending_request;
+
 public: // methods
 	bool finished() { return static_cast<bool>(cairo_image); }
 
@@ -210,6 +237,11 @@ public:
 
 	std::shared_ptr<WaveViewImage> image;
 
+	/** Requests of older generations are dropped, see WaveViewThreads::next_generation */
+	uint64_t generation;
+	/** Requests with higher priority (visible area in pixels) are drawn first */
+	double   priority;
+
 	bool is_valid () {
 		return (image && image->is_valid());
 	}
@@ -232,15 +264,20 @@ public:
 	// @return image with matching properties or null
 	std::shared_ptr<WaveViewImage> lookup_image (WaveViewProperties const&);
 
-	void add_image (std::shared_ptr<WaveViewImage>);
+	// @return finished image that can be scaled to the given properties or null
+	std::shared_ptr<WaveViewImage> lookup_scalable_image (WaveViewProperties const&);
 
-	bool full () const { return _cached_images.size() > max_size(); }
+	void add_image (std::shared_ptr<WaveViewImage>);
 
-	static uint32_t max_size () { return 16; }
+	/** Mark the image as most recently used */
+	void use_image (std::shared_ptr<WaveViewImage> const&);
 
 	void clear_cache ();
 
 private:
+	friend class WaveViewCache;
+
+	void remove_image (std::shared_ptr<WaveViewImage> const&);
 
 	/**
 	 * At time of writing we don't strictly need a reference to the parent cache
@@ -263,6 +300,8 @@ public:
 
 	void clear_cache ();
 
+	WaveView::ImageCacheStats stats () const;
+
 	std::shared_ptr<WaveViewCacheGroup> get_cache_group (std::shared_ptr<ARDOUR::AudioSource>);
 
 	void reset_cache_group (std::shared_ptr<WaveViewCacheGroup>&);
@@ -277,14 +316,25 @@ private:
 
 	CacheGroups cache_group_map;
 
+	/* images of all groups, least recently used first */
+	typedef std::list<std::shared_ptr<WaveViewImage> > LRUList;
+	LRUList _lru;
+
 	uint64_t image_cache_size;
 	uint64_t _image_cache_threshold;
 
+	uint64_t _hits;
+	uint64_t _scaled_hits;
+	uint64_t _misses;
+	uint64_t _evictions;
+
 private:
 	friend class WaveViewCacheGroup;
 
-	void increase_size (uint64_t bytes);
-	void decrease_size (uint64_t bytes);
+	void insert (WaveViewCacheGroup*, std::shared_ptr<WaveViewImage> const&);
+	void remove (std::shared_ptr<WaveViewImage> const&);
+	void use (std::shared_ptr<WaveViewImage> const&);
+	void evict (std::shared_ptr<WaveViewImage> const& keep);
 
 	bool full () { return image_cache_size > _image_cache_threshold; }
 };
@@ -316,6 +366,17 @@ public:
 
 	static void enqueue_draw_request (std::shared_ptr<WaveViewDrawRequest>&);
 
+	/** Update generation and priority of the request that is queued to
+	 * draw the given image.
+	 * @return false if there is no such request
+	 */
+	static bool renew_draw_request (std::shared_ptr<WaveViewImage> const&, double priority);
+
+	static uint64_t generation ();
+	static void next_generation ();
+
+	static WaveView::DrawStats draw_stats (bool reset);
+
 private:
 	friend class WaveViewDrawingThread;
 
@@ -340,11 +401,19 @@ private:
 	bool _quit;
 	WaveViewThreadList _threads;
 
+	std::atomic<uint64_t> _generation;
+
 	mutable PBD::Mutex _queue_mutex;
 	PBD::Cond          _cond;
 
 	typedef std::deque<std::shared_ptr<WaveViewDrawRequest> > DrawRequestQueueType;
 	DrawRequestQueueType _queue;
+
+	/* statistics, protected by _queue_mutex */
+	size_t   _max_queue_depth;
+	uint64_t _n_drawn;
+	uint64_t _n_dropped;
+	int64_t  _draw_time;
 };
 
 
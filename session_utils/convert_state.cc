@@ -0,0 +1,113 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <getopt.h>
+
+#include "pbd/xml++.h"
+
+using namespace std;
+
+static void usage ()
+{
+	// help2man compatible format (standard GNU help-text)
+	printf (UTILNAME " - convert a session file between XML and binary format.\n\n");
+	printf ("Usage: " UTILNAME " [ OPTIONS ] <input-file> <output-file>\n\n");
+	printf ("Options:\n\
+  -b, --binary               write the binary format\n\
+  -h, --help                 display this help and exit\n\
+  -V, --version              print version information and exit\n\
+  -x, --xml                  write XML (default)\n\
+\n");
+
+	printf ("\n\
+The format of the input file is detected automatically.\n\
+Binary session files are written when the \"save-binary-state\"\n\
+preference is enabled, this tool allows to convert them to XML\n\
+for older versions or other tools, and vice versa.\n\
+\n");
+
+	printf ("\n\
+Examples:\n\
+" UTILNAME " -x MySession.ardour /tmp/MySession.ardour\n\
+\n");
+
+	printf ("Report bugs to <https://tracker.ardour.org/>\n"
+	        "Website: <https://ardour.org/>\n");
+	::exit (EXIT_SUCCESS);
+}
+
+int main (int argc, char* argv[])
+{
+	bool binary = false;
+
+	const char *optstring = "bhVx";
+
+	const struct option longopts[] = {
+		{ "binary",     0, 0, 'b' },
+		{ "help",       0, 0, 'h' },
+		{ "version",    0, 0, 'V' },
+		{ "xml",        0, 0, 'x' },
+	};
+
+	int c = 0;
+	while (EOF != (c = getopt_long (argc, argv,
+					optstring, longopts, (int *) 0))) {
+		switch (c) {
+			case 'b':
+				binary = true;
+				break;
+
+			case 'x':
+				binary = false;
+				break;
+
+			case 'V':
+				printf ("ardour-utils version %s\n\n", VERSIONSTRING);
+				exit (EXIT_SUCCESS);
+				break;
+
+			case 'h':
+				usage ();
+				break;
+
+			default:
+				cerr << "Error: unrecognized option. See --help for usage information.\n";
+				::exit (EXIT_FAILURE);
+				break;
+		}
+	}
+
+	if (optind + 2 != argc) {
+		cerr << "Error: Missing parameter. See --help for usage information.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	XMLTree tree;
+	if (!tree.read (argv[optind])) {
+		cerr << "Error: Cannot read '" << argv[optind] << "'.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	tree.set_binary (binary);
+	if (!tree.write (argv[optind + 1])) {
+		cerr << "Error: Cannot write '" << argv[optind + 1] << "'.\n";
+		::exit (EXIT_FAILURE);
+	}
+
+	return 0;
+}
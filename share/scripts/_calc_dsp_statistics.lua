@@ -8,7 +8,7 @@ function factory () return function ()
 	for t in Session:get_routes ():iter () do
 		local i = 0
 		while true do
-			local rv, stats
+			local rv, stats, lp
 			local proc = t:nth_processor (i)
 			if proc:isnil () then break end
 			if proc:to_plugininsert():isnil() then goto continue end
@@ -20,6 +20,19 @@ function factory () return function ()
 				string.sub (proc:name() .. '  (' .. t:name() .. ')', 0, 28),
 				stats[1] / 1000.0, stats[2] / 1000.0, stats[3] / 1000.0, stats[4] / 1000.0))
 
+			-- Lua DSP scripts additionally report garbage-collection and memory stats
+			lp = proc:to_plugininsert():plugin (0):to_luaproc ()
+			if not lp:isnil () then
+				local _, mem = lp:get_mem_stats (0, 0, 0, 0)
+				print (string.format ("   %-28s | mem: %d kB peak: %d kB allocs: %d in run: %d",
+					"", mem[1] // 1024, mem[2] // 1024, mem[3], mem[4]))
+				rv, stats = lp:get_gc_stats (0, 0, 0, 0)
+				if rv then
+					print (string.format ("   %-28s | gc min: %.2f max: %.2f avg: %.3f std-dev: %.3f [ms]",
+						"", stats[1] / 1000.0, stats[2] / 1000.0, stats[3] / 1000.0, stats[4] / 1000.0))
+				end
+			end
+
 			::continue::
 			i = i + 1
 		end